@@ -1,5 +1,6 @@
 #include "effects_ffi.h"
 #include "../../juce_audio_engine/Source/Effects/ReverbEffect.h"
+#include "../../juce_audio_engine/Source/Effects/Denormals.h"
 #include <memory>
 
 struct EffectsHandle {
@@ -53,11 +54,17 @@ extern "C" {
         }
     }
 
+    void effects_set_reverb_algorithm(EffectsHandle* handle, int algorithm) {
+        if (handle && handle->reverb) {
+            handle->reverb->setParameter(4, static_cast<float>(algorithm)); // param ID 4 = algorithm
+        }
+    }
+
     void effects_process_audio(EffectsHandle* handle, float* buffer, int numSamples) {
         if (handle && handle->reverb && handle->reverb->isActive()) {
-            for (int i = 0; i < numSamples; ++i) {
-                buffer[i] = handle->reverb->processSample(buffer[i]);
-            }
+            ScopedFlushToZero noDenormals;
+            float* channels[] = { buffer };
+            handle->reverb->processBlock(channels, 1, numSamples);
         }
     }
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ extern "C" {
     EFFECTSFFI_API void effects_set_reverb_damping(EffectsHandle* handle, float value);
     EFFECTSFFI_API void effects_set_reverb_wet_level(EffectsHandle* handle, float value);
     EFFECTSFFI_API void effects_set_reverb_dry_level(EffectsHandle* handle, float value);
+    EFFECTSFFI_API void effects_set_reverb_algorithm(EffectsHandle* handle, int algorithm);  // 0=Comb, 1=FDN
     
     // Process audio
     EFFECTSFFI_API void effects_process_audio(EffectsHandle* handle, 
@@ -1,8 +1,14 @@
 #include "ffi_bridge.h"
 #include "../../juce_audio_engine/Source/SynthEngine.h"
 #include "../../juce_audio_engine/Source/Oscillator.h"  
+#include "../../juce_audio_engine/Source/Logger.h"
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
+static_assert(SYNTH_PERF_NUM_STAGES == NUM_PERFORMANCE_STAGES, "FFI stage count out of date");
+static_assert(SYNTH_PERF_LOAD_BUCKETS == PerformanceSnapshot::NUM_LOAD_BUCKETS, "FFI histogram size out of date");
+
 struct SynthEngineHandle {
     std::unique_ptr<SynthEngine> engine;
 };
@@ -44,10 +50,48 @@ void synth_note_off(SynthEngineHandle* handle, int note) {
     }
 }
 
+void synth_note_on_at(SynthEngineHandle* handle, int note, float velocity, int64_t samplePosition) {
+    if (handle && handle->engine) {
+        handle->engine->noteOnAt(note, velocity, samplePosition);
+    }
+}
+
+void synth_note_off_at(SynthEngineHandle* handle, int note, int64_t samplePosition) {
+    if (handle && handle->engine) {
+        handle->engine->noteOffAt(note, samplePosition);
+    }
+}
+
+int64_t synth_get_sample_position(SynthEngineHandle* handle) {
+    if (handle && handle->engine) {
+        return handle->engine->getSamplePosition();
+    }
+    return 0;
+}
+
+int synth_prepare_offline(SynthEngineHandle* handle, double sampleRate, int maxBlockSize) {
+    if (handle && handle->engine) {
+        return handle->engine->prepareOfflineRender(sampleRate, maxBlockSize) ? 1 : 0;
+    }
+    return 0;
+}
+
 void synth_process_audio(SynthEngineHandle* handle, float* buffer, int frames) {
+    synth_process_audio_interleaved(handle, buffer, 2, frames);
+}
+
+int synth_process_audio_interleaved(SynthEngineHandle* handle, float* buffer, int numChannels, int frames) {
     if (handle && handle->engine) {
-        // TODO: Implement audio processing
+        return handle->engine->renderOfflineInterleaved(buffer, numChannels, frames) ? 1 : 0;
     }
+    return 0;
+}
+
+int synth_process_audio_planar(SynthEngineHandle* handle, float** channels, int numChannels, int frames) {
+    if (handle && handle->engine) {
+        return handle->engine->renderOffline(channels, numChannels, frames) ? 1 : 0;
+    }
+    return 0;
 }
 
 // New dual oscillator control functions
@@ -75,6 +119,42 @@ void synth_set_osc_mix(SynthEngineHandle* handle, float mix) {
     }
 }
 
+void synth_set_oscillator_mode(SynthEngineHandle* handle, int mode) {
+    if (handle && handle->engine) {
+        handle->engine->setOscillatorMode(static_cast<OscillatorMode>(mode));
+    }
+}
+
+void synth_set_stereo_spread(SynthEngineHandle* handle, float spread) {
+    if (handle && handle->engine) {
+        handle->engine->setStereoSpread(spread);
+    }
+}
+
+void synth_set_max_polyphony(SynthEngineHandle* handle, int voices) {
+    if (handle && handle->engine) {
+        handle->engine->setMaxPolyphony(voices);
+    }
+}
+
+void synth_set_voice_stealing_mode(SynthEngineHandle* handle, int mode) {
+    if (handle && handle->engine) {
+        handle->engine->setVoiceStealingMode(static_cast<VoiceStealingMode>(mode));
+    }
+}
+
+void synth_set_voice_render_mode(SynthEngineHandle* handle, int mode) {
+    if (handle && handle->engine) {
+        handle->engine->setVoiceRenderMode(static_cast<VoiceRenderMode>(mode));
+    }
+}
+
+void synth_set_render_threads(SynthEngineHandle* handle, int numThreads) {
+    if (handle && handle->engine) {
+        handle->engine->setRenderThreads(numThreads);
+    }
+}
+
 void synth_set_filter_cutoff(SynthEngineHandle* handle, float value) {
     if (handle && handle->engine) {
         handle->engine->setCutoff(value);
@@ -87,6 +167,30 @@ void synth_set_filter_resonance(SynthEngineHandle* handle, float value) {
     }
 }
 
+void synth_set_filter_mode(SynthEngineHandle* handle, int mode) {
+    if (handle && handle->engine) {
+        handle->engine->setFilterMode(static_cast<FilterMode>(mode));
+    }
+}
+
+void synth_set_filter_routing(SynthEngineHandle* handle, int routing) {
+    if (handle && handle->engine) {
+        handle->engine->setFilterRouting(static_cast<FilterRouting>(routing));
+    }
+}
+
+void synth_set_filter_key_tracking(SynthEngineHandle* handle, float amount) {
+    if (handle && handle->engine) {
+        handle->engine->setFilterKeyTracking(amount);
+    }
+}
+
+void synth_set_filter_velocity_amount(SynthEngineHandle* handle, float amount) {
+    if (handle && handle->engine) {
+        handle->engine->setFilterVelocityAmount(amount);
+    }
+}
+
 void synth_enable_effects_processing(SynthEngineHandle* handle, bool enable) {
         if (!handle || !handle->engine) return;
         handle->engine->enableReverb(enable);
@@ -112,6 +216,11 @@ void synth_set_reverb_dry_level(SynthEngineHandle* handle, float value) {
     handle->engine->setReverbParameter(3, value);
 }
 
+void synth_set_reverb_algorithm(SynthEngineHandle* handle, int algorithm) {
+    if (!handle || !handle->engine) return;
+    handle->engine->setReverbParameter(4, static_cast<float>(algorithm));
+}
+
 void synth_enable_delay(SynthEngineHandle* handle, int enable) {
     if (!handle || !handle->engine) return;
     handle->engine->enableDelay(enable != 0);
@@ -172,19 +281,90 @@ void synth_set_chorus_dry_level(SynthEngineHandle* handle, float dryLevel) {
     handle->engine->setChorusDryLevel(dryLevel);
 }
 
+int synth_load_impulse_response(SynthEngineHandle* handle, const char* filePath) {
+    if (!handle || !handle->engine || !filePath) return 0;
+    return handle->engine->loadImpulseResponse(juce::String(filePath)) ? 1 : 0;
+}
+
+void synth_enable_convolution(SynthEngineHandle* handle, int enable) {
+    if (!handle || !handle->engine) return;
+    handle->engine->enableConvolution(enable != 0);
+}
+
+void synth_set_convolution_wet_level(SynthEngineHandle* handle, float wetLevel) {
+    if (!handle || !handle->engine) return;
+    handle->engine->setConvolutionWetLevel(wetLevel);
+}
+
+void synth_set_convolution_dry_level(SynthEngineHandle* handle, float dryLevel) {
+    if (!handle || !handle->engine) return;
+    handle->engine->setConvolutionDryLevel(dryLevel);
+}
+
+void synth_set_oversampling(SynthEngineHandle* handle, int factor) {
+    if (!handle || !handle->engine) return;
+    OversamplingFactor oversampling = OversamplingFactor::NONE;
+    if (factor == 2) oversampling = OversamplingFactor::X2;
+    else if (factor == 4) oversampling = OversamplingFactor::X4;
+    else if (factor == 8) oversampling = OversamplingFactor::X8;
+    handle->engine->setOversampling(oversampling);
+}
+
+void synth_set_effect_order(SynthEngineHandle* handle, int first, int second, int third) {
+    if (handle && handle->engine) {
+        handle->engine->setEffectOrder(static_cast<EffectType>(first), static_cast<EffectType>(second),
+                                       static_cast<EffectType>(third));
+    }
+}
+
+void synth_set_log_level(int level) {
+    Logger::getInstance().setLevel(static_cast<LogLevel>(std::clamp(level, 0, 4)));
+}
+
+int synth_get_perf_stats(SynthEngineHandle* handle, SynthPerfStats* stats) {
+    if (!handle || !handle->engine || !stats) return 0;
+
+    PerformanceSnapshot snapshot = handle->engine->getPerformanceStats();
+    stats->blockCount = snapshot.blockCount;
+    stats->overrunCount = snapshot.overrunCount;
+    stats->xrunCount = snapshot.xrunCount;
+    stats->maxActiveVoices = snapshot.maxActiveVoices;
+    stats->meanActiveVoices = snapshot.meanActiveVoices;
+    stats->meanLoad = snapshot.meanLoad;
+    stats->maxLoad = snapshot.maxLoad;
+    stats->meanRenderMicros = snapshot.meanRenderMicros;
+    stats->maxRenderMicros = snapshot.maxRenderMicros;
+    std::copy(std::begin(snapshot.meanStageMicros), std::end(snapshot.meanStageMicros), stats->meanStageMicros);
+    std::copy(std::begin(snapshot.maxStageMicros), std::end(snapshot.maxStageMicros), stats->maxStageMicros);
+    std::copy(std::begin(snapshot.loadHistogram), std::end(snapshot.loadHistogram), stats->loadHistogram);
+    return 1;
+}
+
+void synth_reset_perf_stats(SynthEngineHandle* handle) {
+    if (handle && handle->engine) {
+        handle->engine->resetPerformanceStats();
+    }
+}
+
+void synth_set_perf_effect_timing(SynthEngineHandle* handle, int enable) {
+    if (handle && handle->engine) {
+        handle->engine->setPerEffectTiming(enable != 0);
+    }
+}
+
 void synth_enable_oscilloscope(SynthEngineHandle* handle, int enable) {
     if (!handle || !handle->engine) {
-        printf("FFI: Invalid handle for enable_oscilloscope\n");
+        Logger::warning("ffi", "Invalid handle for enable_oscilloscope");
         return;
     }
 
     handle->engine->enableOscilloscope(enable != 0);
-    printf("FFI: Oscilloscope %s\n", enable ? "ENABLED" : "DISABLED");
+    Logger::verbose("ffi", "Oscilloscope %s", enable ? "ENABLED" : "DISABLED");
 }
 
 int synth_get_waveform_data(SynthEngineHandle* handle, float* buffer, int bufferSize) {
     if (!handle || !handle->engine || !buffer) {
-        printf("FFI: Invalid parameters for get_waveform_data\n");
+        Logger::warning("ffi", "Invalid parameters for get_waveform_data");
         return 0;
     }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +19,30 @@ extern "C" {
 // C interface for Flutter FFI
 typedef struct SynthEngineHandle SynthEngineHandle;
 
+#define SYNTH_PERF_NUM_STAGES 8
+#define SYNTH_PERF_LOAD_BUCKETS 21
+
+// Audio callback performance since the last reset. Load is a block's render
+// time divided by its duration; above 1.0 the block rendered too slowly.
+typedef struct SynthPerfStats {
+    uint64_t blockCount;
+    uint64_t overrunCount;          // Blocks with load above 1.0, or that dropped late work
+    int32_t xrunCount;              // Reported by the audio device; -1 if unknown
+    int32_t maxActiveVoices;
+    double meanActiveVoices;
+    double meanLoad;
+    double maxLoad;
+    double meanRenderMicros;
+    double maxRenderMicros;
+    // Stages: 0=voices, 1=master filter, 2=chorus, 3=delay, 4=reverb, 5=convolution, 6=limiter,
+    // 7=insert effects together. 2-4 are only timed with per-effect timing on,
+    // and 7 only with it off.
+    double meanStageMicros[SYNTH_PERF_NUM_STAGES];
+    double maxStageMicros[SYNTH_PERF_NUM_STAGES];
+    // Blocks per 5% of load; the last bucket counts every block at or above 100%
+    uint64_t loadHistogram[SYNTH_PERF_LOAD_BUCKETS];
+} SynthPerfStats;
+
 // Create/destroy synth engine
 SYNTHFFI_API SynthEngineHandle* synth_create();
 SYNTHFFI_API int synth_initialize_audio(SynthEngineHandle* handle);
@@ -26,17 +52,42 @@ SYNTHFFI_API void synth_destroy(SynthEngineHandle* handle);
 SYNTHFFI_API void synth_set_cutoff(SynthEngineHandle* handle, float value);
 SYNTHFFI_API void synth_note_on(SynthEngineHandle* handle, int note, float velocity);
 SYNTHFFI_API void synth_note_off(SynthEngineHandle* handle, int note);
+
+// Sample-accurate notes, scheduled on the engine's sample clock
+SYNTHFFI_API void synth_note_on_at(SynthEngineHandle* handle, int note, float velocity, int64_t samplePosition);
+SYNTHFFI_API void synth_note_off_at(SynthEngineHandle* handle, int note, int64_t samplePosition);
+SYNTHFFI_API int64_t synth_get_sample_position(SynthEngineHandle* handle);
+
+// Offline rendering (no audio device). Call synth_prepare_offline first to set
+// the sample rate and block size; otherwise 44.1 kHz / 512 is used.
+// Returns 1 on success, 0 if an audio device is running or arguments are invalid.
+SYNTHFFI_API int synth_prepare_offline(SynthEngineHandle* handle, double sampleRate, int maxBlockSize);
+// Renders frames of interleaved stereo into buffer (frames * 2 floats)
 SYNTHFFI_API void synth_process_audio(SynthEngineHandle* handle, float* buffer, int frames);
+SYNTHFFI_API int synth_process_audio_interleaved(SynthEngineHandle* handle, float* buffer, int numChannels, int frames);
+SYNTHFFI_API int synth_process_audio_planar(SynthEngineHandle* handle, float** channels, int numChannels, int frames);
 
 // New dual oscillator controls
 SYNTHFFI_API void synth_set_osc1_waveform(SynthEngineHandle* handle, int waveform);
 SYNTHFFI_API void synth_set_osc2_waveform(SynthEngineHandle* handle, int waveform);
 SYNTHFFI_API void synth_set_detune(SynthEngineHandle* handle, float cents);
 SYNTHFFI_API void synth_set_osc_mix(SynthEngineHandle* handle, float mix);
+SYNTHFFI_API void synth_set_oscillator_mode(SynthEngineHandle* handle, int mode);
+SYNTHFFI_API void synth_set_stereo_spread(SynthEngineHandle* handle, float spread);  // 0 - 1
+
+// Polyphony controls
+SYNTHFFI_API void synth_set_max_polyphony(SynthEngineHandle* handle, int voices);
+SYNTHFFI_API void synth_set_voice_stealing_mode(SynthEngineHandle* handle, int mode);
+SYNTHFFI_API void synth_set_voice_render_mode(SynthEngineHandle* handle, int mode);
+SYNTHFFI_API void synth_set_render_threads(SynthEngineHandle* handle, int numThreads);
 
 // Filter controls
 SYNTHFFI_API void synth_set_filter_cutoff(SynthEngineHandle* handle, float value);
 SYNTHFFI_API void synth_set_filter_resonance(SynthEngineHandle* handle, float value);
+SYNTHFFI_API void synth_set_filter_mode(SynthEngineHandle* handle, int mode);  // 0=LP, 1=HP, 2=BP, 3=Notch
+SYNTHFFI_API void synth_set_filter_routing(SynthEngineHandle* handle, int routing);  // 0=Master, 1=Per voice
+SYNTHFFI_API void synth_set_filter_key_tracking(SynthEngineHandle* handle, float amount);
+SYNTHFFI_API void synth_set_filter_velocity_amount(SynthEngineHandle* handle, float amount);
 
 // Effects processing control
 SYNTHFFI_API void synth_enable_effects_processing(SynthEngineHandle* handle, bool enable);
@@ -46,6 +97,7 @@ SYNTHFFI_API void synth_set_reverb_room_size(SynthEngineHandle* handle, float va
 SYNTHFFI_API void synth_set_reverb_damping(SynthEngineHandle* handle, float value);
 SYNTHFFI_API void synth_set_reverb_wet_level(SynthEngineHandle* handle, float value);
 SYNTHFFI_API void synth_set_reverb_dry_level(SynthEngineHandle* handle, float value);
+SYNTHFFI_API void synth_set_reverb_algorithm(SynthEngineHandle* handle, int algorithm);  // 0=Comb, 1=FDN
 
 // Delay effect control
 SYNTHFFI_API void synth_enable_delay(SynthEngineHandle* handle, int enable);
@@ -63,6 +115,33 @@ SYNTHFFI_API void synth_set_chorus_feedback(SynthEngineHandle* handle, float fee
 SYNTHFFI_API void synth_set_chorus_wet_level(SynthEngineHandle* handle, float wetLevel);
 SYNTHFFI_API void synth_set_chorus_dry_level(SynthEngineHandle* handle, float dryLevel);
 
+// Convolution reverb controls; runs after the effect chain. Loading returns 1
+// on success, 0 if the file cannot be read. Engines share impulse responses
+// loaded from the same file.
+SYNTHFFI_API int synth_load_impulse_response(SynthEngineHandle* handle, const char* filePath);
+SYNTHFFI_API void synth_enable_convolution(SynthEngineHandle* handle, int enable);
+SYNTHFFI_API void synth_set_convolution_wet_level(SynthEngineHandle* handle, float wetLevel);
+SYNTHFFI_API void synth_set_convolution_dry_level(SynthEngineHandle* handle, float dryLevel);
+
+// Oversampling for the voices and output limiter: 1, 2, 4 or 8 (other values
+// are treated as 1). Takes effect the next time the audio device starts.
+SYNTHFFI_API void synth_set_oversampling(SynthEngineHandle* handle, int factor);
+
+// Effect order: each of 0=Chorus, 1=Delay, 2=Reverb exactly once
+SYNTHFFI_API void synth_set_effect_order(SynthEngineHandle* handle, int first, int second, int third);
+
+// Console log level, shared by every engine in the process:
+// 0=verbose (includes every note), 1=info (default), 2=warning, 3=severe, 4=off
+SYNTHFFI_API void synth_set_log_level(int level);
+
+// Fills stats with a consistent snapshot; returns 1 on success, 0 for invalid
+// arguments. Reset takes effect at the start of the next audio block.
+SYNTHFFI_API int synth_get_perf_stats(SynthEngineHandle* handle, SynthPerfStats* stats);
+SYNTHFFI_API void synth_reset_perf_stats(SynthEngineHandle* handle);
+// Times chorus, delay and reverb separately (1) or as one stage (0, default).
+// Separate timing costs two clock reads per effect per 64-sample sub-block.
+SYNTHFFI_API void synth_set_perf_effect_timing(SynthEngineHandle* handle, int enable);
+
 //Oscilloscope functions
 SYNTHFFI_API void synth_enable_oscilloscope(SynthEngineHandle* handle, int enable);
 SYNTHFFI_API int synth_get_waveform_data(SynthEngineHandle* handle, float* buffer, int bufferSize);
@@ -21,6 +21,15 @@ int main() {
     synth_note_on(synth, 60, 0.8f);  // Middle C
     printf("Note on: C4 (60)\n");
     
+    // Test offline rendering without an audio device
+    float rendered[256 * 2];
+    if (!synth_prepare_offline(synth, 48000.0, 128)) {
+        printf("Failed to prepare offline rendering\n");
+        return 1;
+    }
+    synth_process_audio(synth, rendered, 256);
+    printf("Offline render: first sample %f\n", rendered[0]);
+    
     synth_note_off(synth, 60);
     printf("Note off: C4 (60)\n");
     
@@ -1,4 +1,5 @@
 #include "ChorusEffect.h"
+#include "Denormals.h"
 #include <algorithm>
 
 #ifndef M_PI
@@ -6,100 +7,131 @@
 #endif
 
 ChorusEffect::ChorusEffect()
-    : sampleRate(44100.0)
+    : numVoices(MIN_VOICES)
+    , sampleRate(44100.0)
     , rate(1.5f)            // 1.5 Hz default
     , depth(0.4f)           // 40% depth
     , feedback(0.2f)        // 20% feedback
     , wetLevel(0.5f)        // 50% wet
     , dryLevel(0.8f)        // 80% dry
     , enabled(false)        // Start disabled (same as DelayEffect)
-    , masterLfoPhase(0.0f)
+    , lfoCos(1.0f)
+    , lfoSin(0.0f)
+    , rotationCos(1.0f)
+    , rotationSin(0.0f)
+    , baseDelayTimes{}
 {
-    // Initialize with 2 voices by default
-    setVoices(2);
+    // Allocate the shared lines now; setVoices() only changes the tap count
+    setSampleRate(sampleRate);
 }
 
 float ChorusEffect::processSample(float sample) {
-    if (!enabled || voices.empty()) {
-        return sample; // Bypass if disabled (same as DelayEffect)
+    float* channels[] = { &sample };
+    processBlock(channels, 1, 1);
+    return sample;
+}
+
+void ChorusEffect::processBlock(float* const* channels, int numChannels, int numSamples) {
+    if (numChannels <= 0) return;
+    int numProcessed = std::min(numChannels, MAX_PROCESSED_CHANNELS);
+    if (!enabled || numVoices == 0) {
+        copyToOtherChannels(channels, numChannels, numSamples, numProcessed); // Bypass if disabled (same as DelayEffect)
+        return;
     }
     
-    // Update master LFO phase
-    masterLfoPhase += (2.0f * static_cast<float>(M_PI) * rate) / static_cast<float>(sampleRate);
-    if (masterLfoPhase >= 2.0f * static_cast<float>(M_PI)) {
-        masterLfoPhase -= 2.0f * static_cast<float>(M_PI);
-    }
+    const float voiceGainScale = 1.0f / static_cast<float>(numVoices);
     
-    float outputSample = sample * dryLevel; // Start with dry signal
+    float input[PARAMETER_CHUNK_SIZE];
+    float lfoQuadrants[4][PARAMETER_CHUNK_SIZE];
+    float depthRamp[PARAMETER_CHUNK_SIZE];
+    float feedbackRamp[PARAMETER_CHUNK_SIZE];
+    float wetRamp[PARAMETER_CHUNK_SIZE];
+    float dryRamp[PARAMETER_CHUNK_SIZE];
     
-    // Process each chorus voice
-    for (size_t voiceIndex = 0; voiceIndex < voices.size(); ++voiceIndex) {
-        auto& voice = voices[voiceIndex];
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += PARAMETER_CHUNK_SIZE) {
+        int chunkSize = std::min(PARAMETER_CHUNK_SIZE, numSamples - chunkStart);
         
-        if (voice.delayBuffer.empty()) continue;
+        depth.fillBlock(depthRamp, chunkSize);
+        feedback.fillBlock(feedbackRamp, chunkSize);
+        wetLevel.fillBlock(wetRamp, chunkSize);
+        dryLevel.fillBlock(dryRamp, chunkSize);
         
-        // Update voice LFO phase (phase-shifted per voice)
-        voice.lfoPhase = masterLfoPhase + (voiceIndex * static_cast<float>(M_PI) / 2.0f);
-        if (voice.lfoPhase >= 2.0f * static_cast<float>(M_PI)) {
-            voice.lfoPhase -= 2.0f * static_cast<float>(M_PI);
+        // Advance the LFO once per sample for the whole chunk; quadrant q holds
+        // sin(phase + q * pi / 2)
+        for (int i = 0; i < chunkSize; ++i) {
+            float nextCos = lfoCos * rotationCos - lfoSin * rotationSin;
+            float nextSin = lfoSin * rotationCos + lfoCos * rotationSin;
+            
+            // First-order renormalisation keeps the phasor on the unit circle
+            float correction = 1.5f - 0.5f * (nextCos * nextCos + nextSin * nextSin);
+            lfoCos = nextCos * correction;
+            lfoSin = nextSin * correction;
+            
+            lfoQuadrants[0][i] = lfoSin;
+            lfoQuadrants[1][i] = lfoCos;
+            lfoQuadrants[2][i] = -lfoSin;
+            lfoQuadrants[3][i] = -lfoCos;
         }
         
-        // Generate LFO modulation
-        float lfoValue = generateLFO(voice.lfoPhase);
-        
-        // Calculate modulated delay time
-        float modulationAmount = voice.baseDelayTime * depth * 0.5f;
-        float modulatedDelay = voice.baseDelayTime + (lfoValue * modulationAmount);
-        
-        // Clamp delay (same pattern as DelayEffect)
-        int delayInSamples = static_cast<int>(std::clamp(modulatedDelay, 1.0f, static_cast<float>(voice.bufferSize - 1)));
-        
-        // Calculate read position (same logic as DelayEffect)
-        int readPosition = voice.writePosition - delayInSamples;
-        if (readPosition < 0) {
-            readPosition += voice.bufferSize;
+        for (int channel = 0; channel < numProcessed; ++channel) {
+            float* io = channels[channel] + chunkStart;
+            DelayLine& line = lines[channel];
+            float maxDelay = static_cast<float>(line.getMaximumDelay());
+            
+            for (int i = 0; i < chunkSize; ++i) {
+                input[i] = io[i];
+            }
+            
+            float chorusPeak = 0.0f;
+            for (int i = 0; i < chunkSize; ++i) {
+                // Each tap's delay swings by up to half its centre delay
+                float tapSum = 0.0f;
+                for (int voiceIndex = 0; voiceIndex < numVoices; ++voiceIndex) {
+                    float lfoValue = lfoQuadrants[(voiceIndex + channel) & 3][i];
+                    float baseDelay = baseDelayTimes[voiceIndex];
+                    float modulatedDelay = baseDelay + (lfoValue * baseDelay * depthRamp[i] * 0.5f);
+                    tapSum += line.readLagrange(std::clamp(modulatedDelay, 2.0f, maxDelay));
+                }
+                float chorusSample = tapSum * voiceGainScale;
+                chorusPeak = std::max(chorusPeak, std::abs(chorusSample));
+                
+                // Write new sample with feedback (same as DelayEffect), then mix
+                line.push(flushDenormal(input[i] + (chorusSample * feedbackRamp[i])));
+                io[i] = (input[i] * dryRamp[i]) + (chorusSample * wetRamp[i]);
+            }
+            noteTailPeak(chorusPeak);
         }
-        
-        // Read delayed sample
-        float delayedSample = voice.delayBuffer[readPosition];
-        
-        // Write new sample with feedback (same as DelayEffect)
-        voice.delayBuffer[voice.writePosition] = sample + (delayedSample * feedback);
-        
-        // Advance write position (same as DelayEffect)
-        voice.writePosition = (voice.writePosition + 1) % voice.bufferSize;
-        
-        // Add chorus voice to output
-        outputSample += delayedSample * wetLevel * (1.0f / static_cast<float>(voices.size()));
     }
     
-    return outputSample;
+    copyToOtherChannels(channels, numChannels, numSamples, numProcessed);
 }
 
 void ChorusEffect::setSampleRate(double sr) {
     sampleRate = sr;
     
-    // Initialize all voice buffers (same pattern as DelayEffect)
-    for (auto& voice : voices) {
-        voice.bufferSize = static_cast<int>(sampleRate * (MAX_DELAY_MS / 1000.0f) * 2); // Extra headroom
-        voice.delayBuffer.resize(voice.bufferSize);
-        voice.writePosition = 0;
+    // Shared lines sized for the longest tap at full depth (same pattern as DelayEffect)
+    int maxDelay = static_cast<int>(sampleRate * (MAX_DELAY_MS / 1000.0f) * 2); // Extra headroom
+    for (auto& line : lines) {
+        line.setMaximumDelay(maxDelay);
     }
     
+    depth.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    feedback.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    wetLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    dryLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+
+    updateLfoRotation();
     updateVoiceDelayTimes();
     reset();
 }
 
 void ChorusEffect::reset() {
     // Same pattern as DelayEffect
-    for (auto& voice : voices) {
-        if (!voice.delayBuffer.empty()) {
-            std::fill(voice.delayBuffer.begin(), voice.delayBuffer.end(), 0.0f);
-        }
-        voice.writePosition = 0;
-        voice.lfoPhase = 0.0f;
+    for (auto& line : lines) {
+        line.clear();
     }
-    masterLfoPhase = 0.0f;
+    lfoCos = 1.0f;
+    lfoSin = 0.0f;
 }
 
 void ChorusEffect::setParameter(int paramId, float value) {
@@ -120,56 +152,64 @@ bool ChorusEffect::isActive() const {
     return enabled; // Same as DelayEffect
 }
 
+int ChorusEffect::getTailLengthSamples() const {
+    // Deepest modulation swings a tap to 1.5x the longest centre delay
+    return static_cast<int>(std::ceil(getDelayInSamples(MAX_DELAY_MS) * 1.5f));
+}
+
 void ChorusEffect::setRate(float rateHz) {
     rate = std::clamp(rateHz, 0.1f, 5.0f); // Same clamp pattern
+    updateLfoRotation();
 }
 
 void ChorusEffect::setDepth(float newDepth) {
-    depth = std::clamp(newDepth, 0.0f, 1.0f);
+    depth.setTargetValue(std::clamp(newDepth, 0.0f, 1.0f));
 }
 
-void ChorusEffect::setVoices(int numVoices) {
-    numVoices = std::clamp(numVoices, 2, 4);
-    voices.resize(numVoices);
-    
-    // Reinitialize if sample rate is set
-    if (sampleRate > 0) {
-        setSampleRate(sampleRate);
-    }
+void ChorusEffect::setVoices(int voiceCount) {
+    int newVoiceCount = std::clamp(voiceCount, MIN_VOICES, MAX_VOICES);
+    if (newVoiceCount == numVoices) return;
+
+    // Buffers are preallocated, so this is safe to call from the audio thread
+    numVoices = newVoiceCount;
+    updateVoiceDelayTimes();
+    reset();
 }
 
 void ChorusEffect::setFeedback(float fb) {
-    feedback = std::clamp(fb, 0.0f, 0.3f); // Lower max than delay for safety
+    feedback.setTargetValue(std::clamp(fb, 0.0f, 0.3f)); // Lower max than delay for safety
 }
 
 void ChorusEffect::setWetLevel(float wet) {
-    wetLevel = std::clamp(wet, 0.0f, 1.0f); // Same as DelayEffect
+    wetLevel.setTargetValue(std::clamp(wet, 0.0f, 1.0f)); // Same as DelayEffect
 }
 
 void ChorusEffect::setDryLevel(float dry) {
-    dryLevel = std::clamp(dry, 0.0f, 1.0f); // Same as DelayEffect
+    dryLevel.setTargetValue(std::clamp(dry, 0.0f, 1.0f)); // Same as DelayEffect
 }
 
 void ChorusEffect::setEnabled(bool enable) {
     enabled = enable; // Same as DelayEffect
 }
 
-float ChorusEffect::generateLFO(float phase) {
-    // Simple sine wave LFO (pure C++ math)
-    return std::sin(phase);
+void ChorusEffect::updateLfoRotation() {
+    // One sin/cos per rate change; the LFO itself only multiplies and adds
+    double increment = 2.0 * M_PI * rate / sampleRate;
+    rotationCos = static_cast<float>(std::cos(increment));
+    rotationSin = static_cast<float>(std::sin(increment));
 }
 
 void ChorusEffect::updateVoiceDelayTimes() {
-    if (voices.empty()) return;
+    if (numVoices < 2) return;
     
-    // Spread voices across delay range
-    for (size_t i = 0; i < voices.size(); ++i) {
-        float delayMs = MIN_DELAY_MS + (i * (MAX_DELAY_MS - MIN_DELAY_MS) / (voices.size() - 1));
-        voices[i].baseDelayTime = getDelayInSamples(delayMs);
+    // Spread active voices across delay range
+    for (int i = 0; i < numVoices; ++i) {
+        float delayMs = MIN_DELAY_MS + (i * (MAX_DELAY_MS - MIN_DELAY_MS) / (numVoices - 1));
+        baseDelayTimes[i] = getDelayInSamples(delayMs);
     }
 }
 
-int ChorusEffect::getDelayInSamples(float delayTimeMs) const {
-    // Same conversion pattern as DelayEffect
-    return static_cast<int>((delayTimeMs / 1000.0f) * sampleRate);
+float ChorusEffect::getDelayInSamples(float delayTimeMs) const {
+    // Same conversion pattern as DelayEffect, but fractional
+    return static_cast<float>((delayTimeMs / 1000.0f) * sampleRate);
 }
\ No newline at end of file
@@ -1,51 +1,58 @@
 #pragma once
 #include "Effect.h"
-#include <vector>
+#include "SmoothedParameter.h"
+#include "DelayLine.h"
 #include <cmath>
 
-class ChorusEffect : public Effect {
+// Stereo chorus: every voice is a modulated tap on one shared line per
+// channel, and the right channel's taps are modulated a quarter LFO cycle
+// after the left's for width. Taps are read with Lagrange interpolation so
+// the sweep glides between samples instead of stepping.
+class ChorusEffect final : public Effect {
 private:
-    struct ChorusVoice {
-        std::vector<float> delayBuffer;
-        int writePosition;
-        int bufferSize;
-        float baseDelayTime;
-        float lfoPhase;
-
-        ChorusVoice() : writePosition(0), bufferSize(0), baseDelayTime(0.0f), lfoPhase(0.0f) {}
-    };
-
-    std::vector<ChorusVoice> voices;
+    DelayLine lines[MAX_PROCESSED_CHANNELS];
+    int numVoices;
 
     double sampleRate;
     float rate;
-    float depth;
-    float feedback;
-    float wetLevel;
-    float dryLevel;
+    SmoothedParameter depth;
+    SmoothedParameter feedback;
+    SmoothedParameter wetLevel;
+    SmoothedParameter dryLevel;
     bool enabled;
 
-    //variable to track lfo state
-    float masterLfoPhase;
+    // Recursive quadrature LFO: (lfoCos, lfoSin) is rotated by the per-sample
+    // angle each sample. Voices sit a quarter cycle apart, so every tap's
+    // modulation is one of +-sin or +-cos of this single oscillator.
+    float lfoCos, lfoSin;
+    float rotationCos, rotationSin;
 
     //Constant variables
     static constexpr float MIN_DELAY_MS = 5.0f;
     static constexpr float MAX_DELAY_MS = 20.0f;
+    static constexpr int MIN_VOICES = 2;
+    static constexpr int MAX_VOICES = 4;
+    static constexpr double SMOOTHING_TIME_SECONDS = 0.02;
+
+    // Centre delay of each tap in samples; numVoices selects how many run
+    float baseDelayTimes[MAX_VOICES];
 
     //helper methods
-    float generateLFO(float phase);
+    void updateLfoRotation();
     void updateVoiceDelayTimes();
-    int getDelayInSamples(float delayTimeMs) const;
+    float getDelayInSamples(float delayTimeMs) const;
 
 public:
     ChorusEffect();
 
     //Override methods from base Effect class
     float processSample(float sample) override;
+    void processBlock(float* const* channels, int numChannels, int numSamples) override;
     void setSampleRate(double sr) override;
     void reset() override;
     void setParameter(int paramId, float value) override;
     bool isActive() const override;
+    int getTailLengthSamples() const override;
 
     //Methods specific to ChorusEffect only
     void setRate(float rateHz);
@@ -0,0 +1,129 @@
+#include "ConvolutionKernel.h"
+#include "Fft.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int MAX_CHANNELS = 2;
+
+    // Linear interpolation is plenty for a reverb tail, and keeps loading fast
+    std::vector<float> resample(const std::vector<float>& input, double ratio) {
+        if (input.empty()) return {};
+        int length = std::max(1, static_cast<int>(std::ceil(input.size() * ratio)));
+        std::vector<float> output(length);
+        int last = static_cast<int>(input.size()) - 1;
+        for (int i = 0; i < length; ++i) {
+            double position = i / ratio;
+            int index = static_cast<int>(position);
+            if (index >= last) {
+                output[i] = input[last];
+                continue;
+            }
+            float fraction = static_cast<float>(position - index);
+            output[i] = input[index] + (input[index + 1] - input[index]) * fraction;
+        }
+        return output;
+    }
+}
+
+ImpulseResponse::ImpulseResponse(std::vector<std::vector<float>> channelData, double sr)
+    : channels(std::move(channelData))
+    , sampleRate(sr)
+{
+    if (channels.size() > MAX_CHANNELS) {
+        channels.resize(MAX_CHANNELS);
+    }
+}
+
+std::shared_ptr<const ConvolutionKernel> ImpulseResponse::getKernel(double targetSampleRate, bool nonUniform) const {
+    std::lock_guard<std::mutex> lock(kernelMutex);
+
+    for (const auto& cached : kernels) {
+        if (cached.sampleRate == targetSampleRate && cached.nonUniform == nonUniform) {
+            if (auto kernel = cached.kernel.lock()) {
+                return kernel;
+            }
+        }
+    }
+
+    kernels.erase(std::remove_if(kernels.begin(), kernels.end(),
+                                 [](const CachedKernel& cached) { return cached.kernel.expired(); }),
+                  kernels.end());
+
+    auto kernel = std::make_shared<const ConvolutionKernel>(*this, targetSampleRate, nonUniform);
+    kernels.push_back({ targetSampleRate, nonUniform, kernel });
+    return kernel;
+}
+
+std::vector<ConvolutionStageLayout> ConvolutionKernel::makeLayout(int length, bool nonUniform) {
+    std::vector<ConvolutionStageLayout> layout;
+    int partitionSize = HEAD_PARTITION_SIZE;
+    int offset = 0;
+
+    while (offset < length) {
+        bool lastStage = !nonUniform || partitionSize >= MAX_PARTITION_SIZE;
+        int nextPartitionSize = partitionSize * STAGE_GROWTH;
+        int end = lastStage ? length : std::min(length, 2 * nextPartitionSize);
+        int numPartitions = (end - offset + partitionSize - 1) / partitionSize;
+        layout.push_back({ partitionSize, offset, numPartitions });
+
+        offset += numPartitions * partitionSize;
+        partitionSize = nextPartitionSize;
+    }
+    return layout;
+}
+
+ConvolutionKernel::ConvolutionKernel(const ImpulseResponse& impulseResponse, double sampleRate, bool nonUniform)
+    : numChannels(std::max(1, impulseResponse.getNumChannels()))
+    , length(0)
+{
+    std::vector<std::vector<float>> channels(numChannels);
+    for (int channel = 0; channel < impulseResponse.getNumChannels(); ++channel) {
+        const auto& source = impulseResponse.getChannel(channel);
+        channels[channel] = (sampleRate == impulseResponse.getSampleRate())
+            ? source
+            : resample(source, sampleRate / impulseResponse.getSampleRate());
+        length = std::max(length, static_cast<int>(channels[channel].size()));
+    }
+
+    // Unit energy on the loudest channel keeps levels comparable between IRs
+    double maxEnergy = 0.0;
+    for (auto& channel : channels) {
+        channel.resize(length, 0.0f);
+        double energy = 0.0;
+        for (float sample : channel) {
+            energy += static_cast<double>(sample) * sample;
+        }
+        maxEnergy = std::max(maxEnergy, energy);
+    }
+    float gain = maxEnergy > 0.0 ? static_cast<float>(1.0 / std::sqrt(maxEnergy)) : 0.0f;
+
+    stages = makeLayout(length, nonUniform);
+    spectraReal.resize(stages.size() * numChannels);
+    spectraImag.resize(stages.size() * numChannels);
+
+    for (size_t stage = 0; stage < stages.size(); ++stage) {
+        const auto& layout = stages[stage];
+        int partitionSize = layout.partitionSize;
+        int numBins = partitionSize + 1;
+        RealFft fft(RealFft::getOrder(2 * partitionSize));
+        std::vector<float> padded(2 * partitionSize);
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto& real = spectraReal[stage * numChannels + channel];
+            auto& imag = spectraImag[stage * numChannels + channel];
+            real.resize(static_cast<size_t>(layout.numPartitions) * numBins);
+            imag.resize(static_cast<size_t>(layout.numPartitions) * numBins);
+
+            for (int partition = 0; partition < layout.numPartitions; ++partition) {
+                std::fill(padded.begin(), padded.end(), 0.0f);
+                int start = layout.offset + partition * partitionSize;
+                int count = std::min(partitionSize, length - start);
+                for (int i = 0; i < count; ++i) {
+                    padded[i] = channels[channel][start + i] * gain;
+                }
+                fft.forward(padded.data(), &real[partition * numBins], &imag[partition * numBins]);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ConvolutionKernel;
+
+// One stage of a partitioned convolution: numPartitions partitions of
+// partitionSize samples covering the impulse response from offset onwards
+struct ConvolutionStageLayout {
+    int partitionSize;
+    int offset;
+    int numPartitions;
+};
+
+// Decoded impulse response (one or two channels). Immutable once built and
+// shared through shared_ptr, so every effect (and engine) playing the same
+// IR uses one copy. Partitioned kernels are derived from it on demand and
+// cached here while anything still uses them.
+class ImpulseResponse {
+public:
+    ImpulseResponse(std::vector<std::vector<float>> channelData, double sampleRate);
+
+    int getNumChannels() const { return static_cast<int>(channels.size()); }
+    int getLength() const { return channels.empty() ? 0 : static_cast<int>(channels[0].size()); }
+    double getSampleRate() const { return sampleRate; }
+    const std::vector<float>& getChannel(int channel) const { return channels[channel]; }
+
+    // Kernel for playback at targetSampleRate. Builds (FFTs every partition)
+    // on first use, so call it from a non-real-time thread.
+    std::shared_ptr<const ConvolutionKernel> getKernel(double targetSampleRate, bool nonUniform) const;
+
+private:
+    std::vector<std::vector<float>> channels;
+    double sampleRate;
+
+    struct CachedKernel {
+        double sampleRate;
+        bool nonUniform;
+        std::weak_ptr<const ConvolutionKernel> kernel;
+    };
+    mutable std::mutex kernelMutex;
+    mutable std::vector<CachedKernel> kernels;
+};
+
+// Frequency-domain partitions of an impulse response, resampled to the
+// playback rate and normalised to unit energy on its loudest channel.
+//
+// Uniform layouts use HEAD_PARTITION_SIZE partitions throughout. Non-uniform
+// layouts grow the partition size by STAGE_GROWTH per stage, each stage
+// starting at twice its own partition size: that leaves a larger partition a
+// whole block period to be computed before its first output is due, which is
+// what lets the late stages run on a background thread.
+class ConvolutionKernel {
+public:
+    static constexpr int HEAD_PARTITION_SIZE = 64;
+    static constexpr int STAGE_GROWTH = 16;
+    static constexpr int MAX_PARTITION_SIZE = 16384;
+
+    ConvolutionKernel(const ImpulseResponse& impulseResponse, double sampleRate, bool nonUniform);
+
+    int getNumChannels() const { return numChannels; }
+    int getLength() const { return length; }
+    int getNumStages() const { return static_cast<int>(stages.size()); }
+    const ConvolutionStageLayout& getStage(int stage) const { return stages[stage]; }
+
+    // Spectrum of one partition: partitionSize + 1 bins of a 2 * partitionSize FFT
+    const float* getReal(int stage, int channel, int partition) const {
+        return &spectraReal[stage * numChannels + channel][partition * (stages[stage].partitionSize + 1)];
+    }
+    const float* getImag(int stage, int channel, int partition) const {
+        return &spectraImag[stage * numChannels + channel][partition * (stages[stage].partitionSize + 1)];
+    }
+
+    static std::vector<ConvolutionStageLayout> makeLayout(int length, bool nonUniform);
+
+private:
+    int numChannels;
+    int length;
+    std::vector<ConvolutionStageLayout> stages;
+
+    // [stage * numChannels + channel], each numPartitions * (partitionSize + 1) bins
+    std::vector<std::vector<float>> spectraReal;
+    std::vector<std::vector<float>> spectraImag;
+};
@@ -0,0 +1,452 @@
+#include "ConvolutionReverb.h"
+#include "Denormals.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    constexpr int MULTIPLY_CHUNK = 16;
+
+    // Adds input * kernel for MULTIPLY_CHUNK bins of split-complex spectra. The
+    // delay-line slot, the kernel partition and the accumulator are separate
+    // allocations, so the real and imaginary parts stream as independent vectors.
+    void multiplyAccumulateChunk(const float* __restrict inputReal, const float* __restrict inputImag,
+                                 const float* __restrict kernelReal, const float* __restrict kernelImag,
+                                 float* __restrict accumulatorReal, float* __restrict accumulatorImag) {
+        for (int k = 0; k < MULTIPLY_CHUNK; ++k) {
+            accumulatorReal[k] += inputReal[k] * kernelReal[k] - inputImag[k] * kernelImag[k];
+            accumulatorImag[k] += inputReal[k] * kernelImag[k] + inputImag[k] * kernelReal[k];
+        }
+    }
+
+    // Partition sizes are multiples of MULTIPLY_CHUNK; only the Nyquist bin is left over
+    void multiplyAccumulate(const float* inputReal, const float* inputImag,
+                            const float* kernelReal, const float* kernelImag,
+                            float* accumulatorReal, float* accumulatorImag, int numBins) {
+        int k = 0;
+        for (; k + MULTIPLY_CHUNK <= numBins; k += MULTIPLY_CHUNK) {
+            multiplyAccumulateChunk(inputReal + k, inputImag + k, kernelReal + k, kernelImag + k,
+                                    accumulatorReal + k, accumulatorImag + k);
+        }
+        for (; k < numBins; ++k) {
+            accumulatorReal[k] += inputReal[k] * kernelReal[k] - inputImag[k] * kernelImag[k];
+            accumulatorImag[k] += inputReal[k] * kernelImag[k] + inputImag[k] * kernelReal[k];
+        }
+    }
+}
+
+// Stage implementations
+ConvolutionReverb::Stage::Stage(const ConvolutionKernel& stageKernel, int index, double sampleRate)
+    : layout(stageKernel.getStage(index))
+    , stageIndex(index)
+    , deferred(layout.offset > 0)
+    , jobBudget(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(layout.partitionSize / sampleRate)))
+    , kernel(stageKernel)
+    , fft(RealFft::getOrder(2 * layout.partitionSize))
+{
+    int partitionSize = layout.partitionSize;
+    int numBins = partitionSize + 1;
+    for (int channel = 0; channel < MAX_PROCESSED_CHANNELS; ++channel) {
+        blockInput[channel].assign(partitionSize, 0.0f);
+        frame[channel].assign(2 * partitionSize, 0.0f);
+        fdlReal[channel].assign(static_cast<size_t>(layout.numPartitions) * numBins, 0.0f);
+        fdlImag[channel].assign(static_cast<size_t>(layout.numPartitions) * numBins, 0.0f);
+        result[channel].assign(partitionSize, 0.0f);
+    }
+    accumulatorReal.assign(numBins, 0.0f);
+    accumulatorImag.assign(numBins, 0.0f);
+    timeDomain.assign(2 * partitionSize, 0.0f);
+}
+
+void ConvolutionReverb::Stage::run() {
+    int numBins = layout.partitionSize + 1;
+    int numPartitions = layout.numPartitions;
+    int kernelChannels = kernel.getNumChannels();
+
+    // Blocks dropped while an earlier job ran late count as silence, which
+    // keeps every later block in its proper partition
+    for (int missed = 0; missed < std::min(jobMissedBlocks, numPartitions); ++missed) {
+        for (int channel = 0; channel < MAX_PROCESSED_CHANNELS; ++channel) {
+            std::fill_n(&fdlReal[channel][fdlHead * numBins], numBins, 0.0f);
+            std::fill_n(&fdlImag[channel][fdlHead * numBins], numBins, 0.0f);
+        }
+        fdlHead = (fdlHead + 1 == numPartitions) ? 0 : fdlHead + 1;
+    }
+
+    for (int channel = 0; channel < MAX_PROCESSED_CHANNELS; ++channel) {
+        float* slotReal = &fdlReal[channel][fdlHead * numBins];
+        float* slotImag = &fdlImag[channel][fdlHead * numBins];
+
+        // A channel missing from this block counts as silence
+        if (channel >= jobChannels) {
+            std::fill(slotReal, slotReal + numBins, 0.0f);
+            std::fill(slotImag, slotImag + numBins, 0.0f);
+            continue;
+        }
+
+        fft.forward(frame[channel].data(), slotReal, slotImag);
+
+        // Partition p meets the input spectrum from p blocks ago
+        std::fill(accumulatorReal.begin(), accumulatorReal.end(), 0.0f);
+        std::fill(accumulatorImag.begin(), accumulatorImag.end(), 0.0f);
+        int kernelChannel = std::min(channel, kernelChannels - 1);
+        int slot = fdlHead;
+        for (int partition = 0; partition < numPartitions; ++partition) {
+            multiplyAccumulate(&fdlReal[channel][slot * numBins], &fdlImag[channel][slot * numBins],
+                               kernel.getReal(stageIndex, kernelChannel, partition),
+                               kernel.getImag(stageIndex, kernelChannel, partition),
+                               accumulatorReal.data(), accumulatorImag.data(), numBins);
+            slot = (slot == 0) ? numPartitions - 1 : slot - 1;
+        }
+
+        // Overlap-save: only the second half is free of circular wrap-around
+        fft.inverse(accumulatorReal.data(), accumulatorImag.data(), timeDomain.data());
+        std::copy(timeDomain.begin() + layout.partitionSize, timeDomain.end(), result[channel].begin());
+    }
+
+    fdlHead = (fdlHead + 1 == numPartitions) ? 0 : fdlHead + 1;
+}
+
+bool ConvolutionReverb::Stage::waitForJob() const {
+    // A host block longer than the partition completes blocks back to back,
+    // so the job may still be inside its budget; past it, stop waiting
+    while (jobPending.load(std::memory_order_acquire)) {
+        if (Clock::now() >= jobDeadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// State implementations
+ConvolutionReverb::State::State(std::shared_ptr<const ConvolutionKernel> stateKernel, double sampleRate,
+                                bool useBackground)
+    : kernel(std::move(stateKernel))
+    , background(useBackground)
+{
+    if (!kernel) return;
+
+    int largestPartition = 0;
+    for (int stage = 0; stage < kernel->getNumStages(); ++stage) {
+        stages.push_back(std::make_unique<Stage>(*kernel, stage, sampleRate));
+        largestPartition = std::max(largestPartition, kernel->getStage(stage).partitionSize);
+    }
+
+    // Results land at most LATENCY_SAMPLES + partitionSize ahead of the read position
+    int ringSize = 1;
+    while (ringSize < 2 * largestPartition) {
+        ringSize <<= 1;
+    }
+    for (auto& channel : ring) {
+        channel.assign(ringSize, 0.0f);
+    }
+    ringMask = ringSize - 1;
+}
+
+void ConvolutionReverb::State::waitForJobs() const {
+    for (const auto& stage : stages) {
+        while (stage->jobPending.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ConvolutionReverb implementations
+ConvolutionReverb::ConvolutionReverb()
+    : wetLevel(0.3f), dryLevel(0.7f), sampleRate(44100.0),
+      nonUniformPartitions(true),
+      backgroundProcessing(true),
+      states(RETIRED_STATE_QUEUE_SIZE),
+      jobQueue(JOB_QUEUE_SIZE),
+      stopping(false),
+      lateJobs(0) {
+    wetLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    dryLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+}
+
+ConvolutionReverb::~ConvolutionReverb() {
+    // The worker drains its queue before it exits, so no state is still in use
+    // when states deletes them
+    stopWorker();
+}
+
+float ConvolutionReverb::processSample(float sample) {
+    float* channels[] = { &sample };
+    processBlock(channels, 1, 1);
+    return sample;
+}
+
+void ConvolutionReverb::processBlock(float* const* channels, int numChannels, int numSamples) {
+    states.adopt();
+    if (numChannels <= 0) return;
+    int numProcessed = std::min(numChannels, MAX_PROCESSED_CHANNELS);
+
+    State* state = states.get();
+    bool convolving = state != nullptr && !state->stages.empty();
+    constexpr int HEAD_SIZE = ConvolutionKernel::HEAD_PARTITION_SIZE;
+
+    float wetRamp[PARAMETER_CHUNK_SIZE];
+    float dryRamp[PARAMETER_CHUNK_SIZE];
+
+    int done = 0;
+    while (done < numSamples) {
+        // Runs never cross a head partition boundary, where blocks complete
+        int runLength = std::min(numSamples - done, PARAMETER_CHUNK_SIZE);
+        if (convolving) {
+            runLength = std::min(runLength, HEAD_SIZE - static_cast<int>(state->position & (HEAD_SIZE - 1)));
+        }
+
+        wetLevel.fillBlock(wetRamp, runLength);
+        dryLevel.fillBlock(dryRamp, runLength);
+
+        if (!convolving) {
+            for (int channel = 0; channel < numProcessed; ++channel) {
+                float* samples = channels[channel] + done;
+                for (int i = 0; i < runLength; ++i) {
+                    samples[i] *= dryRamp[i];
+                }
+            }
+            done += runLength;
+            continue;
+        }
+
+        int readIndex = static_cast<int>(state->position & state->ringMask);
+        for (int channel = 0; channel < MAX_PROCESSED_CHANNELS; ++channel) {
+            float* ring = state->ring[channel].data() + readIndex;
+            noteTailPeak(getPeak(ring, runLength));
+            if (channel < numProcessed) {
+                float* samples = channels[channel] + done;
+                for (auto& stage : state->stages) {
+                    std::copy(samples, samples + runLength, stage->blockInput[channel].begin() + stage->fill);
+                }
+                for (int i = 0; i < runLength; ++i) {
+                    samples[i] = samples[i] * dryRamp[i] + ring[i] * wetRamp[i];
+                }
+            }
+            std::fill(ring, ring + runLength, 0.0f);
+        }
+
+        state->position += runLength;
+        for (auto& stage : state->stages) {
+            stage->fill += runLength;
+            stage->blockChannels = std::max(stage->blockChannels, numProcessed);
+            if (stage->fill == stage->layout.partitionSize) {
+                completeBlock(*state, *stage);
+            }
+        }
+        done += runLength;
+    }
+
+    copyToOtherChannels(channels, numChannels, numSamples, numProcessed);
+}
+
+void ConvolutionReverb::completeBlock(State& state, Stage& stage) {
+    int partitionSize = stage.layout.partitionSize;
+
+    // A deferred stage's previous result is due LATENCY_SAMPLES from now. The
+    // callback never stalls on a job that has overrun its block period: this
+    // block's input is dropped instead, and the job is collected later.
+    if (stage.deferred && stage.hasResult) {
+        if (!stage.waitForJob()) {
+            for (auto& input : stage.blockInput) {
+                std::fill(input.begin(), input.end(), 0.0f);
+            }
+            stage.fill = 0;
+            stage.blockChannels = 0;
+            ++stage.missedBlocks;
+            ++lateJobs;
+            return;
+        }
+        collectResult(state, stage);
+    }
+
+    // Slide the overlap-save frame along by one block (a dropped one is silence)
+    for (int channel = 0; channel < MAX_PROCESSED_CHANNELS; ++channel) {
+        auto& frame = stage.frame[channel];
+        auto& input = stage.blockInput[channel];
+        if (stage.missedBlocks > 0) {
+            std::fill(frame.begin(), frame.begin() + partitionSize, 0.0f);
+        } else {
+            std::copy(frame.begin() + partitionSize, frame.end(), frame.begin());
+        }
+        std::copy(input.begin(), input.end(), frame.begin() + partitionSize);
+        std::fill(input.begin(), input.end(), 0.0f);
+    }
+    stage.jobChannels = stage.blockChannels;
+    stage.jobMissedBlocks = stage.missedBlocks;
+    stage.missedBlocks = 0;
+    stage.resultPosition = state.position - partitionSize + stage.layout.offset + LATENCY_SAMPLES;
+    stage.fill = 0;
+    stage.blockChannels = 0;
+    stage.hasResult = true;
+
+    if (stage.deferred && state.background) {
+        stage.jobDeadline = Clock::now() + stage.jobBudget;
+        stage.jobPending.store(true, std::memory_order_release);
+        if (jobQueue.push(&stage)) {
+            parking.wake();
+            return;
+        }
+        stage.jobPending.store(false, std::memory_order_relaxed);
+    }
+
+    stage.run();
+    if (!stage.deferred) {
+        collectResult(state, stage);
+    }
+}
+
+void ConvolutionReverb::collectResult(State& state, Stage& stage) {
+    // A late job's output that is already behind the read position is lost
+    int partitionSize = stage.layout.partitionSize;
+    int skipped = static_cast<int>(std::clamp<int64_t>(state.position - stage.resultPosition, 0, partitionSize));
+    int count = partitionSize - skipped;
+    int start = static_cast<int>((stage.resultPosition + skipped) & state.ringMask);
+    int firstRun = std::min(count, state.ringMask + 1 - start);
+
+    for (int channel = 0; channel < stage.jobChannels; ++channel) {
+        const float* result = stage.result[channel].data() + skipped;
+        float* ring = state.ring[channel].data();
+        for (int i = 0; i < firstRun; ++i) {
+            ring[start + i] += result[i];
+        }
+        for (int i = firstRun; i < count; ++i) {
+            ring[i - firstRun] += result[i];
+        }
+    }
+    stage.hasResult = false;
+}
+
+void ConvolutionReverb::setSampleRate(double sr) {
+    wetLevel.reset(sr, SMOOTHING_TIME_SECONDS);
+    dryLevel.reset(sr, SMOOTHING_TIME_SECONDS);
+
+    std::lock_guard<std::mutex> lock(controlMutex);
+    sampleRate = sr;
+
+    // prepareToPlay calls this, so the worker takes the preparing thread's
+    // priority. One started earlier (by loading a response) is restarted at it.
+    ThreadPriority priority = ThreadPriority::ofCurrentThread();
+    if (priority != workerPriority) {
+        workerPriority = priority;
+        if (worker.joinable()) {
+            stopWorker();
+            startWorker();
+        }
+    }
+    publishState();
+}
+
+void ConvolutionReverb::reset() {
+    // A fresh state starts from silence; the kernel comes from the cache
+    std::lock_guard<std::mutex> lock(controlMutex);
+    publishState();
+}
+
+void ConvolutionReverb::setParameter(int paramId, float value) {
+    switch (paramId) {
+        case 0: wetLevel.setTargetValue(value); break;  // 0.0 - 1.0
+        case 1: dryLevel.setTargetValue(value); break;  // 0.0 - 1.0
+    }
+}
+
+bool ConvolutionReverb::isActive() const {
+    return wetLevel.getTargetValue() > 0.0f || wetLevel.isSmoothing();
+}
+
+int ConvolutionReverb::getTailLengthSamples() const {
+    // The impulse response plus the wet latency and the deferred stages' extra
+    // block period
+    const State* state = states.get();
+    if (state == nullptr || !state->kernel) {
+        return 0;
+    }
+    const ConvolutionKernel& kernel = *state->kernel;
+    int largestPartition = kernel.getStage(kernel.getNumStages() - 1).partitionSize;
+    return kernel.getLength() + LATENCY_SAMPLES + 2 * largestPartition;
+}
+
+void ConvolutionReverb::setImpulseResponse(std::shared_ptr<const ImpulseResponse> newImpulseResponse) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    impulseResponse = std::move(newImpulseResponse);
+    publishState();
+}
+
+std::shared_ptr<const ImpulseResponse> ConvolutionReverb::getImpulseResponse() const {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    return impulseResponse;
+}
+
+void ConvolutionReverb::setNonUniformPartitions(bool nonUniform) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (nonUniform == nonUniformPartitions) return;
+    nonUniformPartitions = nonUniform;
+    publishState();
+}
+
+void ConvolutionReverb::setBackgroundProcessing(bool background) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (background == backgroundProcessing) return;
+    backgroundProcessing = background;
+    publishState();
+}
+
+int ConvolutionReverb::takeLateJobs() {
+    int count = lateJobs;
+    lateJobs = 0;
+    return count;
+}
+
+void ConvolutionReverb::publishState() {
+    // Called with controlMutex held
+    std::shared_ptr<const ConvolutionKernel> kernel;
+    if (impulseResponse && impulseResponse->getLength() > 0) {
+        kernel = impulseResponse->getKernel(sampleRate, nonUniformPartitions);
+    }
+
+    auto* state = new State(std::move(kernel), sampleRate, backgroundProcessing);
+    bool needsWorker = std::any_of(state->stages.begin(), state->stages.end(),
+                                   [](const std::unique_ptr<Stage>& stage) { return stage->deferred; });
+    if (state->background && needsWorker) {
+        startWorker();
+    }
+    states.publish(state);
+}
+
+void ConvolutionReverb::StateDeleter::operator()(State* state) const {
+    // The worker may still be running a job queued before the swap
+    state->waitForJobs();
+    delete state;
+}
+
+void ConvolutionReverb::startWorker() {
+    if (worker.joinable()) return;
+    stopping = false;
+    worker = std::thread(&ConvolutionReverb::workerLoop, this, workerPriority);
+}
+
+void ConvolutionReverb::stopWorker() {
+    if (!worker.joinable()) return;
+
+    parking.wakeAll([this]() { stopping = true; });
+    worker.join();
+}
+
+void ConvolutionReverb::workerLoop(ThreadPriority priority) {
+    priority.applyToCurrentThread();
+    ScopedFlushToZero noDenormals;
+    while (true) {
+        Stage* stage = nullptr;
+        if (jobQueue.pop(stage)) {
+            stage->run();
+            stage->jobPending.store(false, std::memory_order_release);
+            continue;
+        }
+
+        // Only stop once every queued job has run
+        if (stopping.load()) break;
+
+        parking.waitUntil([this]() { return !jobQueue.isEmpty() || stopping.load(); });
+    }
+}
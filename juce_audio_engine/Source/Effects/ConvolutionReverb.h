@@ -0,0 +1,158 @@
+#pragma once
+#include "Effect.h"
+#include "SmoothedParameter.h"
+#include "ConvolutionKernel.h"
+#include "Fft.h"
+#include "../RcuPublisher.h"
+#include "../SpscQueue.h"
+#include "../ThreadPriority.h"
+#include "../WorkerParking.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Reverb that convolves with a recorded impulse response, using partitioned
+// overlap-save FFT convolution.
+//
+// The first ConvolutionKernel::HEAD_PARTITION_SIZE samples of every partition
+// stage are buffered before they are transformed, so the wet signal is
+// LATENCY_SAMPLES late; the dry signal is not delayed. The head stage is
+// computed on the audio thread as each of its blocks fills. Larger
+// (non-uniform) stages have a whole block period before their output is due,
+// so by default their FFT work is queued to a background thread and collected
+// one block later. The result is identical either way, unless a job misses
+// its block period: the audio thread never waits past that, and instead
+// treats the stage's next block of input as silence and counts a late job.
+//
+// Stereo impulse responses are applied dual-mono (left to left, right to
+// right); a mono impulse response is used on both channels.
+class ConvolutionReverb final : public Effect {
+public:
+    static constexpr int LATENCY_SAMPLES = ConvolutionKernel::HEAD_PARTITION_SIZE;
+
+    ConvolutionReverb();
+    ~ConvolutionReverb() override;
+
+    float processSample(float sample) override;
+    void processBlock(float* const* channels, int numChannels, int numSamples) override;
+    void setSampleRate(double sr) override;
+    // Control thread only, like the setters below: publishes an empty state,
+    // so the audio thread never waits on the worker or clears buffers itself
+    void reset() override;
+    void setParameter(int paramId, float value) override;
+    bool isActive() const override;
+    int getTailLengthSamples() const override;
+
+    // Control thread only: these build (or fetch from the impulse response's
+    // cache) a partitioned kernel and hand a fresh convolution state to the
+    // audio thread, which swaps it in at the start of its next block.
+    // nullptr removes the impulse response.
+    void setImpulseResponse(std::shared_ptr<const ImpulseResponse> impulseResponse);
+    std::shared_ptr<const ImpulseResponse> getImpulseResponse() const;
+
+    // Non-uniform partitions keep long impulse responses cheap; uniform ones
+    // run every partition at the head size on the audio thread
+    void setNonUniformPartitions(bool nonUniform);
+    void setBackgroundProcessing(bool background);
+
+    // Audio thread only: background jobs that missed their deadline since the
+    // last call
+    int takeLateJobs();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+
+    // One partition stage for every channel: input buffering, the
+    // frequency-domain delay line and the job handed to the worker
+    struct Stage {
+        ConvolutionStageLayout layout;
+        int stageIndex;
+        bool deferred;                          // Output collected one block after it is computed
+        Clock::duration jobBudget;              // One block period of real time
+        const ConvolutionKernel& kernel;
+        RealFft fft;
+
+        // Audio thread: input for the block being filled
+        std::vector<float> blockInput[MAX_PROCESSED_CHANNELS];
+        int fill = 0;
+        int blockChannels = 0;
+        int missedBlocks = 0;                   // Dropped while a late job was running
+
+        // Job data, owned by whoever holds the job (see jobPending)
+        std::vector<float> frame[MAX_PROCESSED_CHANNELS];      // Previous and current block
+        std::vector<float> fdlReal[MAX_PROCESSED_CHANNELS];
+        std::vector<float> fdlImag[MAX_PROCESSED_CHANNELS];
+        std::vector<float> result[MAX_PROCESSED_CHANNELS];
+        std::vector<float> accumulatorReal, accumulatorImag, timeDomain;
+        int fdlHead = 0;
+        int jobChannels = 0;
+        int jobMissedBlocks = 0;
+        int64_t resultPosition = 0;
+        bool hasResult = false;
+
+        // Set while the job is queued or running on the worker
+        std::atomic<bool> jobPending{false};
+        Clock::time_point jobDeadline;          // Audio thread only
+
+        Stage(const ConvolutionKernel& stageKernel, int index, double sampleRate);
+        void run();
+        bool waitForJob() const;
+    };
+
+    // Everything derived from one kernel at one sample rate. A state without a
+    // kernel produces no wet signal.
+    struct State {
+        std::shared_ptr<const ConvolutionKernel> kernel;
+        std::vector<std::unique_ptr<Stage>> stages;
+        std::vector<float> ring[MAX_PROCESSED_CHANNELS];    // Wet output, zeroed as it is read
+        int ringMask = 0;
+        int64_t position = 0;
+        bool background = false;
+
+        State(std::shared_ptr<const ConvolutionKernel> stateKernel, double sampleRate, bool useBackground);
+        void waitForJobs() const;
+    };
+
+    struct StateDeleter {
+        void operator()(State* state) const;
+    };
+
+    SmoothedParameter wetLevel;
+    SmoothedParameter dryLevel;
+    double sampleRate;
+    static constexpr double SMOOTHING_TIME_SECONDS = 0.05;
+
+    // Control thread settings, guarded by controlMutex (prepareToPlay and the
+    // UI may both publish states)
+    mutable std::mutex controlMutex;
+    std::shared_ptr<const ImpulseResponse> impulseResponse;
+    bool nonUniformPartitions;
+    bool backgroundProcessing;
+    ThreadPriority workerPriority;          // The preparing thread's, from setSampleRate
+
+    // States are published RCU-style, as SynthEngine does with effect
+    // routings; the audio thread adopts a new one at the start of a block
+    static constexpr int RETIRED_STATE_QUEUE_SIZE = 8;
+    RcuPublisher<State, StateDeleter> states;
+
+    // Background worker, started with the first state that needs it
+    static constexpr int JOB_QUEUE_SIZE = 64;
+    SpscQueue<Stage*> jobQueue;
+    std::thread worker;
+    WorkerParking parking;
+    std::atomic<bool> stopping;
+    int lateJobs;                           // Audio thread only
+
+    void publishState();
+
+    void completeBlock(State& state, Stage& stage);
+    void collectResult(State& state, Stage& stage);
+    void startWorker();
+    void stopWorker();
+    void workerLoop(ThreadPriority priority);
+};
@@ -1,10 +1,9 @@
 #include "DelayEffect.h"
+#include "Denormals.h"
 #include <algorithm>
 
 DelayEffect::DelayEffect()
-    : bufferSize(0)
-    , writePosition(0)
-    , sampleRate(44100.0)
+    : sampleRate(44100.0)
     , delayTime(0.25f)      // 250ms default
     , feedback(0.3f)        // 30% feedback
     , wetLevel(0.5f)        // 50% wet
@@ -14,43 +13,90 @@ DelayEffect::DelayEffect()
 }
 
 float DelayEffect::processSample(float sample) {
-    if (!enabled || delayBuffer.empty()) {
-        return sample; // Bypass if disabled or not initialized
+    float* channels[] = { &sample };
+    processBlock(channels, 1, 1);
+    return sample;
+}
+
+void DelayEffect::processBlock(float* const* channels, int numChannels, int numSamples) {
+    if (numChannels <= 0) return;
+    int numProcessed = std::min(numChannels, MAX_PROCESSED_CHANNELS);
+    if (!enabled || lines[0].getMaximumDelay() == 0) {
+        copyToOtherChannels(channels, numChannels, numSamples, numProcessed); // Bypass if disabled or not initialized
+        return;
     }
-    
-    // Calculate read position
+
     int delayInSamples = getDelayInSamples();
-    int readPosition = writePosition - delayInSamples;
-    if (readPosition < 0) {
-        readPosition += bufferSize;
-    }
     
-    // Read delayed sample
-    float delayedSample = delayBuffer[readPosition];
+    float feedbackRamp[PARAMETER_CHUNK_SIZE];
+    float wetRamp[PARAMETER_CHUNK_SIZE];
+    float dryRamp[PARAMETER_CHUNK_SIZE];
     
-    // Write new sample with feedback
-    delayBuffer[writePosition] = sample + (delayedSample * feedback);
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += PARAMETER_CHUNK_SIZE) {
+        int chunkSize = std::min(PARAMETER_CHUNK_SIZE, numSamples - chunkStart);
+        feedback.fillBlock(feedbackRamp, chunkSize);
+        wetLevel.fillBlock(wetRamp, chunkSize);
+        dryLevel.fillBlock(dryRamp, chunkSize);
+        
+        for (int channel = 0; channel < numProcessed; ++channel) {
+            noteTailPeak(processChannel(lines[channel], channels[channel] + chunkStart,
+                                        feedbackRamp, wetRamp, dryRamp, chunkSize, delayInSamples));
+        }
+    }
     
-    // Advance write position
-    writePosition = (writePosition + 1) % bufferSize;
+    copyToOtherChannels(channels, numChannels, numSamples, numProcessed);
+}
+
+float DelayEffect::processChannel(DelayLine& line, float* io, const float* feedbackRamp, const float* wetRamp,
+                                 const float* dryRamp, int numSamples, int delayInSamples) {
+    float delayed[PARAMETER_CHUNK_SIZE];
+    float feedIn[PARAMETER_CHUNK_SIZE];
+    float peak = 0.0f;
     
-    // Mix dry and wet signals
-    return (sample * dryLevel) + (delayedSample * wetLevel);
+    // A run no longer than the delay only reads samples written before it starts,
+    // so it can be read and written back as whole blocks
+    int done = 0;
+    while (done < numSamples) {
+        int runLength = std::min(numSamples - done, delayInSamples);
+        
+        float* run = io + done;
+        const float* fb = feedbackRamp + done;
+        const float* wet = wetRamp + done;
+        const float* dry = dryRamp + done;
+        line.read(delayed, delayInSamples, runLength);
+        peak = std::max(peak, getPeak(delayed, runLength));
+        for (int i = 0; i < runLength; ++i) {
+            float sample = run[i];
+            
+            // Write new sample with feedback, then mix dry and wet signals.
+            // The repeats decay geometrically, so flush them before they go subnormal.
+            feedIn[i] = flushDenormal(sample + (delayed[i] * fb[i]));
+            run[i] = (sample * dry[i]) + (delayed[i] * wet[i]);
+        }
+        line.write(feedIn, runLength);
+        
+        done += runLength;
+    }
+    return peak;
 }
 
 void DelayEffect::setSampleRate(double sr) {
     sampleRate = sr;
-    // Buffer size for maximum 2 seconds delay
-    bufferSize = static_cast<int>(sampleRate * 2.0);
-    delayBuffer.resize(bufferSize);
+    // Room for the maximum 2 seconds delay
+    for (auto& line : lines) {
+        line.setMaximumDelay(static_cast<int>(sampleRate * 2.0));
+    }
+
+    feedback.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    wetLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    dryLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
     reset();
 }
 
 void DelayEffect::reset() {
-    if (!delayBuffer.empty()) {
-        std::fill(delayBuffer.begin(), delayBuffer.end(), 0.0f);
+    for (auto& line : lines) {
+        line.clear();
     }
-    writePosition = 0;
 }
 
 void DelayEffect::setParameter(int paramId, float value) {
@@ -68,8 +114,13 @@ bool DelayEffect::isActive() const {
     return enabled;
 }
 
+int DelayEffect::getTailLengthSamples() const {
+    // With the line silent for one full delay, every later echo is silent too
+    return getDelayInSamples();
+}
+
 int DelayEffect::getDelayInSamples() const {
-    return static_cast<int>(delayTime * sampleRate);
+    return std::max(static_cast<int>(delayTime * sampleRate), 1);
 }
 
 void DelayEffect::setDelayTime(float timeInSeconds) {
@@ -77,15 +128,15 @@ void DelayEffect::setDelayTime(float timeInSeconds) {
 }
 
 void DelayEffect::setFeedback(float fb) {
-    feedback = std::clamp(fb, 0.0f, 0.95f); // Max 95% to prevent runaway
+    feedback.setTargetValue(std::clamp(fb, 0.0f, 0.95f)); // Max 95% to prevent runaway
 }
 
 void DelayEffect::setWetLevel(float wet) {
-    wetLevel = std::clamp(wet, 0.0f, 1.0f);
+    wetLevel.setTargetValue(std::clamp(wet, 0.0f, 1.0f));
 }
 
 void DelayEffect::setDryLevel(float dry) {
-    dryLevel = std::clamp(dry, 0.0f, 1.0f);
+    dryLevel.setTargetValue(std::clamp(dry, 0.0f, 1.0f));
 }
 
 void DelayEffect::setEnabled(bool enable) {
@@ -1,32 +1,40 @@
 #pragma once
 #include "Effect.h"
-#include <vector>
+#include "SmoothedParameter.h"
+#include "DelayLine.h"
 
-class DelayEffect : public Effect {
+// Stereo delay: each channel runs through its own line with shared settings
+class DelayEffect final : public Effect {
 private:
-    std::vector<float> delayBuffer;
-    int bufferSize;
-    int writePosition;
+    DelayLine lines[MAX_PROCESSED_CHANNELS];
     double sampleRate;
     
     // Parameters
     float delayTime;        // 0.0 - 2.0 seconds
-    float feedback;         // 0.0 - 0.95 (prevent runaway)
-    float wetLevel;         // 0.0 - 1.0
-    float dryLevel;         // 0.0 - 1.0
+    SmoothedParameter feedback;     // 0.0 - 0.95 (prevent runaway)
+    SmoothedParameter wetLevel;     // 0.0 - 1.0
+    SmoothedParameter dryLevel;     // 0.0 - 1.0
     bool enabled;
+
+    static constexpr double SMOOTHING_TIME_SECONDS = 0.02;
     
     int getDelayInSamples() const;
+
+    // Runs one channel through its line for a chunk; returns the peak it read
+    static float processChannel(DelayLine& line, float* io, const float* feedbackRamp, const float* wetRamp,
+                               const float* dryRamp, int numSamples, int delayInSamples);
     
 public:
     DelayEffect();
     
     // Override Effect base class methods
     float processSample(float sample) override;
+    void processBlock(float* const* channels, int numChannels, int numSamples) override;
     void setSampleRate(double sr) override;
     void reset() override;
     void setParameter(int paramId, float value) override;
     bool isActive() const override;
+    int getTailLengthSamples() const override;
     
     // Delay-specific methods
     void setDelayTime(float timeInSeconds);
@@ -37,7 +45,7 @@ public:
     
     // Parameter getters
     float getDelayTime() const { return delayTime; }
-    float getFeedback() const { return feedback; }
-    float getWetLevel() const { return wetLevel; }
-    float getDryLevel() const { return dryLevel; }
+    float getFeedback() const { return feedback.getTargetValue(); }
+    float getWetLevel() const { return wetLevel.getTargetValue(); }
+    float getDryLevel() const { return dryLevel.getTargetValue(); }
 };
\ No newline at end of file
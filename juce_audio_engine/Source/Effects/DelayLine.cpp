@@ -0,0 +1,36 @@
+#include "DelayLine.h"
+#include <algorithm>
+
+void DelayLine::setMaximumDelay(int maxDelaySamples) {
+    maximumDelay = std::max(maxDelaySamples, 1);
+
+    int capacity = 1;
+    while (capacity < maximumDelay + INTERPOLATION_GUARD) {
+        capacity <<= 1;
+    }
+    buffer.assign(capacity, 0.0f);
+    mask = capacity - 1;
+    writePosition = 0;
+}
+
+void DelayLine::clear() {
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    writePosition = 0;
+}
+
+void DelayLine::write(const float* input, int numSamples) {
+    // Up to the end of the buffer, then the remainder from the start
+    int capacity = mask + 1;
+    int firstSpan = std::min(numSamples, capacity - writePosition);
+    std::copy(input, input + firstSpan, buffer.begin() + writePosition);
+    std::copy(input + firstSpan, input + numSamples, buffer.begin());
+    writePosition = (writePosition + numSamples) & mask;
+}
+
+void DelayLine::read(float* output, int delaySamples, int numSamples) const {
+    int capacity = mask + 1;
+    int readPosition = (writePosition - delaySamples) & mask;
+    int firstSpan = std::min(numSamples, capacity - readPosition);
+    std::copy(buffer.begin() + readPosition, buffer.begin() + readPosition + firstSpan, output);
+    std::copy(buffer.begin(), buffer.begin() + (numSamples - firstSpan), output + firstSpan);
+}
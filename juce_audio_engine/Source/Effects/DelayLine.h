@@ -0,0 +1,109 @@
+#pragma once
+#include <vector>
+
+// How a fractional delay is read between stored samples
+enum class DelayInterpolation {
+    NONE = 0,       // Truncate to the whole sample
+    LINEAR = 1,     // Two taps; cheap, slight high-frequency loss at half-sample delays
+    LAGRANGE = 2,   // Third-order, four taps; flatter response for modulated delays
+    ALLPASS = 3     // First-order Thiran; flat magnitude, but keeps state so suits fixed delays
+};
+
+// Circular delay buffer shared by the time-based effects. Capacity is rounded
+// up to a power of two so positions wrap with a mask instead of a modulo, and
+// block reads/writes copy in at most two contiguous spans.
+//
+// Delays are counted back from the write position: delay 1 is the most
+// recently written sample. A block read of numSamples at delay d returns the
+// samples that a per-sample loop would have read before each write, so it is
+// only valid while numSamples <= d; callers split longer runs.
+class DelayLine {
+public:
+    DelayLine() = default;
+
+    // Allocates room for delays up to maxDelaySamples and clears the line.
+    // Not real-time safe.
+    void setMaximumDelay(int maxDelaySamples);
+    int getMaximumDelay() const { return maximumDelay; }
+    void clear();
+
+    // Single-sample access
+    void push(float sample) {
+        buffer[writePosition] = sample;
+        writePosition = (writePosition + 1) & mask;
+    }
+    float read(int delaySamples) const {
+        return buffer[(writePosition - delaySamples) & mask];
+    }
+
+    // Fractional reads. delaySamples must lie in [1, getMaximumDelay()];
+    // LAGRANGE needs at least 2 so its leading tap has already been written.
+    float readLinear(float delaySamples) const;
+    float readLagrange(float delaySamples) const;
+    // readAllpass keeps its output in state and must be called once per push
+    float readAllpass(float delaySamples, float& state) const;
+    float read(float delaySamples, DelayInterpolation interpolation, float& allpassState) const;
+
+    // Block access
+    void write(const float* input, int numSamples);
+    void read(float* output, int delaySamples, int numSamples) const;
+
+private:
+    std::vector<float> buffer = std::vector<float>(1, 0.0f);
+    int mask = 0;
+    int writePosition = 0;
+    int maximumDelay = 0;
+
+    // Extra slots so the Lagrange taps either side of the maximum delay stay in range
+    static constexpr int INTERPOLATION_GUARD = 3;
+};
+
+inline float DelayLine::readLinear(float delaySamples) const {
+    int whole = static_cast<int>(delaySamples);
+    float fraction = delaySamples - static_cast<float>(whole);
+    float a = read(whole);
+    float b = read(whole + 1);
+    return a + fraction * (b - a);
+}
+
+inline float DelayLine::readLagrange(float delaySamples) const {
+    int whole = static_cast<int>(delaySamples);
+    float d = delaySamples - static_cast<float>(whole);
+    float xm1 = read(whole - 1);
+    float x0 = read(whole);
+    float x1 = read(whole + 1);
+    float x2 = read(whole + 2);
+
+    // Weights for taps at offsets -1, 0, 1, 2 evaluated at d
+    float dm1 = d - 1.0f;
+    float dm2 = d - 2.0f;
+    float dp1 = d + 1.0f;
+    return -d * dm1 * dm2 * (1.0f / 6.0f) * xm1
+         + dp1 * dm1 * dm2 * 0.5f * x0
+         - dp1 * d * dm2 * 0.5f * x1
+         + dp1 * d * dm1 * (1.0f / 6.0f) * x2;
+}
+
+inline float DelayLine::readAllpass(float delaySamples, float& state) const {
+    // Keep the fractional part in [0.5, 1.5) where the coefficient is well behaved
+    int whole = static_cast<int>(delaySamples);
+    float fraction = delaySamples - static_cast<float>(whole);
+    if (fraction < 0.5f && whole > 1) {
+        --whole;
+        fraction += 1.0f;
+    }
+    float coefficient = (1.0f - fraction) / (1.0f + fraction);
+    float output = coefficient * read(whole) + read(whole + 1) - coefficient * state;
+    state = output;
+    return output;
+}
+
+inline float DelayLine::read(float delaySamples, DelayInterpolation interpolation, float& allpassState) const {
+    switch (interpolation) {
+        case DelayInterpolation::LINEAR: return readLinear(delaySamples);
+        case DelayInterpolation::LAGRANGE: return readLagrange(delaySamples);
+        case DelayInterpolation::ALLPASS: return readAllpass(delaySamples, allpassState);
+        case DelayInterpolation::NONE:
+        default: return read(static_cast<int>(delaySamples));
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define SYNTH_DENORMALS_SSE 1
+#elif defined(__aarch64__) || defined(__arm__)
+    #define SYNTH_DENORMALS_ARM 1
+#endif
+
+// Feedback paths (delay lines, filter integrators, reverb damping) decay
+// towards zero forever once their input stops, and the last stretch passes
+// through subnormal floats, which many CPUs handle in microcode at up to 100x
+// the cost of a normal operation. Two defences, used together:
+//
+// - ScopedFlushToZero switches the calling thread's FPU to flush subnormal
+//   results and inputs to zero (FTZ/DAZ on x86, FZ on ARM) for as long as it
+//   is in scope. Every thread that runs DSP sets it: the audio callback and
+//   each render or convolution worker.
+// - flushDenormal() zeroes anything below DENORMAL_THRESHOLD explicitly where
+//   a value is fed back, for CPUs or threads without flush-to-zero.
+
+// Well above the subnormal range (~1e-38) so products of a flushed value and
+// a gain can never become subnormal, and far below anything audible (-300 dB)
+static constexpr float DENORMAL_THRESHOLD = 1.0e-15f;
+
+inline float flushDenormal(float value) {
+    return std::abs(value) < DENORMAL_THRESHOLD ? 0.0f : value;
+}
+
+// Branch-free over the block so it vectorizes
+inline void flushDenormals(float* samples, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        samples[i] = std::abs(samples[i]) < DENORMAL_THRESHOLD ? 0.0f : samples[i];
+    }
+}
+
+class ScopedFlushToZero {
+public:
+    ScopedFlushToZero() : previousMode(getMode()) {
+        setMode(previousMode | FLUSH_BITS);
+    }
+
+    ~ScopedFlushToZero() {
+        setMode(previousMode);
+    }
+
+    ScopedFlushToZero(const ScopedFlushToZero&) = delete;
+    ScopedFlushToZero& operator=(const ScopedFlushToZero&) = delete;
+
+private:
+#if SYNTH_DENORMALS_SSE
+    static constexpr uintptr_t FLUSH_BITS = 0x8040;      // MXCSR FTZ (bit 15) and DAZ (bit 6)
+    static uintptr_t getMode() { return _mm_getcsr(); }
+    static void setMode(uintptr_t mode) { _mm_setcsr(static_cast<unsigned int>(mode)); }
+#elif SYNTH_DENORMALS_ARM
+    static constexpr uintptr_t FLUSH_BITS = 1 << 24;     // FPCR / FPSCR FZ
+    static uintptr_t getMode() {
+        uintptr_t mode;
+    #if defined(__aarch64__)
+        asm volatile("mrs %0, fpcr" : "=r"(mode));
+    #else
+        asm volatile("vmrs %0, fpscr" : "=r"(mode));
+    #endif
+        return mode;
+    }
+    static void setMode(uintptr_t mode) {
+    #if defined(__aarch64__)
+        asm volatile("msr fpcr, %0" : : "r"(mode));
+    #else
+        asm volatile("vmsr fpscr, %0" : : "r"(mode));
+    #endif
+    }
+#else
+    // No known control register: rely on flushDenormal() alone
+    static constexpr uintptr_t FLUSH_BITS = 0;
+    static uintptr_t getMode() { return 0; }
+    static void setMode(uintptr_t) {}
+#endif
+
+    uintptr_t previousMode;
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
 
 class Effect {
 public:
@@ -10,7 +12,115 @@ public:
     virtual void setSampleRate(double sampleRate) = 0;
     virtual void reset() = 0;
     
+    // In-place block processing. Effects process up to MAX_PROCESSED_CHANNELS
+    // (stereo) natively and copy those to any further channels. The default
+    // falls back to processSample on the first channel only; effects override
+    // it with a native block loop.
+    virtual void processBlock(float* const* channels, int numChannels, int numSamples) {
+        if (numChannels <= 0) return;
+
+        float* samples = channels[0];
+        for (int i = 0; i < numSamples; ++i) {
+            samples[i] = processSample(samples[i]);
+        }
+        copyToOtherChannels(channels, numChannels, numSamples);
+    }
+    
     // Virtual methods with default implementations
     virtual void setParameter(int paramId, float value) {}
     virtual bool isActive() const { return true; }
-};
\ No newline at end of file
+
+    // How long the effect can keep producing output after its input goes
+    // silent: the longest delay a sample can sit in its buffers before it
+    // reaches the output again. Called on the audio thread.
+    virtual int getTailLengthSamples() const { return 0; }
+
+    // Sleep tracking for callers that want to skip idle effects (EffectChain,
+    // SynthEngine). An effect sleeps once its input, its output and what its
+    // buffers return (before the wet gain, see noteTailPeak) have all been
+    // below SILENCE_THRESHOLD for its whole tail: nothing it still holds can
+    // become audible, even if the wet level is raised later, so processing
+    // more silence would only reproduce the input. Call beginBlock() before
+    // processBlock() and skip it if that returns false; otherwise call
+    // endBlock() with the processed output.
+    static constexpr float SILENCE_THRESHOLD = 1.0e-6f;    // -120 dBFS
+
+    bool beginBlock(const float* const* channels, int numChannels, int numSamples) {
+        inputSilent = isSilent(channels, numChannels, numSamples);
+        tailPeak = 0.0f;
+        if (!inputSilent) {
+            silentSamples = 0;
+            return true;
+        }
+        return !isSleeping();
+    }
+
+    void endBlock(const float* const* channels, int numChannels, int numSamples) {
+        if (inputSilent && tailPeak <= SILENCE_THRESHOLD && isSilent(channels, numChannels, numSamples)) {
+            silentSamples = std::min(silentSamples + numSamples, MAX_SILENT_SAMPLES);
+        } else {
+            silentSamples = 0;
+        }
+    }
+
+    bool isSleeping() const { return silentSamples > getTailLengthSamples(); }
+
+    static bool isSilent(const float* const* channels, int numChannels, int numSamples) {
+        // Branch-free over fixed chunks so the compare vectorizes; returns at
+        // the first audible chunk, so real signals cost one chunk
+        constexpr int SCAN_CHUNK = 16;
+        for (int channel = 0; channel < std::min(numChannels, MAX_PROCESSED_CHANNELS); ++channel) {
+            const float* samples = channels[channel];
+            int i = 0;
+            for (; i + SCAN_CHUNK <= numSamples; i += SCAN_CHUNK) {
+                int loud = 0;
+                for (int j = 0; j < SCAN_CHUNK; ++j) {
+                    loud |= std::abs(samples[i + j]) > SILENCE_THRESHOLD;
+                }
+                if (loud) return false;
+            }
+            for (; i < numSamples; ++i) {
+                if (std::abs(samples[i]) > SILENCE_THRESHOLD) return false;
+            }
+        }
+        return true;
+    }
+
+protected:
+    // Block loops work in chunks of this size so smoothed parameters can be
+    // expanded into small stack arrays
+    static constexpr int PARAMETER_CHUNK_SIZE = 64;
+
+    static constexpr int MAX_PROCESSED_CHANNELS = 2;
+
+    // Fills every channel from numProcessed onwards with the processed
+    // channel in the same stereo position (left for even, right for odd)
+    // Effects that hold signal call this from processBlock with the largest
+    // magnitude their lines or taps returned, before the wet gain. A muted wet
+    // level then cannot hide a line that is still full.
+    void noteTailPeak(float peak) { tailPeak = std::max(tailPeak, peak); }
+
+    static float getPeak(const float* samples, int numSamples) {
+        float peak = 0.0f;
+        for (int i = 0; i < numSamples; ++i) {
+            peak = std::max(peak, std::abs(samples[i]));
+        }
+        return peak;
+    }
+
+    static void copyToOtherChannels(float* const* channels, int numChannels, int numSamples, int numProcessed = 1) {
+        for (int channel = numProcessed; channel < numChannels; ++channel) {
+            const float* source = channels[channel % numProcessed];
+            for (int i = 0; i < numSamples; ++i) {
+                channels[channel][i] = source[i];
+            }
+        }
+    }
+
+private:
+    static constexpr int MAX_SILENT_SAMPLES = 1 << 30;
+
+    int silentSamples = 0;      // Consecutive samples of silent input, output and tail
+    bool inputSilent = false;
+    float tailPeak = 0.0f;      // Since beginBlock()
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include "ChorusEffect.h"
+#include "DelayEffect.h"
+#include "ReverbEffect.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+// The insert effects a chain can draw from
+using EffectSet = std::tuple<ChorusEffect*, DelayEffect*, ReverbEffect*>;
+
+enum class EffectType {
+    CHORUS = 0,
+    DELAY = 1,
+    REVERB = 2
+};
+
+static constexpr int NUM_EFFECT_TYPES = 3;
+
+// Processing order of the insert effects; always a permutation of every EffectType
+using EffectOrder = std::array<EffectType, NUM_EFFECT_TYPES>;
+
+// Time spent in each effect, indexed by EffectType, added to by a chain when given one
+struct EffectChainTimings {
+    int64_t nanoseconds[NUM_EFFECT_TYPES] = {};
+};
+
+// Processes one block through a fixed, precompiled combination of effects.
+// timings may be nullptr, in which case nothing is timed.
+using EffectChainFunction = void (*)(const EffectSet& effects, float* const* channels, int numChannels, int numSamples,
+                                     EffectChainTimings* timings);
+
+template <EffectType Type> struct EffectClass;
+template <> struct EffectClass<EffectType::CHORUS> { using type = ChorusEffect; };
+template <> struct EffectClass<EffectType::DELAY> { using type = DelayEffect; };
+template <> struct EffectClass<EffectType::REVERB> { using type = ReverbEffect; };
+
+// A chain whose order and enabled effects are known at compile time.
+//
+// Every effect is called through its concrete (final) type, so the calls are
+// direct and can be inlined, and disabled stages compile away entirely. The
+// block is walked in short sub-blocks that pass through the whole chain while
+// still in L1 cache. Stages whose effect has rung out on silent input are
+// skipped (see Effect::beginBlock). The engine picks an instantiation with
+// selectEffectChain() and just swaps a pointer, so reordering costs nothing
+// per sample.
+template <EffectType First, EffectType Second, EffectType Third, int EnabledMask>
+struct EffectChain {
+    static constexpr int FUSED_BLOCK_SIZE = 64;
+
+    static void process(const EffectSet& effects, float* const* channels, int numChannels, int numSamples,
+                        EffectChainTimings* timings) {
+        constexpr int MAX_CHANNELS = 8;
+        numChannels = std::min(numChannels, MAX_CHANNELS);
+
+        float* subBlock[MAX_CHANNELS];
+        for (int start = 0; start < numSamples; start += FUSED_BLOCK_SIZE) {
+            int length = std::min(FUSED_BLOCK_SIZE, numSamples - start);
+            for (int channel = 0; channel < numChannels; ++channel) {
+                subBlock[channel] = channels[channel] + start;
+            }
+
+            processStage<First>(effects, subBlock, numChannels, length, timings);
+            processStage<Second>(effects, subBlock, numChannels, length, timings);
+            processStage<Third>(effects, subBlock, numChannels, length, timings);
+        }
+    }
+
+private:
+    template <EffectType Type>
+    static void processStage(const EffectSet& effects, float* const* channels, int numChannels, int numSamples,
+                             EffectChainTimings* timings) {
+        if constexpr ((EnabledMask & (1 << static_cast<int>(Type))) != 0) {
+            using StageEffect = typename EffectClass<Type>::type;
+            StageEffect* effect = std::get<StageEffect*>(effects);
+            std::chrono::steady_clock::time_point start;
+            if (timings != nullptr) start = std::chrono::steady_clock::now();
+            if (effect->beginBlock(channels, numChannels, numSamples)) {
+                effect->StageEffect::processBlock(channels, numChannels, numSamples);
+                effect->endBlock(channels, numChannels, numSamples);
+            }
+            if (timings != nullptr) {
+                timings->nanoseconds[static_cast<int>(Type)] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            }
+        }
+    }
+};
+
+namespace EffectChainTable {
+    static constexpr int NUM_ORDERS = 6;
+    static constexpr int NUM_MASKS = 1 << NUM_EFFECT_TYPES;
+
+    inline constexpr EffectType orders[NUM_ORDERS][NUM_EFFECT_TYPES] = {
+        { EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB },
+        { EffectType::CHORUS, EffectType::REVERB, EffectType::DELAY },
+        { EffectType::DELAY, EffectType::CHORUS, EffectType::REVERB },
+        { EffectType::DELAY, EffectType::REVERB, EffectType::CHORUS },
+        { EffectType::REVERB, EffectType::CHORUS, EffectType::DELAY },
+        { EffectType::REVERB, EffectType::DELAY, EffectType::CHORUS }
+    };
+
+    // One chain per (order, enabled mask) pair, indexed order * NUM_MASKS + mask
+    template <std::size_t... I>
+    constexpr std::array<EffectChainFunction, sizeof...(I)> build(std::index_sequence<I...>) {
+        return {{ &EffectChain<orders[I / NUM_MASKS][0], orders[I / NUM_MASKS][1],
+                               orders[I / NUM_MASKS][2], static_cast<int>(I % NUM_MASKS)>::process... }};
+    }
+
+    inline constexpr auto chains = build(std::make_index_sequence<NUM_ORDERS * NUM_MASKS>());
+
+    // Index into orders[], or -1 if the order is not a permutation of every effect
+    inline int findOrder(const EffectOrder& order) {
+        for (int index = 0; index < NUM_ORDERS; ++index) {
+            if (std::equal(order.begin(), order.end(), orders[index])) {
+                return index;
+            }
+        }
+        return -1;
+    }
+}
+
+inline int effectMask(EffectType type) {
+    return 1 << static_cast<int>(type);
+}
+
+inline bool isValidEffectOrder(const EffectOrder& order) {
+    return EffectChainTable::findOrder(order) >= 0;
+}
+
+// Chain running the effects in enabledMask (see effectMask) in the given order.
+// Returns nullptr when no effect is enabled or the order is invalid.
+inline EffectChainFunction selectEffectChain(const EffectOrder& order, int enabledMask) {
+    int orderIndex = EffectChainTable::findOrder(order);
+    enabledMask &= EffectChainTable::NUM_MASKS - 1;
+    if (orderIndex < 0 || enabledMask == 0) {
+        return nullptr;
+    }
+    return EffectChainTable::chains[orderIndex * EffectChainTable::NUM_MASKS + enabledMask];
+}
+
+// Immutable snapshot of the insert chain. SynthEngine builds a new one on the
+// control thread for every routing change and hands it to the audio thread
+// whole, so the audio thread never sees a half-updated chain.
+struct EffectRouting {
+    EffectOrder order;
+    int enabledMask;
+    EffectChainFunction process;    // nullptr when no effect is enabled
+
+    EffectRouting(const EffectOrder& effectOrder, int mask)
+        : order(effectOrder)
+        , enabledMask(mask)
+        , process(selectEffectChain(effectOrder, mask))
+    {
+    }
+
+    bool isEnabled(EffectType type) const { return (enabledMask & effectMask(type)) != 0; }
+};
@@ -0,0 +1,164 @@
+#include "FdnReverb.h"
+#include "Denormals.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Line lengths spread geometrically across this range, rounded to primes
+    // so no two lines share a common period
+    constexpr double SHORTEST_LINE_MS = 19.0;
+    constexpr double LONGEST_LINE_MS = 61.0;
+
+    constexpr float INPUT_GAIN = 0.5f;
+    constexpr float OUTPUT_GAIN = 0.5f;            // 1 / sqrt(4) lines per channel
+    constexpr float HADAMARD_SCALE = 0.35355339f;  // 1 / sqrt(NUM_LINES)
+    constexpr float MAX_DAMPING = 0.85f;
+
+    bool isPrime(int n) {
+        if (n < 2) return false;
+        for (int divisor = 2; divisor * divisor <= n; ++divisor) {
+            if (n % divisor == 0) return false;
+        }
+        return true;
+    }
+
+    int nextPrime(int n) {
+        while (!isPrime(n)) {
+            ++n;
+        }
+        return n;
+    }
+
+    // One Hadamard butterfly between two lines' rows: a becomes a + b and b
+    // becomes a - b. Rows of different lines never overlap, and every row is
+    // MAX_BLOCK_SIZE long whatever the block size.
+    void butterfly(float* __restrict a, float* __restrict b) {
+        for (int i = 0; i < FdnReverb::MAX_BLOCK_SIZE; ++i) {
+            float sum = a[i] + b[i];
+            float difference = a[i] - b[i];
+            a[i] = sum;
+            b[i] = difference;
+        }
+    }
+}
+
+FdnReverb::FdnReverb()
+    : lineLengths{}
+    , lineGains{}
+    , dampingStates{}
+    , dampingCoefficient(0.0f)
+    , sampleRate(44100.0)
+    , currentRoomSize(0.5f)
+    , currentDamping(0.5f)
+{
+    setSampleRate(sampleRate);
+}
+
+void FdnReverb::setSampleRate(double sr) {
+    sampleRate = sr;
+    int previousLength = 0;
+    for (int line = 0; line < NUM_LINES; ++line) {
+        double position = static_cast<double>(line) / (NUM_LINES - 1);
+        double lengthMs = SHORTEST_LINE_MS * std::pow(LONGEST_LINE_MS / SHORTEST_LINE_MS, position);
+        int length = static_cast<int>(lengthMs * 0.001 * sampleRate);
+        length = nextPrime(std::max({ length, previousLength + 1, MAX_BLOCK_SIZE + 1 }));
+        lineLengths[line] = length;
+        lines[line].setMaximumDelay(length);
+        previousLength = length;
+    }
+    updateGains();
+    clear();
+}
+
+void FdnReverb::clear() {
+    for (auto& line : lines) {
+        line.clear();
+    }
+    std::fill(std::begin(dampingStates), std::end(dampingStates), 0.0f);
+}
+
+int FdnReverb::getLongestLineLength() const {
+    return *std::max_element(lineLengths, lineLengths + NUM_LINES);
+}
+
+void FdnReverb::setParameters(float roomSize, float damping) {
+    if (roomSize == currentRoomSize && damping == currentDamping) return;
+    currentRoomSize = roomSize;
+    currentDamping = damping;
+    updateGains();
+}
+
+void FdnReverb::updateGains() {
+    // Each line loses 60 dB over the decay time in proportion to its length
+    double decaySeconds = 0.3 * std::pow(30.0, std::clamp(currentRoomSize, 0.0f, 1.0f));
+    for (int line = 0; line < NUM_LINES; ++line) {
+        double gain = std::pow(10.0, -3.0 * lineLengths[line] / (decaySeconds * sampleRate));
+        lineGains[line] = static_cast<float>(gain) * HADAMARD_SCALE;
+    }
+    dampingCoefficient = std::clamp(currentDamping, 0.0f, 1.0f) * MAX_DAMPING;
+}
+
+float FdnReverb::processBlock(const float* inputLeft, const float* inputRight,
+                             float* outputLeft, float* outputRight, int numSamples) {
+    float rows[NUM_LINES][MAX_BLOCK_SIZE];
+    numSamples = std::min(numSamples, MAX_BLOCK_SIZE);
+
+    float peak = 0.0f;
+    for (int line = 0; line < NUM_LINES; ++line) {
+        lines[line].read(rows[line], lineLengths[line], numSamples);
+        std::fill(rows[line] + numSamples, rows[line] + MAX_BLOCK_SIZE, 0.0f);
+        for (int i = 0; i < numSamples; ++i) {
+            peak = std::max(peak, std::abs(rows[line][i]));
+        }
+    }
+
+    // Taps: even lines to the left, odd lines to the right
+    for (int i = 0; i < numSamples; ++i) {
+        outputLeft[i] = 0.0f;
+        outputRight[i] = 0.0f;
+    }
+    for (int line = 0; line < NUM_LINES; line += 2) {
+        const float* even = rows[line];
+        const float* odd = rows[line + 1];
+        for (int i = 0; i < numSamples; ++i) {
+            outputLeft[i] += even[i] * OUTPUT_GAIN;
+            outputRight[i] += odd[i] * OUTPUT_GAIN;
+        }
+    }
+
+    // Per-line one-pole damping and decay gain (with the matrix scale folded in).
+    // Lines are the inner loop so the per-line recursions run side by side.
+    float feedforward = 1.0f - dampingCoefficient;
+    float states[NUM_LINES];
+    std::copy(std::begin(dampingStates), std::end(dampingStates), states);
+    for (int i = 0; i < numSamples; ++i) {
+        for (int line = 0; line < NUM_LINES; ++line) {
+            states[line] = rows[line][i] * feedforward + states[line] * dampingCoefficient;
+            rows[line][i] = states[line] * lineGains[line];
+        }
+    }
+    flushDenormals(states, NUM_LINES);
+    std::copy(std::begin(states), std::end(states), dampingStates);
+
+    // Fast Walsh-Hadamard transform across lines, one block-long row at a time
+    for (int half = NUM_LINES / 2; half >= 1; half /= 2) {
+        for (int start = 0; start < NUM_LINES; start += 2 * half) {
+            for (int line = start; line < start + half; ++line) {
+                butterfly(rows[line], rows[line + half]);
+            }
+        }
+    }
+
+    // Inject the input with alternating signs per pair, then write back
+    for (int line = 0; line < NUM_LINES; ++line) {
+        const float* input = (line % 2 == 0) ? inputLeft : inputRight;
+        float inputGain = ((line / 2) % 2 == 0) ? INPUT_GAIN : -INPUT_GAIN;
+        float* row = rows[line];
+        for (int i = 0; i < numSamples; ++i) {
+            row[i] += input[i] * inputGain;
+        }
+        flushDenormals(row, numSamples);
+        lines[line].write(row, numSamples);
+    }
+    return peak;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "DelayLine.h"
+
+// 8-line feedback delay network. Line outputs are damped, scaled for the
+// requested decay time and mixed back through an orthonormal Hadamard matrix,
+// which spreads every line into every other one each pass so echo density
+// builds far faster than in parallel combs.
+//
+// Lines are always longer than MAX_BLOCK_SIZE, so a whole block can be read
+// from every line before any of it is written back. The matrix is then applied
+// as butterflies between per-line rows of the block: each step is a plain
+// add/subtract over contiguous samples, which compilers vectorize.
+class FdnReverb {
+public:
+    static constexpr int NUM_LINES = 8;
+    static constexpr int MAX_BLOCK_SIZE = 64;
+
+    FdnReverb();
+
+    // Recomputes line lengths for the sample rate and clears the network.
+    // Not real-time safe.
+    void setSampleRate(double sampleRate);
+    void clear();
+
+    // roomSize 0 - 1 maps to a decay time of roughly 0.3 - 9 s; damping 0 - 1
+    // darkens the tail. Cheap to call every block: gains are only recomputed
+    // when a value moves.
+    void setParameters(float roomSize, float damping);
+
+    // Delay of the longest line in samples
+    int getLongestLineLength() const;
+
+    // Writes numSamples (at most MAX_BLOCK_SIZE) of wet output. The left input
+    // feeds the even lines and the right input the odd lines; the outputs are
+    // taken from the same split, so a mono source still gets a wide tail.
+    // Returns the largest magnitude read from any line, which bounds what the
+    // network still holds even where the output taps cancel.
+    float processBlock(const float* inputLeft, const float* inputRight,
+                      float* outputLeft, float* outputRight, int numSamples);
+
+private:
+    DelayLine lines[NUM_LINES];
+    int lineLengths[NUM_LINES];
+    float lineGains[NUM_LINES];
+    float dampingStates[NUM_LINES];
+    float dampingCoefficient;
+    double sampleRate;
+    float currentRoomSize;
+    float currentDamping;
+
+    void updateGains();
+};
@@ -0,0 +1,141 @@
+#include "Fft.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int BUTTERFLY_CHUNK = 8;
+
+    // BUTTERFLY_CHUNK radix-2 butterflies of one pass: b is rotated by its
+    // twiddle, then a and b become a + wb and a - wb. The two halves of a
+    // butterfly group are span apart and the twiddles have their own table,
+    // so none of the six arrays overlap.
+    void butterflies(float* __restrict aReal, float* __restrict aImag,
+                     float* __restrict bReal, float* __restrict bImag,
+                     const float* __restrict twiddleReal, const float* __restrict twiddleImag) {
+        for (int j = 0; j < BUTTERFLY_CHUNK; ++j) {
+            float vr = bReal[j] * twiddleReal[j] - bImag[j] * twiddleImag[j];
+            float vi = bReal[j] * twiddleImag[j] + bImag[j] * twiddleReal[j];
+            bReal[j] = aReal[j] - vr;
+            bImag[j] = aImag[j] - vi;
+            aReal[j] += vr;
+            aImag[j] += vi;
+        }
+    }
+}
+
+RealFft::RealFft(int order)
+    : size(1 << order)
+    , half(size / 2)
+    , bitReversed(half)
+    , stageCos(std::max(half - 1, 1))
+    , stageSin(std::max(half - 1, 1))
+    , splitCos(half)
+    , splitSin(half)
+    , workReal(half)
+    , workImag(half)
+{
+    int bits = order - 1;
+    for (int i = 0; i < half; ++i) {
+        int reversed = 0;
+        for (int bit = 0; bit < bits; ++bit) {
+            reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+        }
+        bitReversed[i] = reversed;
+    }
+
+    const double twoPi = 6.283185307179586;
+    // The pass combining spans of length/2 starts at index length/2 - 1
+    for (int length = 2; length <= half; length <<= 1) {
+        int span = length / 2;
+        for (int j = 0; j < span; ++j) {
+            stageCos[span - 1 + j] = static_cast<float>(std::cos(twoPi * j / length));
+            stageSin[span - 1 + j] = static_cast<float>(-std::sin(twoPi * j / length));
+        }
+    }
+    for (int k = 0; k < half; ++k) {
+        splitCos[k] = static_cast<float>(std::cos(twoPi * k / size));
+        splitSin[k] = static_cast<float>(std::sin(twoPi * k / size));
+    }
+}
+
+void RealFft::transform(float* real, float* imag) {
+    // Iterative decimation in time; the caller has already loaded the input
+    // in bit-reversed order
+    for (int length = 2; length <= half; length <<= 1) {
+        int span = length / 2;
+        const float* twiddleReal = &stageCos[span - 1];
+        const float* twiddleImag = &stageSin[span - 1];
+        for (int start = 0; start < half; start += length) {
+            float* aReal = real + start;
+            float* aImag = imag + start;
+            float* bReal = aReal + span;
+            float* bImag = aImag + span;
+            if (span >= BUTTERFLY_CHUNK) {
+                for (int j = 0; j < span; j += BUTTERFLY_CHUNK) {
+                    butterflies(aReal + j, aImag + j, bReal + j, bImag + j, twiddleReal + j, twiddleImag + j);
+                }
+                continue;
+            }
+            for (int j = 0; j < span; ++j) {
+                float vr = bReal[j] * twiddleReal[j] - bImag[j] * twiddleImag[j];
+                float vi = bReal[j] * twiddleImag[j] + bImag[j] * twiddleReal[j];
+                bReal[j] = aReal[j] - vr;
+                bImag[j] = aImag[j] - vi;
+                aReal[j] += vr;
+                aImag[j] += vi;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float* input, float* real, float* imag) {
+    // Pack even samples as real parts and odd samples as imaginary parts
+    for (int n = 0; n < half; ++n) {
+        workReal[bitReversed[n]] = input[2 * n];
+        workImag[bitReversed[n]] = input[2 * n + 1];
+    }
+    transform(workReal.data(), workImag.data());
+
+    // Split the packed spectrum into the even and odd halves and recombine
+    real[0] = workReal[0] + workImag[0];
+    imag[0] = 0.0f;
+    real[half] = workReal[0] - workImag[0];
+    imag[half] = 0.0f;
+    for (int k = 1; k < half; ++k) {
+        float ar = workReal[k], ai = workImag[k];
+        float br = workReal[half - k], bi = -workImag[half - k];
+        float evenReal = 0.5f * (ar + br);
+        float evenImag = 0.5f * (ai + bi);
+        float oddReal = 0.5f * (ai - bi);
+        float oddImag = -0.5f * (ar - br);
+        float c = splitCos[k], s = splitSin[k];
+        real[k] = evenReal + c * oddReal + s * oddImag;
+        imag[k] = evenImag + c * oddImag - s * oddReal;
+    }
+}
+
+void RealFft::inverse(const float* real, const float* imag, float* output) {
+    // Rebuild the packed spectrum (conjugated, so the forward butterflies
+    // compute the inverse transform)
+    for (int k = 0; k < half; ++k) {
+        float ar = real[k], ai = imag[k];
+        float br = real[half - k], bi = -imag[half - k];
+        float evenReal = 0.5f * (ar + br);
+        float evenImag = 0.5f * (ai + bi);
+        float differenceReal = 0.5f * (ar - br);
+        float differenceImag = 0.5f * (ai - bi);
+        float c = splitCos[k], s = splitSin[k];
+        float oddReal = c * differenceReal - s * differenceImag;
+        float oddImag = c * differenceImag + s * differenceReal;
+        int slot = bitReversed[k];
+        workReal[slot] = evenReal - oddImag;
+        workImag[slot] = -(evenImag + oddReal);
+    }
+    transform(workReal.data(), workImag.data());
+
+    float scale = 1.0f / static_cast<float>(half);
+    for (int n = 0; n < half; ++n) {
+        output[2 * n] = workReal[n] * scale;
+        output[2 * n + 1] = -workImag[n] * scale;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+
+// Real-input FFT of a fixed power-of-two size. The size-N real transform runs
+// as a size-N/2 complex transform on even/odd sample pairs plus one
+// split pass, with bit-reversal and twiddle tables built once up front. Each
+// butterfly pass reads its own contiguous twiddle table, so the wider passes
+// run as fixed-length vector loops.
+//
+// Spectra hold N/2 + 1 bins as separate real and imaginary arrays, which keeps
+// spectral multiply-accumulate loops contiguous for the vectorizer. An
+// instance keeps scratch space, so each thread needs its own.
+class RealFft {
+public:
+    explicit RealFft(int order);
+
+    // log2 of a power-of-two size, so RealFft(getOrder(n)).getSize() == n
+    static int getOrder(int size) {
+        int order = 0;
+        while ((1 << order) < size) {
+            ++order;
+        }
+        return order;
+    }
+
+    int getSize() const { return size; }
+    int getNumBins() const { return size / 2 + 1; }
+
+    // size samples in, getNumBins() bins out
+    void forward(const float* input, float* real, float* imag);
+
+    // getNumBins() bins in, size samples out; scaled so inverse(forward(x)) == x
+    void inverse(const float* real, const float* imag, float* output);
+
+private:
+    int size;
+    int half;
+    std::vector<int> bitReversed;
+    std::vector<float> stageCos, stageSin;         // exp(-2 pi i j / length) for each pass, back to back
+    std::vector<float> splitCos, splitSin;         // exp(-2 pi i k / size)
+    std::vector<float> workReal, workImag;
+
+    void transform(float* real, float* imag);      // In-place forward complex FFT of size half
+};
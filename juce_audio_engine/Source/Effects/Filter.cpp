@@ -1,46 +1,148 @@
 #include "Filter.h"
+#include "Denormals.h"
 #include <algorithm>
 #include <cmath>
-#include <memory>
 
-//LowpassFilter Implementation
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
-LowpassFilter::LowpassFilter() 
-    : cutoff(1000.0f), resonance(1.0f), z1(0.0f), z2(0.0f), sampleRate(44100.0) {
+//SvfCoefficients Implementation
+
+void SvfCoefficients::update(float cutoff, float q, double sampleRate, FilterMode mode) {
+    // Keep the prewarped cutoff clear of Nyquist, where tan() blows up
+    double maxCutoff = sampleRate * 0.49;
+    double frequency = std::clamp(static_cast<double>(cutoff), 1.0, maxCutoff);
+    float g = static_cast<float>(std::tan(M_PI * frequency / sampleRate));
+
+    k = 1.0f / q;
+    a1 = 1.0f / (1.0f + g * (g + k));
+    a2 = g * a1;
+    a3 = g * a2;
+
+    switch (mode) {
+        case FilterMode::LOWPASS:  m0 = 0.0f; m1 = 0.0f; m2 = 1.0f;  break;
+        case FilterMode::HIGHPASS: m0 = 1.0f; m1 = -k;   m2 = -1.0f; break;
+        case FilterMode::BANDPASS: m0 = 0.0f; m1 = 1.0f; m2 = 0.0f;  break;
+        case FilterMode::NOTCH:    m0 = 1.0f; m1 = -k;   m2 = 0.0f;  break;
+    }
+}
+
+//StateVariableFilter Implementation
+
+StateVariableFilter::StateVariableFilter()
+    : cutoff(1000.0f, SmoothingType::EXPONENTIAL)
+    , resonance(1.0f)
+    , mode(FilterMode::LOWPASS)
+    , sampleRate(44100.0)
+    , coefficientsDirty(true)
+    , samplesUntilUpdate(0)
+{
+    setSampleRate(sampleRate);
+    reset();
+}
+
+void StateVariableFilter::setCutoff(float freq) {
+    cutoff.setTargetValue(std::clamp(freq, 20.0f, 20000.0f));
+    coefficientsDirty = true;
 }
 
-void LowpassFilter::setCutoff(float freq) {
-    cutoff = std::clamp(freq, 20.0f, 20000.0f);
+void StateVariableFilter::setResonance(float q) {
+    resonance.setTargetValue(std::clamp(q, 0.1f, 10.0f));
+    coefficientsDirty = true;
 }
 
-void LowpassFilter::setResonance(float q) {
-    resonance = std::clamp(q, 0.1f, 10.0f);
+void StateVariableFilter::setMode(FilterMode newMode) {
+    mode = newMode;
+    coefficientsDirty = true;
 }
 
-void LowpassFilter::setSampleRate(double sr) {
+void StateVariableFilter::setSampleRate(double sr) {
     sampleRate = sr;
+    cutoff.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    resonance.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    coefficientsDirty = true;
+}
+
+void StateVariableFilter::reset() {
+    std::fill(ic1eq, ic1eq + MAX_CHANNELS, 0.0f);
+    std::fill(ic2eq, ic2eq + MAX_CHANNELS, 0.0f);
 }
 
-void LowpassFilter::reset() {
-    z1 = 0.0f;
-    z2 = 0.0f;
-}
-
-float LowpassFilter::processSample(float sample) {
-    // Simple 2-pole lowpass filter 
-    float nyquist = sampleRate / 2.0f;
-    float normalizedCutoff = cutoff / nyquist;
-    
-    // Clamp to prevent instability
-    normalizedCutoff = std::clamp(normalizedCutoff, 0.001f, 0.99f);
-    
-    // Simple filter calculation
-    float alpha = normalizedCutoff;
-    float feedback = resonance * 0.1f;
-    
-    // Apply filter
-    z1 = z1 + alpha * (sample - z1 + feedback * (z1 - z2));
-    z2 = z2 + alpha * (z1 - z2);
-    
-    return z2;
-}
\ No newline at end of file
+void StateVariableFilter::setParameter(int paramId, float value) {
+    switch (paramId) {
+        case 0: setCutoff(value); break;
+        case 1: setResonance(value); break;
+        case 2: setMode(static_cast<FilterMode>(std::clamp(static_cast<int>(value), 0, 3))); break;
+        default: break;
+    }
+}
+
+int StateVariableFilter::prepareCoefficients(int numSamples) {
+    if (cutoff.isSmoothing() || resonance.isSmoothing()) {
+        // Gliding: step the smoothers one interval at a time
+        if (samplesUntilUpdate == 0) {
+            float currentCutoff = cutoff.skip(COEFFICIENT_UPDATE_INTERVAL);
+            float currentResonance = resonance.skip(COEFFICIENT_UPDATE_INTERVAL);
+            coefficients.update(currentCutoff, currentResonance, sampleRate, mode);
+            samplesUntilUpdate = COEFFICIENT_UPDATE_INTERVAL;
+        }
+    } else if (coefficientsDirty) {
+        // Settled: one final update, then the cached values hold indefinitely
+        coefficients.update(cutoff.getTargetValue(), resonance.getTargetValue(), sampleRate, mode);
+        coefficientsDirty = false;
+        samplesUntilUpdate = 0;
+    }
+
+    if (samplesUntilUpdate == 0) {
+        return numSamples;
+    }
+
+    int runLength = std::min(numSamples, samplesUntilUpdate);
+    samplesUntilUpdate -= runLength;
+    return runLength;
+}
+
+float StateVariableFilter::processSample(float sample) {
+    processBlock(&sample, 1);
+    return sample;
+}
+
+void StateVariableFilter::processBlock(float* samples, int numSamples) {
+    float* channels[] = { samples };
+    processBlock(channels, 1, numSamples);
+}
+
+void StateVariableFilter::processBlock(float* const* channels, int numChannels, int numSamples) {
+    numChannels = std::min(numChannels, MAX_CHANNELS);
+
+    int position = 0;
+    while (position < numSamples) {
+        int runLength = prepareCoefficients(numSamples - position);
+
+        // Copy everything the inner loop needs into locals so it stays in registers
+        const float a1 = coefficients.a1, a2 = coefficients.a2, a3 = coefficients.a3;
+        const float m0 = coefficients.m0, m1 = coefficients.m1, m2 = coefficients.m2;
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            float* data = channels[channel] + position;
+            float s1 = ic1eq[channel];
+            float s2 = ic2eq[channel];
+
+            for (int i = 0; i < runLength; ++i) {
+                float v0 = data[i];
+                float v3 = v0 - s2;
+                float v1 = a1 * s1 + a2 * v3;     // band
+                float v2 = s2 + a2 * s1 + a3 * v3;  // low
+                s1 = 2.0f * v1 - s1;
+                s2 = 2.0f * v2 - s2;
+                data[i] = m0 * v0 + m1 * v1 + m2 * v2;
+            }
+
+            ic1eq[channel] = flushDenormal(s1);
+            ic2eq[channel] = flushDenormal(s2);
+        }
+
+        position += runLength;
+    }
+}
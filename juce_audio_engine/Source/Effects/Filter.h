@@ -1,24 +1,74 @@
 #pragma once
 #include "Effect.h"
+#include "SmoothedParameter.h"
 #include <cmath>
 
-class LowpassFilter : public Effect {
+enum class FilterMode {
+    LOWPASS = 0,
+    HIGHPASS = 1,
+    BANDPASS = 2,
+    NOTCH = 3
+};
+
+// Trapezoidal (TPT / zero-delay-feedback) state-variable filter coefficients.
+// Output = m0 * input + m1 * band + m2 * low, which covers every FilterMode
+// without branching in the sample loop.
+struct SvfCoefficients {
+    float k = 1.0f;         // 1 / Q
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+    float a3 = 0.0f;
+    float m0 = 0.0f;
+    float m1 = 0.0f;
+    float m2 = 1.0f;
+
+    void update(float cutoff, float q, double sampleRate, FilterMode mode);
+};
+
+// Multimode state-variable filter. Stays stable at any resonance and cutoff
+// up to just below Nyquist; coefficients (one tan per update) are only
+// recomputed when a parameter changes, or every COEFFICIENT_UPDATE_INTERVAL
+// samples while cutoff/resonance are gliding.
+class StateVariableFilter : public Effect {
 private:
-    float cutoff;
-    float resonance;
-    float z1, z2;  // Filter state variables
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr int COEFFICIENT_UPDATE_INTERVAL = 16;
+    static constexpr double SMOOTHING_TIME_SECONDS = 0.02;
+
+    SmoothedParameter cutoff;       // Exponential glide in Hz
+    SmoothedParameter resonance;    // Q
+    FilterMode mode;
     double sampleRate;
-    
+
+    SvfCoefficients coefficients;
+    bool coefficientsDirty;
+    int samplesUntilUpdate;
+
+    // Integrator states, one pair per channel
+    float ic1eq[MAX_CHANNELS];
+    float ic2eq[MAX_CHANNELS];
+
+    // Refreshes coefficients if needed and returns how many samples they are good for
+    int prepareCoefficients(int numSamples);
+
 public:
-    LowpassFilter();
-    
+    StateVariableFilter();
+
     // Effect interface implementation
     float processSample(float sample) override;
     void setSampleRate(double sr) override;
     void reset() override;
-    
+    void setParameter(int paramId, float value) override;
+
+    // In-place block processing. Unlike the mono effects, the multichannel
+    // form filters every channel (up to 8), sharing coefficients but keeping
+    // independent state for each
+    void processBlock(float* samples, int numSamples);
+    void processBlock(float* const* channels, int numChannels, int numSamples) override;
+
     // Filter-specific methods
     void setCutoff(float freq);
     void setResonance(float q);
+    void setMode(FilterMode newMode);
+    FilterMode getMode() const { return mode; }
 };
-
@@ -0,0 +1,228 @@
+#include "Oversampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int FILTER_CHUNK = 16;
+    constexpr double KAISER_BETA = 8.0;
+
+    // Zeroth-order modified Bessel function, for the Kaiser window
+    double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // One tap of the half-band filter, applied to FILTER_CHUNK outputs at once:
+    // filter() walks the taps and this loop runs across outputs. The
+    // accumulator is a local array, so it never overlaps the history.
+    void multiplyAdd(float* __restrict accumulator, const float* __restrict input, float coefficient) {
+        for (int i = 0; i < FILTER_CHUNK; ++i) {
+            accumulator[i] += input[i] * coefficient;
+        }
+    }
+}
+
+// HalfBandStage implementations
+HalfBandStage::HalfBandStage(int taps)
+    : halfTaps(taps)
+    , coefficients(2 * taps)
+{
+    // Kaiser-windowed sinc with its cut-off at a quarter of the higher rate.
+    // Only odd offsets from the centre are non-zero; coefficient i sits at
+    // offset 2 * halfTaps - 1 - 2i.
+    const double pi = 3.141592653589793;
+    int length = 4 * halfTaps - 1;
+    double centre = (length - 1) / 2.0;
+    double sum = 0.0;
+    for (int i = 0; i < 2 * halfTaps; ++i) {
+        double offset = 2 * halfTaps - 1 - 2 * i;
+        double sinc = std::sin(pi * offset / 2.0) / (pi * offset);
+        double ratio = offset / centre;
+        double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / besselI0(KAISER_BETA);
+        coefficients[i] = static_cast<float>(sinc * window);
+        sum += sinc * window;
+    }
+
+    // The odd taps sum to 0.5 so DC passes at unity; interpolation doubles
+    // them to make up for the inserted zeros
+    for (auto& coefficient : coefficients) {
+        coefficient = static_cast<float>(coefficient * 0.5 / sum * 2.0);
+    }
+}
+
+void HalfBandStage::prepare(int maxInputSamples) {
+    int historyLength = 2 * halfTaps - 1;
+    upHistory.assign(historyLength + maxInputSamples, 0.0f);
+    downEvenHistory.assign(historyLength + maxInputSamples, 0.0f);
+    downOddHistory.assign(halfTaps + maxInputSamples, 0.0f);
+}
+
+void HalfBandStage::reset() {
+    // Only the history matters; the rest is overwritten by the next block
+    int historyLength = 2 * halfTaps - 1;
+    std::fill(upHistory.begin(), upHistory.begin() + historyLength, 0.0f);
+    std::fill(downEvenHistory.begin(), downEvenHistory.begin() + historyLength, 0.0f);
+    std::fill(downOddHistory.begin(), downOddHistory.begin() + halfTaps, 0.0f);
+}
+
+void HalfBandStage::filter(const float* history, float* output, int outputStride, int numSamples, float gain) const {
+    int numTaps = 2 * halfTaps;
+    int done = 0;
+    float accumulator[FILTER_CHUNK];
+
+    for (; done + FILTER_CHUNK <= numSamples; done += FILTER_CHUNK) {
+        std::fill(accumulator, accumulator + FILTER_CHUNK, 0.0f);
+        for (int tap = 0; tap < numTaps; ++tap) {
+            multiplyAdd(accumulator, history + done + tap, coefficients[tap]);
+        }
+        for (int i = 0; i < FILTER_CHUNK; ++i) {
+            output[(done + i) * outputStride] = accumulator[i] * gain;
+        }
+    }
+
+    for (; done < numSamples; ++done) {
+        float sum = 0.0f;
+        for (int tap = 0; tap < numTaps; ++tap) {
+            sum += history[done + tap] * coefficients[tap];
+        }
+        output[done * outputStride] = sum * gain;
+    }
+}
+
+void HalfBandStage::upsample(const float* input, float* output, int numSamples) {
+    int historyLength = 2 * halfTaps - 1;
+    std::copy(input, input + numSamples, upHistory.begin() + historyLength);
+
+    // Even outputs are the FIR phase, odd outputs the delayed input
+    filter(upHistory.data(), output, 2, numSamples, 1.0f);
+    const float* delayed = upHistory.data() + halfTaps;
+    for (int i = 0; i < numSamples; ++i) {
+        output[2 * i + 1] = delayed[i];
+    }
+
+    std::copy(upHistory.begin() + numSamples, upHistory.begin() + numSamples + historyLength, upHistory.begin());
+}
+
+void HalfBandStage::downsample(const float* input, float* output, int numSamples) {
+    int historyLength = 2 * halfTaps - 1;
+    float* even = downEvenHistory.data() + historyLength;
+    float* odd = downOddHistory.data() + halfTaps;
+    for (int i = 0; i < numSamples; ++i) {
+        even[i] = input[2 * i];
+        odd[i] = input[2 * i + 1];
+    }
+
+    // FIR over the even phase plus the centre tap on the delayed odd phase
+    filter(downEvenHistory.data(), output, 1, numSamples, 0.5f);
+    for (int i = 0; i < numSamples; ++i) {
+        output[i] += 0.5f * downOddHistory[i];
+    }
+
+    std::copy(downEvenHistory.begin() + numSamples, downEvenHistory.begin() + numSamples + historyLength,
+              downEvenHistory.begin());
+    std::copy(downOddHistory.begin() + numSamples, downOddHistory.begin() + numSamples + halfTaps,
+              downOddHistory.begin());
+}
+
+// Oversampler implementations
+Oversampler::Oversampler()
+    : factor(1)
+    , maxBlockSize(0)
+    , oversampledPointers{}
+{
+}
+
+void Oversampler::prepare(OversamplingFactor newFactor, int newMaxBlockSize) {
+    factor = static_cast<int>(newFactor);
+    maxBlockSize = newMaxBlockSize;
+
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel) {
+        upStages[channel].clear();
+        downStages[channel].clear();
+        int stageInputSize = maxBlockSize;
+        for (int stageFactor = 2; stageFactor <= factor; stageFactor *= 2) {
+            int halfTaps = (stageFactor == 2) ? FIRST_STAGE_HALF_TAPS : LATER_STAGE_HALF_TAPS;
+            upStages[channel].emplace_back(halfTaps);
+            downStages[channel].emplace_back(halfTaps);
+            upStages[channel].back().prepare(stageInputSize);
+            downStages[channel].back().prepare(stageInputSize);
+            stageInputSize *= 2;
+        }
+
+        scratch[channel][0].assign(static_cast<size_t>(maxBlockSize) * factor, 0.0f);
+        scratch[channel][1].assign(static_cast<size_t>(maxBlockSize) * factor, 0.0f);
+        oversampled[channel].assign(static_cast<size_t>(maxBlockSize) * factor, 0.0f);
+        oversampledPointers[channel] = oversampled[channel].data();
+    }
+}
+
+void Oversampler::reset() {
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel) {
+        for (auto& stage : upStages[channel]) {
+            stage.reset();
+        }
+        for (auto& stage : downStages[channel]) {
+            stage.reset();
+        }
+    }
+}
+
+float Oversampler::getLatencyInSamples() const {
+    // Each stage delays both directions by its latency at its higher rate
+    float latency = 0.0f;
+    int stageRate = 2;
+    for (const auto& stage : upStages[0]) {
+        latency += 2.0f * stage.getLatency() / stageRate;
+        stageRate *= 2;
+    }
+    return latency;
+}
+
+float* const* Oversampler::processUp(const float* const* channels, int numChannels, int numSamples) {
+    numChannels = std::min(numChannels, MAX_CHANNELS);
+    int numStages = static_cast<int>(upStages[0].size());
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        if (numStages == 0) {
+            std::copy(channels[channel], channels[channel] + numSamples, oversampled[channel].begin());
+            continue;
+        }
+
+        const float* input = channels[channel];
+        int length = numSamples;
+        for (int stage = 0; stage < numStages; ++stage) {
+            bool last = stage == numStages - 1;
+            float* output = last ? oversampled[channel].data() : scratch[channel][stage % 2].data();
+            upStages[channel][stage].upsample(input, output, length);
+            input = output;
+            length *= 2;
+        }
+    }
+    return oversampledPointers;
+}
+
+void Oversampler::processDown(float* const* channels, int numChannels, int numSamples) {
+    numChannels = std::min(numChannels, MAX_CHANNELS);
+    int numStages = static_cast<int>(downStages[0].size());
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        if (numStages == 0) {
+            std::copy(oversampled[channel].begin(), oversampled[channel].begin() + numSamples, channels[channel]);
+            continue;
+        }
+
+        // Highest rate first, so the steep first stage runs last at the lowest rate
+        const float* input = oversampled[channel].data();
+        int length = numSamples * factor / 2;
+        for (int stage = numStages - 1; stage >= 0; --stage) {
+            float* output = (stage == 0) ? channels[channel] : scratch[channel][stage % 2].data();
+            downStages[channel][stage].downsample(input, output, length);
+            input = output;
+            length /= 2;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <vector>
+
+// Oversampling factors an engine can run its nonlinear stages at
+enum class OversamplingFactor {
+    NONE = 1,
+    X2 = 2,
+    X4 = 4,
+    X8 = 8
+};
+
+// Polyphase half-band FIR interpolator/decimator for one 2x step.
+//
+// A half-band filter has every even tap zero except the centre one, so each
+// direction splits into two phases: one is a plain delay, the other a
+// symmetric 2 * HALF_TAPS-tap FIR running at the lower rate. The FIR is
+// evaluated a fixed-size chunk of outputs at a time with the taps as the
+// outer loop, which compilers turn into straight vector multiply-adds.
+class HalfBandStage {
+public:
+    // halfTaps = taps on each side of the centre that are non-zero; more taps
+    // give a narrower transition band
+    explicit HalfBandStage(int halfTaps);
+
+    void prepare(int maxInputSamples);
+    void reset();
+
+    // numSamples in, 2 * numSamples out
+    void upsample(const float* input, float* output, int numSamples);
+
+    // 2 * numSamples in, numSamples out
+    void downsample(const float* input, float* output, int numSamples);
+
+    // Delay at the higher rate for one direction
+    int getLatency() const { return 2 * halfTaps - 1; }
+
+private:
+    int halfTaps;
+    std::vector<float> coefficients;    // The 2 * halfTaps odd taps, doubled for interpolation
+
+    // History followed by the block being processed, so the FIR reads one
+    // contiguous run; the tail is moved back to the front after each block
+    std::vector<float> upHistory;
+    std::vector<float> downEvenHistory;
+    std::vector<float> downOddHistory;
+
+    void filter(const float* history, float* output, int outputStride, int numSamples, float gain) const;
+};
+
+// Cascade of half-band stages taking up to MAX_CHANNELS channels to 2x, 4x or
+// 8x the base rate and back. The stage next to the base rate has the steepest
+// filter, since it alone must reject images just above the audio band; later
+// stages only see content far below their Nyquist and stay short.
+//
+// Use processUp() to move a block into the oversampled buffers, or fill
+// getOversampledChannels() directly for sources generated at the higher rate,
+// then processDown() to bring the result back.
+class Oversampler {
+public:
+    static constexpr int MAX_CHANNELS = 2;
+
+    Oversampler();
+
+    // Allocates for blocks of up to maxBlockSize base-rate samples. Not
+    // real-time safe.
+    void prepare(OversamplingFactor factor, int maxBlockSize);
+    void reset();
+
+    int getFactor() const { return factor; }
+
+    // Round trip (processUp then processDown) delay in base-rate samples
+    float getLatencyInSamples() const;
+
+    // Upsamples numSamples of each channel; returns the oversampled channels
+    // (numSamples * getFactor() long)
+    float* const* processUp(const float* const* channels, int numChannels, int numSamples);
+
+    // The oversampled buffers processDown() reads from
+    float* const* getOversampledChannels() { return oversampledPointers; }
+
+    // Decimates numSamples * getFactor() oversampled samples per channel back
+    // into numSamples of each output channel
+    void processDown(float* const* channels, int numChannels, int numSamples);
+
+private:
+    static constexpr int FIRST_STAGE_HALF_TAPS = 16;
+    static constexpr int LATER_STAGE_HALF_TAPS = 6;
+
+    int factor;
+    int maxBlockSize;
+
+    // [channel][stage], stage 0 next to the base rate
+    std::vector<HalfBandStage> upStages[MAX_CHANNELS];
+    std::vector<HalfBandStage> downStages[MAX_CHANNELS];
+
+    // Intermediate rates ping-pong between these; the final rate lives in oversampled
+    std::vector<float> scratch[MAX_CHANNELS][2];
+    std::vector<float> oversampled[MAX_CHANNELS];
+    float* oversampledPointers[MAX_CHANNELS];
+};
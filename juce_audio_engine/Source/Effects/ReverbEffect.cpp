@@ -1,62 +1,160 @@
 #include "ReverbEffect.h"
+#include "Denormals.h"
 #include <algorithm>
 
-// DelayLine implementations
-ReverbEffect::DelayLine::DelayLine(int delaySize) 
-    : buffer(delaySize, 0.0f), writePos(0), size(delaySize) {
+// CombLine implementations
+ReverbEffect::CombLine::CombLine(int delaySize) 
+    : length(delaySize) {
+    line.setMaximumDelay(delaySize);
 }
 
-float ReverbEffect::DelayLine::process(float input, float feedback) {
-    float output = buffer[writePos];
-    buffer[writePos] = input + (output * feedback);
-    writePos = (writePos + 1) % size;
-    return output;
+float ReverbEffect::CombLine::processBlock(const float* input, const float* feedback, float* accumulator, int numSamples) {
+    float output[PARAMETER_CHUNK_SIZE];
+    float feedIn[PARAMETER_CHUNK_SIZE];
+    float peak = 0.0f;
+    
+    int done = 0;
+    while (done < numSamples) {
+        // A run no longer than the line only reads samples written before it
+        int runLength = std::min({ numSamples - done, length, PARAMETER_CHUNK_SIZE });
+        line.read(output, length, runLength);
+        peak = std::max(peak, getPeak(output, runLength));
+        for (int i = 0; i < runLength; ++i) {
+            feedIn[i] = flushDenormal(input[done + i] + (output[i] * feedback[done + i]));
+            accumulator[done + i] += output[i];
+        }
+        line.write(feedIn, runLength);
+        done += runLength;
+    }
+    return peak;
 }
 
-void ReverbEffect::DelayLine::clear() {
-    std::fill(buffer.begin(), buffer.end(), 0.0f);
-    writePos = 0;
+void ReverbEffect::CombLine::clear() {
+    line.clear();
 }
 
 // ReverbEffect implementations
 ReverbEffect::ReverbEffect() 
-    : roomSize(0.5f), damping(0.5f), wetLevel(0.3f), dryLevel(0.7f), sampleRate(44100.0) {
+    : roomSize(0.5f), damping(0.5f), wetLevel(0.3f), dryLevel(0.7f), sampleRate(44100.0),
+      algorithm(ReverbAlgorithm::COMB) {
+    setSampleRate(sampleRate);
 }
 
 float ReverbEffect::processSample(float sample) {
-    // Process through delay lines
-    float reverb = 0.0f;
-    reverb += delay1.process(sample, roomSize * damping);
-    reverb += delay2.process(sample, roomSize * damping);
-    reverb += delay3.process(sample, roomSize * damping);
-    reverb += delay4.process(sample, roomSize * damping);
+    float* channels[] = { &sample };
+    processBlock(channels, 1, 1);
+    return sample;
+}
+
+void ReverbEffect::processBlock(float* const* channels, int numChannels, int numSamples) {
+    if (numChannels <= 0) return;
+    int numProcessed = std::min(numChannels, MAX_PROCESSED_CHANNELS);
+    bool stereo = numProcessed == 2;
+    
+    float room[PARAMETER_CHUNK_SIZE];
+    float lineFeedback[PARAMETER_CHUNK_SIZE];
+    float damp[PARAMETER_CHUNK_SIZE];
+    float wetRamp[PARAMETER_CHUNK_SIZE];
+    float dryRamp[PARAMETER_CHUNK_SIZE];
+    float input[PARAMETER_CHUNK_SIZE];
+    float reverbLeft[PARAMETER_CHUNK_SIZE];
+    float reverbRight[PARAMETER_CHUNK_SIZE];
+    
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += PARAMETER_CHUNK_SIZE) {
+        int chunkSize = std::min(PARAMETER_CHUNK_SIZE, numSamples - chunkStart);
+        float* left = channels[0] + chunkStart;
+        float* right = stereo ? channels[1] + chunkStart : nullptr;
+        
+        roomSize.fillBlock(room, chunkSize);
+        damping.fillBlock(damp, chunkSize);
+        wetLevel.fillBlock(wetRamp, chunkSize);
+        dryLevel.fillBlock(dryRamp, chunkSize);
+        
+        float reverbGain;
+        if (algorithm == ReverbAlgorithm::FDN) {
+            // The network updates its gains at most once per chunk
+            fdn.setParameters(room[chunkSize - 1], damp[chunkSize - 1]);
+            noteTailPeak(fdn.processBlock(left, stereo ? right : left, reverbLeft, reverbRight, chunkSize));
+            reverbGain = 1.0f;
+        } else {
+            for (int i = 0; i < chunkSize; ++i) {
+                lineFeedback[i] = room[i] * damp[i];
+                input[i] = stereo ? (left[i] + right[i]) * 0.5f : left[i];
+                reverbLeft[i] = 0.0f;
+                reverbRight[i] = 0.0f;
+            }
+            
+            // Process through delay lines, one whole chunk per line
+            // (the lines are checked one by one, as their sum can cancel)
+            for (auto& comb : leftLines) {
+                noteTailPeak(comb.processBlock(input, lineFeedback, reverbLeft, chunkSize));
+            }
+            if (stereo) {
+                for (auto& comb : rightLines) {
+                    noteTailPeak(comb.processBlock(input, lineFeedback, reverbRight, chunkSize));
+                }
+            }
+            reverbGain = 0.25f;     // Average of the four lines
+        }
+        
+        // Mix
+        for (int i = 0; i < chunkSize; ++i) {
+            left[i] = (left[i] * dryRamp[i]) + (reverbLeft[i] * reverbGain * wetRamp[i]);
+        }
+        if (stereo) {
+            for (int i = 0; i < chunkSize; ++i) {
+                right[i] = (right[i] * dryRamp[i]) + (reverbRight[i] * reverbGain * wetRamp[i]);
+            }
+        }
+    }
     
-    // Average and mix
-    reverb *= 0.25f;
-    return (sample * dryLevel) + (reverb * wetLevel);
+    copyToOtherChannels(channels, numChannels, numSamples, numProcessed);
 }
 
 void ReverbEffect::setSampleRate(double sr) {
     sampleRate = sr;
-    // Delay sizes are fixed
+    // Comb sizes are fixed; the FDN rescales its lines
+    fdn.setSampleRate(sampleRate);
+    roomSize.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    damping.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    wetLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
+    dryLevel.reset(sampleRate, SMOOTHING_TIME_SECONDS);
 }
 
 void ReverbEffect::reset() {
-    delay1.clear();
-    delay2.clear();
-    delay3.clear();
-    delay4.clear();
+    for (auto& comb : leftLines) {
+        comb.clear();
+    }
+    for (auto& comb : rightLines) {
+        comb.clear();
+    }
+    fdn.clear();
 }
 
 void ReverbEffect::setParameter(int paramId, float value) {
     switch (paramId) {
-        case 0: roomSize = value; break;  // 0.0 - 1.0
-        case 1: damping = value; break;   // 0.0 - 1.0
-        case 2: wetLevel = value; break;  // 0.0 - 1.0
-        case 3: dryLevel = value; break;  // 0.0 - 1.0
+        case 0: roomSize.setTargetValue(value); break;  // 0.0 - 1.0
+        case 1: damping.setTargetValue(value); break;   // 0.0 - 1.0
+        case 2: wetLevel.setTargetValue(value); break;  // 0.0 - 1.0
+        case 3: dryLevel.setTargetValue(value); break;  // 0.0 - 1.0
+        case 4: setAlgorithm(value > 0.5f ? ReverbAlgorithm::FDN : ReverbAlgorithm::COMB); break;
     }
 }
 
 bool ReverbEffect::isActive() const {
-    return wetLevel > 0.0f;
+    return wetLevel.getTargetValue() > 0.0f || wetLevel.isSmoothing();
+}
+
+int ReverbEffect::getTailLengthSamples() const {
+    // One pass of the longest line; its output then bounds everything recirculating
+    if (algorithm == ReverbAlgorithm::FDN) {
+        return fdn.getLongestLineLength();
+    }
+    return rightLines[NUM_LINES - 1].length;
+}
+
+void ReverbEffect::setAlgorithm(ReverbAlgorithm newAlgorithm) {
+    if (newAlgorithm == algorithm) return;
+    algorithm = newAlgorithm;
+    reset();
 }
\ No newline at end of file
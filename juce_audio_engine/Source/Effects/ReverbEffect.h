@@ -1,40 +1,64 @@
 #pragma once
 #include "Effect.h"
-#include <vector>
+#include "SmoothedParameter.h"
+#include "DelayLine.h"
+#include "FdnReverb.h"
 
-class ReverbEffect : public Effect {
+enum class ReverbAlgorithm {
+    COMB = 0,   // Four parallel feedback combs per channel
+    FDN = 1     // 8-line feedback delay network, denser and sample-rate scaled
+};
+
+// Stereo reverb with two selectable algorithms. COMB feeds the summed input
+// into two banks of delay lines whose lengths differ slightly, so the left and
+// right tails are decorrelated; FDN runs an FdnReverb with true stereo input.
+class ReverbEffect final : public Effect {
 private:
-    // Simple delay line implementation
-    struct DelayLine {
-        std::vector<float> buffer;
-        int writePos;
-        int size;
+    // Feedback comb built on a fixed-length delay line
+    struct CombLine {
+        DelayLine line;
+        int length;
         
-        DelayLine(int delaySize);
-        float process(float input, float feedback);
+        explicit CombLine(int delaySize);
+        // Adds numSamples of line output into accumulator, feeding input back in.
+        // Returns the peak line output.
+        float processBlock(const float* input, const float* feedback, float* accumulator, int numSamples);
         void clear();
     };
     
-    // Multiple delay lines for rich reverb (using prime numbers)
-    DelayLine delay1{1051};
-    DelayLine delay2{1399};
-    DelayLine delay3{1777};
-    DelayLine delay4{2003};
+    // Multiple delay lines for rich reverb (using prime numbers); the right
+    // bank is offset by STEREO_SPREAD samples, as in Freeverb
+    static constexpr int NUM_LINES = 4;
+    static constexpr int STEREO_SPREAD = 23;
+    CombLine leftLines[NUM_LINES] = { CombLine(1051), CombLine(1399), CombLine(1777), CombLine(2003) };
+    CombLine rightLines[NUM_LINES] = { CombLine(1051 + STEREO_SPREAD), CombLine(1399 + STEREO_SPREAD),
+                                       CombLine(1777 + STEREO_SPREAD), CombLine(2003 + STEREO_SPREAD) };
     
     // Parameters
-    float roomSize;
-    float damping;
-    float wetLevel;
-    float dryLevel;
+    SmoothedParameter roomSize;
+    SmoothedParameter damping;
+    SmoothedParameter wetLevel;
+    SmoothedParameter dryLevel;
     double sampleRate;
     
+    ReverbAlgorithm algorithm;
+    FdnReverb fdn;
+
+    static constexpr double SMOOTHING_TIME_SECONDS = 0.05;
+    
 public:
     ReverbEffect();
     
     // Override Effect base class methods
     float processSample(float sample) override;
+    void processBlock(float* const* channels, int numChannels, int numSamples) override;
     void setSampleRate(double sr) override;
     void reset() override;
     void setParameter(int paramId, float value) override;
     bool isActive() const override;
+    int getTailLengthSamples() const override;
+    
+    // Parameter 4; the newly selected algorithm starts from silence
+    void setAlgorithm(ReverbAlgorithm newAlgorithm);
+    ReverbAlgorithm getAlgorithm() const { return algorithm; }
 };
\ No newline at end of file
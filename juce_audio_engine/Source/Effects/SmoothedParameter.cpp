@@ -0,0 +1,102 @@
+#include "SmoothedParameter.h"
+#include <algorithm>
+#include <cmath>
+
+SmoothedParameter::SmoothedParameter(float initialValue, SmoothingType smoothingType)
+    : type(smoothingType)
+    , currentValue(initialValue)
+    , targetValue(initialValue)
+    , step(0.0f)
+    , multiplicative(false)
+    , rampLength(0)
+    , stepsRemaining(0)
+{
+}
+
+void SmoothedParameter::reset(double sampleRate, double rampTimeSeconds) {
+    setRampLength(static_cast<int>(std::floor(sampleRate * rampTimeSeconds)));
+    setCurrentAndTargetValue(targetValue);
+}
+
+void SmoothedParameter::setRampLength(int numSamples) {
+    rampLength = std::max(numSamples, 0);
+}
+
+void SmoothedParameter::setTargetValue(float value) {
+    if (value == targetValue && stepsRemaining > 0) return;
+
+    targetValue = value;
+    if (rampLength == 0 || value == currentValue) {
+        setCurrentAndTargetValue(value);
+        return;
+    }
+
+    // A multiplicative ramp cannot cross or touch zero; fall back to linear
+    multiplicative = type == SmoothingType::EXPONENTIAL && currentValue > 0.0f && targetValue > 0.0f;
+    if (multiplicative) {
+        step = std::exp((std::log(targetValue) - std::log(currentValue)) / static_cast<float>(rampLength));
+    } else {
+        step = (targetValue - currentValue) / static_cast<float>(rampLength);
+    }
+    stepsRemaining = rampLength;
+}
+
+void SmoothedParameter::setCurrentAndTargetValue(float value) {
+    currentValue = value;
+    targetValue = value;
+    stepsRemaining = 0;
+}
+
+float SmoothedParameter::getNextValue() {
+    if (stepsRemaining == 0) return targetValue;
+
+    if (--stepsRemaining == 0) {
+        currentValue = targetValue;
+    } else if (multiplicative) {
+        currentValue *= step;
+    } else {
+        currentValue += step;
+    }
+    return currentValue;
+}
+
+void SmoothedParameter::fillBlock(float* destination, int numSamples) {
+    int rampSamples = std::min(numSamples, stepsRemaining);
+
+    if (multiplicative) {
+        float value = currentValue;
+        for (int i = 0; i < rampSamples; ++i) {
+            value *= step;
+            destination[i] = value;
+        }
+    } else {
+        // Closed form so the loop has no carried dependency and vectorizes
+        float start = currentValue;
+        float increment = step;
+        for (int i = 0; i < rampSamples; ++i) {
+            destination[i] = start + increment * static_cast<float>(i + 1);
+        }
+    }
+
+    skip(rampSamples);
+    if (rampSamples > 0) {
+        destination[rampSamples - 1] = currentValue;
+    }
+    std::fill(destination + rampSamples, destination + numSamples, targetValue);
+}
+
+float SmoothedParameter::skip(int numSamples) {
+    if (numSamples >= stepsRemaining) {
+        currentValue = targetValue;
+        stepsRemaining = 0;
+        return currentValue;
+    }
+
+    if (multiplicative) {
+        currentValue *= std::pow(step, static_cast<float>(numSamples));
+    } else {
+        currentValue += step * static_cast<float>(numSamples);
+    }
+    stepsRemaining -= numSamples;
+    return currentValue;
+}
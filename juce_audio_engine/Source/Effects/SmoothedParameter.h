@@ -0,0 +1,43 @@
+#pragma once
+
+enum class SmoothingType {
+    LINEAR,         // Constant step per sample - levels, mix amounts
+    EXPONENTIAL     // Constant ratio per sample - frequencies (values must stay positive)
+};
+
+// Parameter value that glides to a new target instead of jumping to it.
+// Setters only move the target, so control changes can arrive at block rate
+// (or slower) without zipper noise. Values are read one sample at a time with
+// getNextValue(), or a whole block at once with fillBlock() which writes the
+// ramp into a plain float array for vectorized consumers.
+class SmoothedParameter {
+public:
+    explicit SmoothedParameter(float initialValue = 0.0f, SmoothingType type = SmoothingType::LINEAR);
+
+    // Sets the ramp length and jumps straight to the current target
+    void reset(double sampleRate, double rampTimeSeconds);
+    void setRampLength(int numSamples);
+
+    void setTargetValue(float value);
+    void setCurrentAndTargetValue(float value);
+
+    float getNextValue();
+    float getCurrentValue() const { return currentValue; }
+    float getTargetValue() const { return targetValue; }
+    bool isSmoothing() const { return stepsRemaining > 0; }
+
+    // Writes the next numSamples values into destination and advances the ramp
+    void fillBlock(float* destination, int numSamples);
+
+    // Advances the ramp without producing values; returns the new current value
+    float skip(int numSamples);
+
+private:
+    SmoothingType type;
+    float currentValue;
+    float targetValue;
+    float step;             // Added (LINEAR) or multiplied (EXPONENTIAL) per sample
+    bool multiplicative;    // EXPONENTIAL with both ends positive
+    int rampLength;
+    int stepsRemaining;
+};
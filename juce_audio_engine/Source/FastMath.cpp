@@ -0,0 +1,73 @@
+#include "FastMath.h"
+#include "FastMathKernel.h"
+#include <juce_core/juce_core.h>
+
+#if SYNTH_HAS_AVX2_KERNEL
+// Defined in FastMathAVX2.cpp, which is compiled with AVX2 enabled
+FastMathBlockKernels getFastMathKernelsAVX2();
+#endif
+
+namespace {
+    FastMathBlockKernels selectKernels() {
+        // Pick the widest kernel this CPU can run
+#if SYNTH_HAS_AVX2_KERNEL
+        if (juce::SystemStats::hasAVX2()) {
+            return getFastMathKernelsAVX2();
+        }
+#endif
+#if SYNTH_SIMD_NEON
+        return makeFastMathKernels<NEONLanes>("NEON");
+#elif SYNTH_SIMD_SSE2
+        return makeFastMathKernels<SSE2Lanes>("SSE2");
+#else
+        return makeFastMathKernels<ScalarLanes>("Scalar");
+#endif
+    }
+
+    const FastMathBlockKernels& getKernels() {
+        static const FastMathBlockKernels kernels = selectKernels();
+        return kernels;
+    }
+}
+
+namespace FastMath {
+    float sin2Pi(float turns) {
+        return sin2PiLanes(ScalarLanes::set(turns)).v;
+    }
+
+    float cos2Pi(float turns) {
+        return sin2PiLanes(ScalarLanes::set(turns + 0.25f)).v;
+    }
+
+    float exp2(float x) {
+        return exp2Lanes(ScalarLanes::set(x)).v;
+    }
+
+    float log2(float x) {
+        return log2Lanes(ScalarLanes::set(x)).v;
+    }
+
+    float tanh(float x) {
+        return tanhLanes(ScalarLanes::set(x)).v;
+    }
+
+    void sin2Pi(const float* input, float* output, int numSamples) {
+        getKernels().sin2Pi(input, output, numSamples);
+    }
+
+    void exp2(const float* input, float* output, int numSamples) {
+        getKernels().exp2(input, output, numSamples);
+    }
+
+    void log2(const float* input, float* output, int numSamples) {
+        getKernels().log2(input, output, numSamples);
+    }
+
+    void tanh(const float* input, float* output, int numSamples) {
+        getKernels().tanh(input, output, numSamples);
+    }
+
+    const char* getInstructionSetName() {
+        return getKernels().name;
+    }
+}
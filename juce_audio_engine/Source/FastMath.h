@@ -0,0 +1,31 @@
+#pragma once
+
+// Polynomial approximations of the libm functions the audio paths call per
+// sample. The scalar forms suit per-note and per-block work; the block forms
+// run on the widest kernel this CPU supports (AVX2, SSE2 or NEON, picked at
+// runtime like the voice renderer's) and fall back to scalar code elsewhere.
+//
+// Worst-case errors, checked by the tests:
+//   sin2Pi, cos2Pi   |turns| < 2^23             absolute 4e-6
+//   exp2             [-126, 126] (clamped)      relative 2e-7
+//   log2             [0.5, 2]                   absolute 2e-7
+//                    other positive normals     relative 2e-7
+//   tanh             any finite input           absolute 2e-7
+// log2 of zero, negative or denormal input returns log2 of the smallest
+// normal float (-126).
+namespace FastMath {
+    float sin2Pi(float turns);      // sin(2 * pi * turns)
+    float cos2Pi(float turns);      // cos(2 * pi * turns)
+    float exp2(float x);
+    float log2(float x);
+    float tanh(float x);
+
+    // Block forms; output may be the same buffer as input
+    void sin2Pi(const float* input, float* output, int numSamples);
+    void exp2(const float* input, float* output, int numSamples);
+    void log2(const float* input, float* output, int numSamples);
+    void tanh(const float* input, float* output, int numSamples);
+
+    // Name of the block kernel in use ("AVX2", "SSE2", "NEON" or "Scalar")
+    const char* getInstructionSetName();
+}
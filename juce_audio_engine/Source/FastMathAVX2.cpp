@@ -0,0 +1,9 @@
+// AVX2 build of the FastMath block kernels. This file is compiled with AVX2
+// code generation and is only called after a runtime CPU check.
+#include "FastMathKernel.h"
+
+#if SYNTH_SIMD_AVX2
+FastMathBlockKernels getFastMathKernelsAVX2() {
+    return makeFastMathKernels<AVX2Lanes>("AVX2");
+}
+#endif
@@ -0,0 +1,119 @@
+#pragma once
+#include "SimdLanes.h"
+
+// Lane-generic approximations behind FastMath, shared by the per-ISA
+// translation units and by the voice kernel. See FastMath.h for the error
+// bounds.
+
+// Block entry points of one FastMath build (output may alias input)
+struct FastMathBlockKernels {
+    using Function = void (*)(const float* input, float* output, int numSamples);
+    Function sin2Pi;
+    Function exp2;
+    Function log2;
+    Function tanh;
+    const char* name;
+};
+
+namespace {
+
+// sin(2*pi*p) for phases already wrapped to [0, 1)
+template <typename V>
+inline V sineLanes(V phase) {
+    // sin(2*pi*p) = -sin(2*pi*x) with x = p - 0.5 in [-0.5, 0.5),
+    // folded into [-0.25, 0.25] where an odd polynomial is accurate to ~4e-6
+    V x = phase - V::set(0.5f);
+    x = V::select(V::lessThan(V::set(0.25f), x), V::set(0.5f) - x, x);
+    x = V::select(V::lessThan(x, V::set(-0.25f)), V::set(-0.5f) - x, x);
+
+    V z = x * V::set(2.0f * static_cast<float>(M_PI));
+    V z2 = z * z;
+    V poly = V::set(1.0f / 362880.0f);
+    poly = poly * z2 + V::set(-1.0f / 5040.0f);
+    poly = poly * z2 + V::set(1.0f / 120.0f);
+    poly = poly * z2 + V::set(-1.0f / 6.0f);
+    poly = poly * z2 + V::set(1.0f);
+    return V::set(0.0f) - z * poly;
+}
+
+// sin(2*pi*turns) for any turns within int range
+template <typename V>
+inline V sin2PiLanes(V turns) {
+    return sineLanes(turns - V::floor(turns));
+}
+
+template <typename V>
+inline V exp2Lanes(V x) {
+    // 2^x = 2^n * 2^f with n the nearest integer and f in [-0.5, 0.5]; 2^n is
+    // written straight into the exponent bits, 2^f is a degree-6 polynomial
+    x = V::min(V::max(x, V::set(-126.0f)), V::set(126.0f));
+    V whole = V::floor(x + V::set(0.5f));
+    V f = x - whole;
+
+    V poly = V::set(1.535336188319500e-4f);
+    poly = poly * f + V::set(1.339887440266574e-3f);
+    poly = poly * f + V::set(9.618437357674640e-3f);
+    poly = poly * f + V::set(5.550332471162809e-2f);
+    poly = poly * f + V::set(2.402264791363012e-1f);
+    poly = poly * f + V::set(6.931472028550421e-1f);
+    return (V::set(1.0f) + f * poly) * V::pow2(whole);
+}
+
+template <typename V>
+inline V log2Lanes(V x) {
+    // log2(m * 2^e) = e + log2(m), with the mantissa m moved into
+    // [sqrt(0.5), sqrt(2)) so ln(m) is a short polynomial in m - 1.
+    // Zero, negative and denormal inputs are clamped to the smallest normal.
+    V exponent = V::set(0.0f);
+    V m = V::splitExponent(V::max(x, V::set(1.17549435e-38f)), exponent);
+    auto high = V::lessThan(V::set(1.41421356f), m);
+    m = V::select(high, m * V::set(0.5f), m);
+    exponent = V::select(high, exponent + V::set(1.0f), exponent);
+
+    V t = m - V::set(1.0f);
+    V t2 = t * t;
+    V poly = V::set(7.0376836292e-2f);
+    poly = poly * t + V::set(-1.1514610310e-1f);
+    poly = poly * t + V::set(1.1676998740e-1f);
+    poly = poly * t + V::set(-1.2420140846e-1f);
+    poly = poly * t + V::set(1.4249322787e-1f);
+    poly = poly * t + V::set(-1.6668057665e-1f);
+    poly = poly * t + V::set(2.0000714765e-1f);
+    poly = poly * t + V::set(-2.4999993993e-1f);
+    poly = poly * t + V::set(3.3333331174e-1f);
+    V ln = t + t * t2 * poly - V::set(0.5f) * t2;
+    return ln * V::set(1.44269504f) + exponent;
+}
+
+template <typename V>
+inline V tanhLanes(V x) {
+    // (e - 1) / (e + 1) with e = exp(2x); past |x| = 9 tanh is 1 in float
+    x = V::min(V::max(x, V::set(-9.0f)), V::set(9.0f));
+    V e = exp2Lanes(x * V::set(2.0f * 1.44269504f));
+    return (e - V::set(1.0f)) / (e + V::set(1.0f));
+}
+
+struct Sin2PiOperation { template <typename V> static V apply(V x) { return sin2PiLanes(x); } };
+struct Exp2Operation { template <typename V> static V apply(V x) { return exp2Lanes(x); } };
+struct Log2Operation { template <typename V> static V apply(V x) { return log2Lanes(x); } };
+struct TanhOperation { template <typename V> static V apply(V x) { return tanhLanes(x); } };
+
+// Whole lane groups first, then the remainder one sample at a time
+template <typename V, typename Operation>
+void applyLanes(const float* input, float* output, int numSamples) {
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width) {
+        Operation::apply(V::loadUnaligned(input + i)).storeUnaligned(output + i);
+    }
+    for (; i < numSamples; ++i) {
+        output[i] = Operation::apply(ScalarLanes::set(input[i])).v;
+    }
+}
+
+template <typename V>
+FastMathBlockKernels makeFastMathKernels(const char* name) {
+    return { &applyLanes<V, Sin2PiOperation>, &applyLanes<V, Exp2Operation>,
+             &applyLanes<V, Log2Operation>, &applyLanes<V, TanhOperation>, name };
+}
+
+} // namespace
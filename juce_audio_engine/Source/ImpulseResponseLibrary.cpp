@@ -0,0 +1,56 @@
+#include "ImpulseResponseLibrary.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <vector>
+
+std::mutex& ImpulseResponseLibrary::getMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<juce::String, std::weak_ptr<const ImpulseResponse>>& ImpulseResponseLibrary::getLoaded() {
+    static std::map<juce::String, std::weak_ptr<const ImpulseResponse>> loaded;
+    return loaded;
+}
+
+std::shared_ptr<const ImpulseResponse> ImpulseResponseLibrary::load(const juce::File& file) {
+    if (!file.existsAsFile()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(getMutex());
+    auto& loaded = getLoaded();
+    juce::String key = file.getFullPathName();
+    auto existing = loaded.find(key);
+    if (existing != loaded.end()) {
+        if (auto impulseResponse = existing->second.lock()) {
+            return impulseResponse;
+        }
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0) {
+        return nullptr;
+    }
+
+    int numChannels = std::min(static_cast<int>(reader->numChannels), MAX_CHANNELS);
+    int maxLength = static_cast<int>(reader->sampleRate * MAX_LENGTH_SECONDS);
+    int length = static_cast<int>(std::min<juce::int64>(reader->lengthInSamples, maxLength));
+
+    juce::AudioBuffer<float> buffer(numChannels, length);
+    if (!reader->read(&buffer, 0, length, 0, true, numChannels > 1)) {
+        return nullptr;
+    }
+
+    std::vector<std::vector<float>> channels(numChannels);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const float* samples = buffer.getReadPointer(channel);
+        channels[channel].assign(samples, samples + length);
+    }
+
+    auto impulseResponse = std::make_shared<const ImpulseResponse>(std::move(channels), reader->sampleRate);
+    loaded[key] = impulseResponse;
+    return impulseResponse;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "Effects/ConvolutionKernel.h"
+
+// Decodes impulse responses from audio files (WAV, AIFF, ...) and shares
+// them process-wide: every engine loading the same file gets the same
+// ImpulseResponse, and through it the same partitioned kernels, for as long
+// as any of them still holds it.
+class ImpulseResponseLibrary {
+public:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr double MAX_LENGTH_SECONDS = 10.0;
+
+    // nullptr if the file is missing or cannot be decoded. Reads the file on
+    // the calling thread - never call it from the audio thread.
+    static std::shared_ptr<const ImpulseResponse> load(const juce::File& file);
+
+private:
+    static std::mutex& getMutex();
+    static std::map<juce::String, std::weak_ptr<const ImpulseResponse>>& getLoaded();
+};
@@ -0,0 +1,142 @@
+#include "Logger.h"
+#include <cstdio>
+
+Logger& Logger::getInstance() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::Logger()
+    : queue(QUEUE_CAPACITY), level(LogLevel::INFO), droppedCount(0), reportedDropCount(0),
+      startTime(std::chrono::steady_clock::now()), stopping(false) {
+    flusher = std::thread(&Logger::flusherLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeFlusher.notify_one();
+    flusher.join();
+    flush();
+}
+
+void Logger::verbose(const char* category, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    getInstance().logArguments(LogLevel::VERBOSE, category, format, arguments);
+    va_end(arguments);
+}
+
+void Logger::info(const char* category, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    getInstance().logArguments(LogLevel::INFO, category, format, arguments);
+    va_end(arguments);
+}
+
+void Logger::warning(const char* category, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    getInstance().logArguments(LogLevel::WARNING, category, format, arguments);
+    va_end(arguments);
+}
+
+void Logger::severe(const char* category, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    getInstance().logArguments(LogLevel::SEVERE, category, format, arguments);
+    va_end(arguments);
+}
+
+void Logger::log(LogLevel messageLevel, const char* category, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    logArguments(messageLevel, category, format, arguments);
+    va_end(arguments);
+}
+
+void Logger::logArguments(LogLevel messageLevel, const char* category, const char* format, va_list arguments) {
+    if (!isEnabled(messageLevel)) return;
+
+    // Format on the caller's stack; the ring only ever copies the finished record
+    LogRecord record;
+    record.level = messageLevel;
+    record.category = category;
+    record.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    std::vsnprintf(record.message, sizeof(record.message), format, arguments);
+
+    if (!queue.push(record)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::setSink(Sink newSink) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sink = std::move(newSink);
+}
+
+void Logger::flush() {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    drain();
+}
+
+const char* Logger::getLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::VERBOSE: return "VERBOSE";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::SEVERE: return "SEVERE";
+        case LogLevel::OFF: break;
+    }
+    return "OFF";
+}
+
+void Logger::flusherLoop() {
+    std::unique_lock<std::mutex> wakeLock(wakeMutex);
+    while (!stopping) {
+        // Producers never signal; the flusher polls so logging never blocks
+        wakeFlusher.wait_for(wakeLock, FLUSH_INTERVAL, [this] { return stopping; });
+        wakeLock.unlock();
+        flush();
+        wakeLock.lock();
+    }
+}
+
+void Logger::drain() {
+    auto output = [this](const LogRecord& record) {
+        if (sink) sink(record);
+        else writeToStdout(record);
+    };
+    LogRecord record;
+    bool wroteAny = false;
+    while (queue.pop(record)) {
+        output(record);
+        wroteAny = true;
+    }
+
+    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped != reportedDropCount) {
+        LogRecord notice;
+        notice.level = LogLevel::WARNING;
+        notice.category = "logger";
+        notice.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        std::snprintf(notice.message, sizeof(notice.message), "%llu messages dropped (log queue full)",
+                      static_cast<unsigned long long>(dropped - reportedDropCount));
+        reportedDropCount = dropped;
+        output(notice);
+        wroteAny = true;
+    }
+
+    if (wroteAny && !sink) {
+        std::fflush(stdout);
+    }
+}
+
+void Logger::writeToStdout(const LogRecord& record) {
+    std::printf("[%12.6f] %-7s %s: %s\n", static_cast<double>(record.nanoseconds) * 1.0e-9,
+                getLevelName(record.level), record.category, record.message);
+}
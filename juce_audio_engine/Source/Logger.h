@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "MpscQueue.h"
+
+// Exported like SynthEngine so the FFI bridges can log through the same instance
+#ifndef SYNTH_API
+    #ifdef _WIN32
+        #ifdef JUCE_DLL_BUILD
+            #define SYNTH_API __declspec(dllexport)
+        #else
+            #define SYNTH_API __declspec(dllimport)
+        #endif
+    #else
+        #define SYNTH_API
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define SYNTH_PRINTF_FORMAT(formatIndex, firstArgument) __attribute__((format(printf, formatIndex, firstArgument)))
+#else
+    #define SYNTH_PRINTF_FORMAT(formatIndex, firstArgument)
+#endif
+
+// Ordered by severity; messages below the logger's level are skipped before
+// any formatting is done
+enum class LogLevel {
+    VERBOSE = 0,    // Per-note and per-toggle chatter
+    INFO = 1,       // Device and lifecycle events
+    WARNING = 2,    // Requests that were ignored or dropped
+    SEVERE = 3,     // Failures
+    OFF = 4
+};
+
+// One fixed-size log entry, formatted by the caller and printed later
+struct LogRecord {
+    static constexpr int MAX_MESSAGE_LENGTH = 224;
+
+    LogLevel level;
+    const char* category;           // String literal naming the subsystem
+    int64_t nanoseconds;            // Since the logger started
+    char message[MAX_MESSAGE_LENGTH];   // Truncated to fit, always terminated
+};
+
+// Process-wide logger that is safe to call from the control and audio threads.
+// Callers format into a LogRecord on their own stack and push it into a
+// lock-free ring; a background thread drains the ring every few milliseconds
+// and hands records to the sink (stdout unless replaced). Nothing on the
+// calling side locks, allocates or makes a syscall. When the ring is full the
+// record is dropped and counted, and the flusher reports how many were lost.
+class SYNTH_API Logger {
+public:
+    using Sink = std::function<void(const LogRecord&)>;
+
+    static constexpr int QUEUE_CAPACITY = 1024;
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL { 10 };
+
+    static Logger& getInstance();
+
+    // Shorthands for getInstance().log(level, ...)
+    static void verbose(const char* category, const char* format, ...) SYNTH_PRINTF_FORMAT(2, 3);
+    static void info(const char* category, const char* format, ...) SYNTH_PRINTF_FORMAT(2, 3);
+    static void warning(const char* category, const char* format, ...) SYNTH_PRINTF_FORMAT(2, 3);
+    static void severe(const char* category, const char* format, ...) SYNTH_PRINTF_FORMAT(2, 3);
+
+    void log(LogLevel level, const char* category, const char* format, ...) SYNTH_PRINTF_FORMAT(4, 5);
+
+    // Runtime level; INFO by default
+    void setLevel(LogLevel newLevel) { level.store(newLevel, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return level.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel messageLevel) const {
+        return messageLevel != LogLevel::OFF && messageLevel >= getLevel();
+    }
+
+    // Replaces where records go; an empty sink restores stdout.
+    // Control thread only - waits for any flush in progress.
+    void setSink(Sink newSink);
+
+    // Writes out everything queued so far before returning. Control thread only.
+    void flush();
+
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    static const char* getLevelName(LogLevel level);
+
+private:
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void logArguments(LogLevel level, const char* category, const char* format, va_list arguments);
+    void flusherLoop();
+    void drain();       // Call with sinkMutex held
+    static void writeToStdout(const LogRecord& record);
+
+    MpscQueue<LogRecord> queue;
+    std::atomic<LogLevel> level;
+    std::atomic<uint64_t> droppedCount;
+    uint64_t reportedDropCount;
+    std::chrono::steady_clock::time_point startTime;
+
+    // Held by whoever is draining the queue (flusher thread or flush())
+    std::mutex sinkMutex;
+    Sink sink;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeFlusher;
+    bool stopping;
+    std::thread flusher;
+};
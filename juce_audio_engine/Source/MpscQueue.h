@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Lock-free multi-producer / single-consumer ring buffer (a bounded queue in
+// the style of Dmitry Vyukov's). Each slot carries a sequence number telling
+// producers when it is free and the consumer when it has been written, so
+// producers only contend on one compare-and-swap and never block or allocate.
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t minimumCapacity) {
+        size_t capacity = 1;
+        while (capacity < minimumCapacity) {
+            capacity <<= 1;
+        }
+        cells.reset(new Cell[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = capacity - 1;
+    }
+
+    // Any thread - returns false (and drops the item) when the queue is full
+    bool push(const T& item) {
+        size_t position = head.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                // Slot is free for this lap; claim it
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // Slot still holds an item from the previous lap
+                return false;
+            } else {
+                // Another producer claimed it first
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only - returns false when there is nothing to read
+    bool pop(T& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Cell& cell = cells[position & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        item = cell.item;
+        // Hand the slot back to producers for the next lap
+        cell.sequence.store(position + mask + 1, std::memory_order_release);
+        tail.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t getCapacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
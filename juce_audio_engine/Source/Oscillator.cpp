@@ -1,10 +1,13 @@
 #include "Oscillator.h"
+#include "Wavetable.h"
+#include "FastMath.h"
+#include "Effects/Denormals.h"
 #include <algorithm>
 
 //Oscillator Implementation
 
 Oscillator::Oscillator() 
-    : frequency(440.0f), phase(0.0f), waveform(WaveformType::SINE) {
+    : frequency(440.0f), phase(0.0f), waveform(WaveformType::SINE), mode(OscillatorMode::ANALYTIC) {
 }
 
 void Oscillator::setFrequency(float freq) {
@@ -15,15 +18,20 @@ void Oscillator::setWaveform(WaveformType type) {
     waveform = type;
 }
 
+void Oscillator::setMode(OscillatorMode newMode) {
+    mode = newMode;
+}
+
 void Oscillator::reset() {
     phase = 0.0f;
 }
 
 float Oscillator::generateSample(double sampleRate) {
-    float sample = generateWaveform(phase);
+    float increment = static_cast<float>(frequency / sampleRate);
+    float sample = (mode == OscillatorMode::ANALYTIC) ? generateWaveform(phase) : generateWavetable(phase, increment);
     
     // Update phase for next sample
-    phase += frequency / sampleRate;
+    phase += increment;
     
     // Wrap phase to prevent overflow
     if (phase >= 1.0f) {
@@ -33,13 +41,101 @@ float Oscillator::generateSample(double sampleRate) {
     return sample;
 }
 
+void Oscillator::renderBlock(float* output, int numSamples, double sampleRate) {
+    float increment = static_cast<float>(frequency / sampleRate);
+    
+    // Phase is computed directly per sample so each loop below is branch-free
+    // and can be auto-vectorized
+    advancePhases(output, numSamples, increment);
+    
+    if (mode != OscillatorMode::ANALYTIC) {
+        renderWavetable(output, numSamples, increment);
+        return;
+    }
+    
+    switch (waveform) {
+        case WaveformType::SINE:
+            FastMath::sin2Pi(output, output, numSamples);
+            break;
+            
+        case WaveformType::SQUARE:
+            // Same sign as the sine: positive for the first half of the cycle
+            for (int i = 0; i < numSamples; ++i) {
+                output[i] = (output[i] < 0.5f) ? 1.0f : -1.0f;
+            }
+            break;
+            
+        case WaveformType::SAW:
+            // Phases are already wrapped to [0, 1), so floor(p + 0.5) is a compare
+            for (int i = 0; i < numSamples; ++i) {
+                float p = output[i];
+                output[i] = 2.0f * p - ((p >= 0.5f) ? 2.0f : 0.0f);
+            }
+            break;
+            
+        case WaveformType::TRIANGLE:
+            for (int i = 0; i < numSamples; ++i) {
+                float p = output[i];
+                output[i] = (p < 0.5f) ? (4.0f * p - 1.0f) : (3.0f - 4.0f * p);
+            }
+            break;
+            
+        default:
+            std::fill(output, output + numSamples, 0.0f);
+            break;
+    }
+}
+
+void Oscillator::renderWavetable(float* output, int numSamples, float increment) {
+    // Mip levels depend only on the increment, so they are chosen once per block
+    WavetableBank::LevelBlend blend = WavetableBank::getShared().selectLevels(waveform, increment);
+    float lowerWeight = 1.0f - blend.upperWeight;
+    
+    if (mode == OscillatorMode::WAVETABLE_CUBIC) {
+        for (int i = 0; i < numSamples; ++i) {
+            float p = output[i];
+            output[i] = WavetableBank::readCubic(blend.lower, p) * lowerWeight
+                      + WavetableBank::readCubic(blend.upper, p) * blend.upperWeight;
+        }
+    } else {
+        for (int i = 0; i < numSamples; ++i) {
+            float p = output[i];
+            output[i] = WavetableBank::readLinear(blend.lower, p) * lowerWeight
+                      + WavetableBank::readLinear(blend.upper, p) * blend.upperWeight;
+        }
+    }
+}
+
+float Oscillator::generateWavetable(float phase, float increment) {
+    WavetableBank::LevelBlend blend = WavetableBank::getShared().selectLevels(waveform, increment);
+    
+    if (mode == OscillatorMode::WAVETABLE_CUBIC) {
+        return WavetableBank::readCubic(blend.lower, phase) * (1.0f - blend.upperWeight)
+             + WavetableBank::readCubic(blend.upper, phase) * blend.upperWeight;
+    }
+    return WavetableBank::readLinear(blend.lower, phase) * (1.0f - blend.upperWeight)
+         + WavetableBank::readLinear(blend.upper, phase) * blend.upperWeight;
+}
+
+void Oscillator::advancePhases(float* phases, int numSamples, float increment) {
+    // Phase is never negative, so truncation is equivalent to floor and vectorizes
+    for (int i = 0; i < numSamples; ++i) {
+        float p = phase + static_cast<float>(i) * increment;
+        phases[i] = p - static_cast<float>(static_cast<int>(p));
+    }
+    
+    // Keep the running phase wrapped to prevent overflow
+    float next = phase + static_cast<float>(numSamples) * increment;
+    phase = next - std::floor(next);
+}
+
 float Oscillator::generateWaveform(float phase) {
     switch (waveform) {
         case WaveformType::SINE:
-            return std::sin(phase * 2.0f * M_PI);
+            return FastMath::sin2Pi(phase);
             
         case WaveformType::SQUARE:
-            return (std::sin(phase * 2.0f * M_PI) >= 0.0f) ? 1.0f : -1.0f;
+            return (FastMath::sin2Pi(phase) >= 0.0f) ? 1.0f : -1.0f;
             
         case WaveformType::SAW:
             return 2.0f * (phase - std::floor(phase + 0.5f));
@@ -57,12 +153,18 @@ float Oscillator::generateWaveform(float phase) {
 //DualOscVoice Implementation
 
 DualOscVoice::DualOscVoice() 
-    : velocity(0.0f), detune(0.0f), mix(0.5f), active(false) {
+    : velocity(0.0f), detune(0.0f), mix(0.5f), panLeft(1.0f), panRight(1.0f), active(false),
+    filterEnabled(false), filterState1(0.0f), filterState2(0.0f),
+    filterVersion(0), filterSampleRate(0.0), filterNeedsUpdate(true) {
+    mix.setRampLength(MIX_RAMP_SAMPLES);
 }
 
 void DualOscVoice::noteOn(float frequency, float vel) {
     velocity = vel; // Revert back to normal velocity
     active = true;
+
+    // A new note starts at the current setting rather than mid-glide
+    mix.setCurrentAndTargetValue(mix.getTargetValue());
     
     // Set base frequency for oscillator 1
     osc1.setFrequency(frequency);
@@ -74,6 +176,11 @@ void DualOscVoice::noteOn(float frequency, float vel) {
     // Reset phases for clean note start
     osc1.reset();
     osc2.reset();
+
+    // Fresh filter state; the cutoff depends on this note's pitch and velocity
+    filterState1 = 0.0f;
+    filterState2 = 0.0f;
+    filterNeedsUpdate = true;
 }
 
 void DualOscVoice::noteOff() {
@@ -89,10 +196,109 @@ float DualOscVoice::generateSample(double sampleRate) {
     float sample2 = osc2.generateSample(sampleRate);
     
     // Mix the oscillators
-    float mixedSample = (sample1 * (1.0f - mix)) + (sample2 * mix);
+    float currentMix = mix.getNextValue();
+    float mixedSample = (sample1 * (1.0f - currentMix)) + (sample2 * currentMix);
     
     // Apply velocity
-    return mixedSample * velocity;
+    mixedSample *= velocity;
+    
+    if (filterEnabled) {
+        applyFilter(&mixedSample, 1);
+    }
+    return mixedSample;
+}
+
+void DualOscVoice::renderBlock(float* left, float* right, int numSamples, double sampleRate) {
+    if (!active) return;
+    
+    float buffer1[RENDER_CHUNK_SIZE];
+    float buffer2[RENDER_CHUNK_SIZE];
+    float mixRamp[RENDER_CHUNK_SIZE];
+    float voiceOut[RENDER_CHUNK_SIZE];
+    
+    for (int start = 0; start < numSamples; start += RENDER_CHUNK_SIZE) {
+        int chunkSize = std::min(RENDER_CHUNK_SIZE, numSamples - start);
+        
+        osc1.renderBlock(buffer1, chunkSize, sampleRate);
+        osc2.renderBlock(buffer2, chunkSize, sampleRate);
+        
+        // Mix the oscillators and apply velocity
+        if (mix.isSmoothing()) {
+            mix.fillBlock(mixRamp, chunkSize);
+            for (int i = 0; i < chunkSize; ++i) {
+                voiceOut[i] = (buffer1[i] + (buffer2[i] - buffer1[i]) * mixRamp[i]) * velocity;
+            }
+        } else {
+            float osc1Gain = (1.0f - mix.getTargetValue()) * velocity;
+            float osc2Gain = mix.getTargetValue() * velocity;
+            for (int i = 0; i < chunkSize; ++i) {
+                voiceOut[i] = buffer1[i] * osc1Gain + buffer2[i] * osc2Gain;
+            }
+        }
+        
+        if (filterEnabled) {
+            applyFilter(voiceOut, chunkSize);
+        }
+        
+        float* outLeft = left + start;
+        float* outRight = right + start;
+        for (int i = 0; i < chunkSize; ++i) {
+            outLeft[i] += voiceOut[i] * panLeft;
+            outRight[i] += voiceOut[i] * panRight;
+        }
+    }
+}
+
+void DualOscVoice::updateFilter(const VoiceFilterSettings& settings, double sampleRate) {
+    if (!filterNeedsUpdate && settings.version == filterVersion && sampleRate == filterSampleRate) {
+        return;
+    }
+    filterNeedsUpdate = false;
+    filterVersion = settings.version;
+    filterSampleRate = sampleRate;
+
+    bool wasEnabled = filterEnabled;
+    filterEnabled = settings.enabled;
+    if (!filterEnabled) return;
+    if (!wasEnabled) {
+        filterState1 = 0.0f;
+        filterState2 = 0.0f;
+    }
+
+    // Key tracking relative to middle C, velocity darkening in octaves
+    static constexpr float MIDDLE_C_HZ = 261.63f;
+    static constexpr float VELOCITY_OCTAVES = 4.0f;
+    float octaves = settings.keyTracking * FastMath::log2(osc1.getFrequency() / MIDDLE_C_HZ)
+                  + settings.velocityAmount * VELOCITY_OCTAVES * (velocity - 1.0f);
+    float cutoff = std::max(settings.cutoff * FastMath::exp2(octaves), 20.0f);
+
+    filterCoefficients.update(cutoff, settings.resonance, sampleRate, settings.mode);
+}
+
+void DualOscVoice::applyFilter(float* samples, int numSamples) {
+    // Same TPT state-variable recurrence as StateVariableFilter, one voice at a time
+    const float a1 = filterCoefficients.a1, a2 = filterCoefficients.a2, a3 = filterCoefficients.a3;
+    const float m0 = filterCoefficients.m0, m1 = filterCoefficients.m1, m2 = filterCoefficients.m2;
+    float s1 = filterState1;
+    float s2 = filterState2;
+
+    for (int i = 0; i < numSamples; ++i) {
+        float v0 = samples[i];
+        float v3 = v0 - s2;
+        float v1 = a1 * s1 + a2 * v3;
+        float v2 = s2 + a2 * s1 + a3 * v3;
+        s1 = 2.0f * v1 - s1;
+        s2 = 2.0f * v2 - s2;
+        samples[i] = m0 * v0 + m1 * v1 + m2 * v2;
+    }
+
+    filterState1 = flushDenormal(s1);
+    filterState2 = flushDenormal(s2);
+}
+
+void DualOscVoice::advanceMix(int numSamples, float& startMix, float& endMix) {
+    startMix = mix.getCurrentValue();
+    endMix = mix.skip(numSamples);
 }
 
 void DualOscVoice::setOsc1Waveform(WaveformType type) {
@@ -103,15 +309,27 @@ void DualOscVoice::setOsc2Waveform(WaveformType type) {
     osc2.setWaveform(type);
 }
 
+void DualOscVoice::setOscillatorMode(OscillatorMode mode) {
+    osc1.setMode(mode);
+    osc2.setMode(mode);
+}
+
 void DualOscVoice::setDetune(float cents) {
     detune = std::clamp(cents, -100.0f, 100.0f);
 }
 
 void DualOscVoice::setMix(float mixLevel) {
-    mix = std::clamp(mixLevel, 0.0f, 1.0f);
+    mix.setTargetValue(std::clamp(mixLevel, 0.0f, 1.0f));
+}
+
+void DualOscVoice::setPan(float pan) {
+    // Quarter-circle pan law, sqrt(2) so the centre position is 0 dB
+    float angle = (std::clamp(pan, -1.0f, 1.0f) + 1.0f) * static_cast<float>(M_PI) * 0.25f;
+    panLeft = std::cos(angle) * 1.41421356f;
+    panRight = std::sin(angle) * 1.41421356f;
 }
 
 float DualOscVoice::centsToRatio(float cents) {
     // Convert cents to frequency ratio: 2^(cents/1200)
-    return std::pow(2.0f, cents / 1200.0f);
+    return FastMath::exp2(cents / 1200.0f);
 }
\ No newline at end of file
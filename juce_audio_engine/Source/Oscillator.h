@@ -1,5 +1,7 @@
 #pragma once
 #include <cmath>
+#include "Effects/SmoothedParameter.h"
+#include "Effects/Filter.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -12,21 +14,58 @@ enum class WaveformType {
     TRIANGLE = 3
 };
 
+// How an oscillator turns phase into a waveform
+enum class OscillatorMode {
+    ANALYTIC = 0,           // Direct formulas (naive SAW/SQUARE/TRIANGLE alias)
+    WAVETABLE_LINEAR = 1,   // Band-limited mip-mapped tables, linear interpolation
+    WAVETABLE_CUBIC = 2     // Band-limited mip-mapped tables, cubic interpolation
+};
+
 class Oscillator {
 public:
     Oscillator();
     
     float generateSample(double sampleRate);
+    
+    // Writes numSamples of output, choosing the waveform once per block
+    void renderBlock(float* output, int numSamples, double sampleRate);
+    
     void setFrequency(float freq);
     void setWaveform(WaveformType type);
+    void setMode(OscillatorMode newMode);
     void reset();
     
+    // State access for the SIMD voice renderer
+    float getFrequency() const { return frequency; }
+    WaveformType getWaveform() const { return waveform; }
+    OscillatorMode getMode() const { return mode; }
+    float getPhase() const { return phase; }
+    void setPhase(float newPhase) { phase = newPhase; }
+    
 private:
     float frequency;
     float phase;
     WaveformType waveform;
+    OscillatorMode mode;
     
     float generateWaveform(float phase);
+    float generateWavetable(float phase, float increment);
+    void renderWavetable(float* output, int numSamples, float increment);
+    
+    // Fills phases with the wrapped phase of each sample in the block
+    void advancePhases(float* phases, int numSamples, float increment);
+};
+
+// Shared settings for the per-voice filters. The engine bumps version on every
+// change so each voice only recomputes its coefficients when something moved.
+struct VoiceFilterSettings {
+    bool enabled = false;
+    float cutoff = 1000.0f;         // Hz, for a full-velocity middle C
+    float resonance = 1.0f;         // Q
+    FilterMode mode = FilterMode::LOWPASS;
+    float keyTracking = 0.0f;       // 0 = fixed cutoff, 1 = cutoff follows pitch
+    float velocityAmount = 0.0f;    // 0 - 1, up to 4 octaves darker at low velocity
+    unsigned version = 0;
 };
 
 // Dual oscillator voice for polyphonic synthesis
@@ -34,7 +73,13 @@ class DualOscVoice {
 public:
     DualOscVoice();
     
+    // Mono, velocity-scaled sample before panning
     float generateSample(double sampleRate);
+    
+    // Adds numSamples of mixed, velocity-scaled and panned output into the
+    // left and right buffers
+    void renderBlock(float* left, float* right, int numSamples, double sampleRate);
+    
     void noteOn(float frequency, float velocity);
     void noteOff();
     
@@ -43,15 +88,56 @@ public:
     void setOsc2Waveform(WaveformType type);
     void setDetune(float cents);        // -100 to +100 cents
     void setMix(float mixLevel);        // 0.0 = osc1 only, 1.0 = osc2 only
+    void setOscillatorMode(OscillatorMode mode);
+
+    // Constant-power pan, -1 (left) to +1 (right). Gains are scaled so a
+    // centred voice keeps unity gain on both channels.
+    void setPan(float pan);
+    float getPanLeft() const { return panLeft; }
+    float getPanRight() const { return panRight; }
     
     bool isActive() const { return active; }
+    float getVelocity() const { return velocity; }
+    float getMix() const { return mix.getTargetValue(); }
+
+    // Advances the mix ramp by numSamples, reporting its value before and after
+    void advanceMix(int numSamples, float& startMix, float& endMix);
+    
+    // Direct oscillator access for the SIMD voice renderer
+    Oscillator& getOsc1() { return osc1; }
+    Oscillator& getOsc2() { return osc2; }
+
+    // Per-voice filter: recomputes this voice's coefficients if the settings
+    // (or sample rate) changed since the last call. Call once per block.
+    void updateFilter(const VoiceFilterSettings& settings, double sampleRate);
+    bool isFilterEnabled() const { return filterEnabled; }
+    const SvfCoefficients& getFilterCoefficients() const { return filterCoefficients; }
+    float getFilterState1() const { return filterState1; }
+    float getFilterState2() const { return filterState2; }
+    void setFilterState(float state1, float state2) { filterState1 = state1; filterState2 = state2; }
     
 private:
+    // Scratch size for block rendering - longer blocks are split into chunks
+    static constexpr int RENDER_CHUNK_SIZE = 64;
+
+    // Mix changes glide over this many samples (~10 ms at 48 kHz)
+    static constexpr int MIX_RAMP_SAMPLES = 512;
+    
     Oscillator osc1, osc2;
     float velocity;
     float detune;           // Detune in cents
-    float mix;              // Oscillator mix level
+    SmoothedParameter mix;  // Oscillator mix level
+    float panLeft, panRight;
     bool active;
     
+    // Per-voice filter state and cached coefficients
+    bool filterEnabled;
+    SvfCoefficients filterCoefficients;
+    float filterState1, filterState2;
+    unsigned filterVersion;
+    double filterSampleRate;
+    bool filterNeedsUpdate;
+    
     float centsToRatio(float cents);    // Convert cents to frequency ratio
+    void applyFilter(float* samples, int numSamples);
 };
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "ParallelVoiceRenderer.h"
+#include "Effects/Denormals.h"
+#include <algorithm>
+#include <chrono>
+
+// How long an idle worker spins before parking. A missed wake-up costs at
+// most one park interval, and even then the audio thread steals the worker's
+// tasks in the meantime.
+static constexpr auto WORKER_SPIN_TIME = std::chrono::microseconds(500);
+
+ParallelVoiceRenderer::ParallelVoiceRenderer()
+    : jobVoices(nullptr),
+    jobNumVoices(0),
+    jobNumSamples(0),
+    jobSampleRate(44100.0),
+    jobMode(VoiceRenderMode::SIMD),
+    jobNumTasks(0),
+    jobGeneration(0),
+    jobOpen(false),
+    tasksCompleted(0),
+    workersInJob(0),
+    stopping(false) {
+}
+
+ParallelVoiceRenderer::~ParallelVoiceRenderer() {
+    shutdown();
+}
+
+void ParallelVoiceRenderer::prepare(int numThreads, int maxBlockSize) {
+    shutdown();
+
+    numThreads = std::max(numThreads, 1);
+    participants.clear();
+    for (int i = 0; i < numThreads; ++i) {
+        auto participant = std::make_unique<Participant>();
+        participant->left.assign(maxBlockSize, 0.0f);
+        participant->right.assign(maxBlockSize, 0.0f);
+        participant->simdRenderer = std::make_unique<SimdVoiceRenderer>();
+        participants.push_back(std::move(participant));
+    }
+
+    // Workers match the preparing thread rather than outrank it, so one spinning
+    // between blocks can never preempt the audio callback it serves
+    workerPriority = ThreadPriority::ofCurrentThread();
+
+    stopping = false;
+    for (int i = 0; i < numThreads - 1; ++i) {
+        workers.emplace_back(&ParallelVoiceRenderer::workerLoop, this, i);
+    }
+}
+
+void ParallelVoiceRenderer::shutdown() {
+    if (workers.empty()) return;
+
+    parking.wakeAll([this]() { stopping = true; });
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void ParallelVoiceRenderer::render(DualOscVoice* const* voices, int numVoices, float* left, float* right,
+                                   int numSamples, double sampleRate, VoiceRenderMode mode) {
+    int numParticipants = static_cast<int>(participants.size());
+    int audioThreadIndex = numParticipants - 1;
+
+    // Publish the job: fields first, then the generation with release ordering
+    jobVoices = voices;
+    jobNumVoices = numVoices;
+    jobNumSamples = numSamples;
+    jobSampleRate = sampleRate;
+    jobMode = mode;
+    jobNumTasks = (numVoices + VOICES_PER_TASK - 1) / VOICES_PER_TASK;
+    tasksCompleted.store(0, std::memory_order_relaxed);
+
+    // Contiguous starting range per participant; later ones get the remainder
+    for (int i = 0; i < numParticipants; ++i) {
+        Participant& participant = *participants[i];
+        participant.nextTask.store(jobNumTasks * i / numParticipants, std::memory_order_relaxed);
+        participant.taskEnd = jobNumTasks * (i + 1) / numParticipants;
+        participant.tasksRendered.store(0, std::memory_order_relaxed);
+    }
+
+    // Bump the generation before opening, so a worker still holding the previous
+    // generation can never find the job open and enter it under a stale number
+    jobGeneration.fetch_add(1, std::memory_order_release);
+    jobOpen.store(true);
+
+    // Non-blocking wake for parked workers; spinning workers see the generation
+    parking.wake();
+
+    // The audio thread works too, stealing whatever the workers have not claimed
+    runTasks(audioThreadIndex);
+
+    // Only tasks another thread has already claimed can still be in flight
+    while (tasksCompleted.load(std::memory_order_acquire) < jobNumTasks) {
+        std::this_thread::yield();
+    }
+
+    // Close the job and wait for stragglers to leave before the next publish
+    jobOpen.store(false);
+    while (workersInJob.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    // Reduction: sum each participant's partial mix into the output
+    for (auto& participant : participants) {
+        if (participant->tasksRendered.load(std::memory_order_acquire) == 0) continue;
+
+        const float* partialLeft = participant->left.data();
+        const float* partialRight = participant->right.data();
+        for (int i = 0; i < numSamples; ++i) {
+            left[i] += partialLeft[i];
+            right[i] += partialRight[i];
+        }
+    }
+}
+
+void ParallelVoiceRenderer::workerLoop(int participantIndex) {
+    workerPriority.applyToCurrentThread();
+    // Workers render voices like the audio thread does, so they need its FPU mode too
+    ScopedFlushToZero noDenormals;
+    unsigned lastGeneration = jobGeneration.load(std::memory_order_acquire);
+
+    while (!stopping.load()) {
+        // Spin briefly for the next block, then park
+        parking.waitUntil([&]() {
+            return jobGeneration.load(std::memory_order_acquire) != lastGeneration || stopping.load();
+        }, WORKER_SPIN_TIME);
+
+        if (stopping.load()) break;
+        lastGeneration = jobGeneration.load(std::memory_order_acquire);
+
+        // Enter the job only while it is still open, and at most once: runTasks
+        // clears this participant's buffers, so a second entry would drop the
+        // voices it already rendered. The audio thread waits for workersInJob to
+        // drain before it reuses the job fields.
+        Participant& participant = *participants[participantIndex];
+        workersInJob.fetch_add(1);
+        if (jobOpen.load() && jobGeneration.load(std::memory_order_acquire) == lastGeneration
+            && participant.servedGeneration != lastGeneration) {
+            participant.servedGeneration = lastGeneration;
+            runTasks(participantIndex);
+        }
+        workersInJob.fetch_sub(1);
+    }
+}
+
+void ParallelVoiceRenderer::runTasks(int participantIndex) {
+    Participant& participant = *participants[participantIndex];
+    bool clearFirst = true;
+
+    for (int task = claimTask(participantIndex); task >= 0; task = claimTask(participantIndex)) {
+        renderTask(participant, task, clearFirst);
+        clearFirst = false;
+
+        participant.tasksRendered.fetch_add(1, std::memory_order_release);
+        tasksCompleted.fetch_add(1, std::memory_order_release);
+    }
+}
+
+int ParallelVoiceRenderer::claimTask(int participantIndex) {
+    int numParticipants = static_cast<int>(participants.size());
+
+    // Own range first, then steal from the others in turn
+    for (int offset = 0; offset < numParticipants; ++offset) {
+        Participant& victim = *participants[(participantIndex + offset) % numParticipants];
+        if (victim.nextTask.load(std::memory_order_relaxed) >= victim.taskEnd) continue;
+
+        int task = victim.nextTask.fetch_add(1, std::memory_order_acq_rel);
+        if (task < victim.taskEnd) {
+            return task;
+        }
+    }
+    return -1;
+}
+
+void ParallelVoiceRenderer::renderTask(Participant& participant, int task, bool clearFirst) {
+    float* left = participant.left.data();
+    float* right = participant.right.data();
+    if (clearFirst) {
+        std::fill(left, left + jobNumSamples, 0.0f);
+        std::fill(right, right + jobNumSamples, 0.0f);
+    }
+
+    int firstVoice = task * VOICES_PER_TASK;
+    int numVoices = std::min(VOICES_PER_TASK, jobNumVoices - firstVoice);
+
+    if (jobMode == VoiceRenderMode::SIMD) {
+        participant.simdRenderer->render(jobVoices + firstVoice, numVoices, left, right, jobNumSamples, jobSampleRate);
+    } else {
+        for (int i = 0; i < numVoices; ++i) {
+            jobVoices[firstVoice + i]->renderBlock(left, right, jobNumSamples, jobSampleRate);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "SimdVoiceRenderer.h"
+#include "ThreadPriority.h"
+#include "WorkerParking.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Splits voice rendering across a pool of worker threads.
+//
+// Each block the active voices are cut into small tasks. Every participant
+// (the audio thread plus the workers) starts on its own contiguous range of
+// tasks and steals from the others' ranges once its own is empty, so a slow or
+// late worker never holds the block up - the audio thread simply takes its
+// work. Participants render into private buffers which the audio thread sums
+// before the filter/effects stage.
+//
+// All threads and buffers are created in prepare(). render() only touches
+// atomics; it never allocates, locks or blocks on a worker that has not
+// already claimed a task.
+class ParallelVoiceRenderer {
+public:
+    ParallelVoiceRenderer();
+    ~ParallelVoiceRenderer();
+
+    // Starts numThreads - 1 workers (the audio thread is the last participant)
+    // at the calling thread's scheduling priority. Call from prepareToPlay only.
+    void prepare(int numThreads, int maxBlockSize);
+    void shutdown();
+
+    bool isRunning() const { return !workers.empty(); }
+    int getNumThreads() const { return static_cast<int>(participants.size()); }
+
+    // Adds numSamples of each listed voice into left and right (numSamples <= maxBlockSize)
+    void render(DualOscVoice* const* voices, int numVoices, float* left, float* right,
+                int numSamples, double sampleRate, VoiceRenderMode mode);
+
+    static constexpr int VOICES_PER_TASK = 8;      // One AVX2 lane group
+
+private:
+    // Per-thread render state, padded so task counters do not share cache lines
+    struct alignas(64) Participant {
+        std::vector<float> left;
+        std::vector<float> right;
+        std::unique_ptr<SimdVoiceRenderer> simdRenderer;
+        std::atomic<int> nextTask{0};
+        int taskEnd = 0;
+        std::atomic<int> tasksRendered{0};
+        unsigned servedGeneration = 0;      // Last job this participant's thread entered
+    };
+
+    std::vector<std::unique_ptr<Participant>> participants;
+    std::vector<std::thread> workers;
+    ThreadPriority workerPriority;          // Captured in prepare()
+
+    // Current job, written by the audio thread before jobGeneration is bumped
+    DualOscVoice* const* jobVoices;
+    int jobNumVoices;
+    int jobNumSamples;
+    double jobSampleRate;
+    VoiceRenderMode jobMode;
+    int jobNumTasks;
+
+    std::atomic<unsigned> jobGeneration;
+    std::atomic<bool> jobOpen;
+    std::atomic<int> tasksCompleted;
+    std::atomic<int> workersInJob;
+
+    // Idle workers park here; the audio thread only ever wakes them
+    WorkerParking parking;
+    std::atomic<bool> stopping;
+
+    void workerLoop(int participantIndex);
+    void runTasks(int participantIndex);
+    int claimTask(int participantIndex);
+    void renderTask(Participant& participant, int task, bool clearFirst);
+};
@@ -0,0 +1,138 @@
+#include "PerformanceMonitor.h"
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+PerformanceMonitor::PerformanceMonitor()
+    : blockStart(Clock::now()), blockStageNanoseconds{}, blockActiveVoices(0), blockOverrun(false),
+      sequence(0), resetRequested(false) {
+    clearCounters();
+}
+
+void PerformanceMonitor::beginBlock() {
+    if (resetRequested.exchange(false, std::memory_order_acquire)) {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        clearCounters();
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::fill(std::begin(blockStageNanoseconds), std::end(blockStageNanoseconds), 0);
+    blockActiveVoices = 0;
+    blockOverrun = false;
+    blockStart = Clock::now();
+}
+
+void PerformanceMonitor::endBlock(int numSamples, double sampleRate) {
+    int64_t renderNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - blockStart).count();
+    if (numSamples <= 0 || sampleRate <= 0.0) return;
+
+    double blockNanoseconds = numSamples * 1.0e9 / sampleRate;
+    double load = renderNanoseconds / blockNanoseconds;
+
+    // Readers retry while the sequence is odd or has moved, so they never
+    // see half of a block's update
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    add(blockCount, 1);
+    if (load > 1.0 || blockOverrun) add(overrunCount, 1);
+    totalLoad.store(totalLoad.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+    raise(maxLoad, load);
+    add(totalRenderNanoseconds, static_cast<uint64_t>(renderNanoseconds));
+    raise(maxRenderNanoseconds, static_cast<uint64_t>(renderNanoseconds));
+    add(totalActiveVoices, static_cast<uint64_t>(blockActiveVoices));
+    raise(maxActiveVoices, blockActiveVoices);
+    for (int stage = 0; stage < NUM_PERFORMANCE_STAGES; ++stage) {
+        auto nanoseconds = static_cast<uint64_t>(blockStageNanoseconds[stage]);
+        add(totalStageNanoseconds[stage], nanoseconds);
+        raise(maxStageNanoseconds[stage], nanoseconds);
+    }
+    add(loadHistogram[getLoadBucket(load)], 1);
+
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void PerformanceMonitor::addStageTime(PerformanceStage stage, int64_t nanoseconds) {
+    blockStageNanoseconds[static_cast<int>(stage)] += nanoseconds;
+}
+
+void PerformanceMonitor::noteActiveVoices(int count) {
+    // A block split at scheduled events reports its busiest segment
+    blockActiveVoices = std::max(blockActiveVoices, count);
+}
+
+PerformanceSnapshot PerformanceMonitor::getSnapshot() const {
+    PerformanceSnapshot snapshot {};
+    uint64_t totalRender = 0, totalVoices = 0;
+    uint64_t totalStage[NUM_PERFORMANCE_STAGES];
+    uint64_t maxRender = 0, maxStage[NUM_PERFORMANCE_STAGES];
+    double sumLoad = 0.0;
+
+    while (true) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before % 2 != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        snapshot.blockCount = blockCount.load(std::memory_order_relaxed);
+        snapshot.overrunCount = overrunCount.load(std::memory_order_relaxed);
+        sumLoad = totalLoad.load(std::memory_order_relaxed);
+        snapshot.maxLoad = maxLoad.load(std::memory_order_relaxed);
+        totalRender = totalRenderNanoseconds.load(std::memory_order_relaxed);
+        maxRender = maxRenderNanoseconds.load(std::memory_order_relaxed);
+        totalVoices = totalActiveVoices.load(std::memory_order_relaxed);
+        snapshot.maxActiveVoices = maxActiveVoices.load(std::memory_order_relaxed);
+        for (int stage = 0; stage < NUM_PERFORMANCE_STAGES; ++stage) {
+            totalStage[stage] = totalStageNanoseconds[stage].load(std::memory_order_relaxed);
+            maxStage[stage] = maxStageNanoseconds[stage].load(std::memory_order_relaxed);
+        }
+        for (int bucket = 0; bucket < PerformanceSnapshot::NUM_LOAD_BUCKETS; ++bucket) {
+            snapshot.loadHistogram[bucket] = loadHistogram[bucket].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) break;
+    }
+
+    snapshot.xrunCount = -1;
+    snapshot.maxRenderMicros = maxRender * 1.0e-3;
+    for (int stage = 0; stage < NUM_PERFORMANCE_STAGES; ++stage) {
+        snapshot.maxStageMicros[stage] = maxStage[stage] * 1.0e-3;
+    }
+    if (snapshot.blockCount > 0) {
+        double blocks = static_cast<double>(snapshot.blockCount);
+        snapshot.meanLoad = sumLoad / blocks;
+        snapshot.meanRenderMicros = totalRender * 1.0e-3 / blocks;
+        snapshot.meanActiveVoices = totalVoices / blocks;
+        for (int stage = 0; stage < NUM_PERFORMANCE_STAGES; ++stage) {
+            snapshot.meanStageMicros[stage] = totalStage[stage] * 1.0e-3 / blocks;
+        }
+    }
+    return snapshot;
+}
+
+int PerformanceMonitor::getLoadBucket(double load) {
+    constexpr int LAST = PerformanceSnapshot::NUM_LOAD_BUCKETS - 1;
+    if (!(load < 1.0)) return LAST;
+    return std::clamp(static_cast<int>(load * LAST), 0, LAST - 1);
+}
+
+void PerformanceMonitor::clearCounters() {
+    blockCount.store(0, std::memory_order_relaxed);
+    overrunCount.store(0, std::memory_order_relaxed);
+    totalLoad.store(0.0, std::memory_order_relaxed);
+    maxLoad.store(0.0, std::memory_order_relaxed);
+    totalRenderNanoseconds.store(0, std::memory_order_relaxed);
+    maxRenderNanoseconds.store(0, std::memory_order_relaxed);
+    totalActiveVoices.store(0, std::memory_order_relaxed);
+    maxActiveVoices.store(0, std::memory_order_relaxed);
+    for (int stage = 0; stage < NUM_PERFORMANCE_STAGES; ++stage) {
+        totalStageNanoseconds[stage].store(0, std::memory_order_relaxed);
+        maxStageNanoseconds[stage].store(0, std::memory_order_relaxed);
+    }
+    for (auto& bucket : loadHistogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
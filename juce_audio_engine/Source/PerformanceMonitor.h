@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Parts of the audio callback that are timed separately
+enum class PerformanceStage {
+    VOICES = 0,         // Voice rendering, per-voice filters and voice oversampling
+    FILTER = 1,         // Master filter
+    CHORUS = 2,         // Chorus, delay and reverb only with per-effect timing on
+    DELAY = 3,
+    REVERB = 4,
+    CONVOLUTION = 5,
+    LIMITER = 6,        // Including the limiter's oversampling
+    INSERT_EFFECTS = 7  // The whole insert chain, when per-effect timing is off
+};
+
+static constexpr int NUM_PERFORMANCE_STAGES = 8;
+
+// Consistent copy of the audio callback counters since the last reset.
+// Load is a block's render time divided by its duration at the output rate;
+// above 1.0 the block took longer to render than to play.
+struct PerformanceSnapshot {
+    static constexpr int NUM_LOAD_BUCKETS = 21;     // 5% wide; the last holds every load >= 100%
+
+    uint64_t blockCount;
+    uint64_t overrunCount;          // Blocks with load above 1.0, or that dropped late work
+    int xrunCount;                  // Reported by the audio device; -1 when unknown
+    double meanLoad;
+    double maxLoad;
+    double meanRenderMicros;
+    double maxRenderMicros;
+    double meanActiveVoices;
+    int maxActiveVoices;
+    double meanStageMicros[NUM_PERFORMANCE_STAGES];
+    double maxStageMicros[NUM_PERFORMANCE_STAGES];
+    uint64_t loadHistogram[NUM_LOAD_BUCKETS];
+};
+
+// Per-block timing of the audio callback.
+//
+// The audio thread is the only writer: it brackets each block with
+// beginBlock()/endBlock() and charges time to stages in between. Counters are
+// plain relaxed atomics published under a sequence lock, so recording never
+// waits and any thread can take a snapshot that is consistent across fields.
+class PerformanceMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PerformanceMonitor();
+
+    // Audio thread only
+    void beginBlock();
+    void endBlock(int numSamples, double sampleRate);
+    void addStageTime(PerformanceStage stage, int64_t nanoseconds);
+    void noteActiveVoices(int count);
+
+    // Counts the block as an overrun whatever its load, for work that missed
+    // its deadline and was dropped rather than waited for
+    void noteOverrun() { blockOverrun = true; }
+
+    // Charges the time since mark to stage and returns the new mark, so
+    // consecutive stages cost one clock read each
+    Clock::time_point lap(PerformanceStage stage, Clock::time_point mark) {
+        Clock::time_point now = Clock::now();
+        addStageTime(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(now - mark).count());
+        return now;
+    }
+
+    // Any thread. xrunCount is left at -1 for the caller to fill in.
+    PerformanceSnapshot getSnapshot() const;
+
+    // Any thread; the counters are cleared at the start of the next block
+    void reset() { resetRequested.store(true, std::memory_order_release); }
+
+    static int getLoadBucket(double load);
+
+private:
+    void clearCounters();
+
+    // Single writer, so updates are load + store rather than read-modify-write
+    static void add(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    template <typename T>
+    static void raise(std::atomic<T>& maximum, T value) {
+        if (value > maximum.load(std::memory_order_relaxed)) maximum.store(value, std::memory_order_relaxed);
+    }
+
+    // Audio thread scratch for the block in progress
+    Clock::time_point blockStart;
+    int64_t blockStageNanoseconds[NUM_PERFORMANCE_STAGES];
+    int blockActiveVoices;
+    bool blockOverrun;
+
+    // Odd while the audio thread is updating the counters below
+    std::atomic<uint32_t> sequence;
+    std::atomic<bool> resetRequested;
+
+    std::atomic<uint64_t> blockCount;
+    std::atomic<uint64_t> overrunCount;
+    std::atomic<double> totalLoad;
+    std::atomic<double> maxLoad;
+    std::atomic<uint64_t> totalRenderNanoseconds;
+    std::atomic<uint64_t> maxRenderNanoseconds;
+    std::atomic<uint64_t> totalActiveVoices;
+    std::atomic<int> maxActiveVoices;
+    std::atomic<uint64_t> totalStageNanoseconds[NUM_PERFORMANCE_STAGES];
+    std::atomic<uint64_t> maxStageNanoseconds[NUM_PERFORMANCE_STAGES];
+    std::atomic<uint64_t> loadHistogram[PerformanceSnapshot::NUM_LOAD_BUCKETS];
+};
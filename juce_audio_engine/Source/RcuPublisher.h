@@ -0,0 +1,73 @@
+#pragma once
+#include "SpscQueue.h"
+#include <atomic>
+#include <memory>
+
+// Hands immutable objects built on a control thread to the audio thread,
+// RCU-style. publish() swaps a new object into a pending slot; the audio
+// thread adopts it at the start of a block and hands the one it replaces back
+// through a retire queue, so it never frees anything itself. Retired objects
+// are deleted with Deleter on the control thread, by the next publish() or by
+// the destructor.
+//
+// Publishers must be serialised by the caller; get() and adopt() are audio
+// thread only.
+template <typename T, typename Deleter = std::default_delete<T>>
+class RcuPublisher {
+public:
+    explicit RcuPublisher(int retireQueueSize, T* initial = nullptr)
+        : pending(nullptr), active(initial), retired(retireQueueSize) {}
+
+    // The audio thread must have stopped, so every object can be released here
+    ~RcuPublisher() {
+        deleteRetired();
+        destroy(pending.exchange(nullptr));
+        destroy(active);
+    }
+
+    RcuPublisher(const RcuPublisher&) = delete;
+    RcuPublisher& operator=(const RcuPublisher&) = delete;
+
+    // Control thread: frees what the audio thread has finished with, then
+    // publishes. An object still pending was never seen by the audio thread,
+    // so it is deleted straight away.
+    void publish(T* object) {
+        deleteRetired();
+        destroy(pending.exchange(object, std::memory_order_acq_rel));
+    }
+
+    void deleteRetired() {
+        T* object = nullptr;
+        while (retired.pop(object)) {
+            destroy(object);
+        }
+    }
+
+    // Audio thread: swaps in the pending object, if there is one. The old one
+    // may be deleted as soon as it is handed back, so read anything needed from
+    // get() beforehand. If the retire queue is full the swap waits for a later
+    // block. Returns whether a new object was adopted.
+    bool adopt() {
+        if (pending.load(std::memory_order_relaxed) == nullptr) {
+            return false;
+        }
+        if (active != nullptr && !retired.push(active)) {
+            return false;
+        }
+        active = pending.exchange(nullptr, std::memory_order_acq_rel);
+        return true;
+    }
+
+    T* get() const { return active; }
+
+private:
+    std::atomic<T*> pending;
+    T* active;                              // Audio thread only
+    SpscQueue<T*> retired;
+
+    static void destroy(T* object) {
+        if (object != nullptr) {
+            Deleter()(object);
+        }
+    }
+};
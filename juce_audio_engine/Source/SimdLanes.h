@@ -0,0 +1,236 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// SIMD lane types shared by the lane-parallel kernels (voice rendering and
+// FastMath), plus a one-lane scalar type with the same interface so every
+// kernel also has a portable build.
+//
+// Everything here lives in an unnamed namespace on purpose: the AVX2 units are
+// compiled with AVX2 code generation, and internal linkage guarantees none of
+// their instantiations can be merged into the baseline SSE2/NEON code.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SYNTH_SIMD_SSE2 1
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define SYNTH_SIMD_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define SYNTH_SIMD_NEON 1
+#endif
+
+namespace {
+
+// Each lane type provides the same small set of operations the kernels need.
+// Masks are represented as the vector type itself (all bits set = true).
+// load/store expect width-aligned pointers; the Unaligned variants do not.
+
+struct ScalarLanes {
+    static constexpr int width = 1;
+    float v;
+
+    static ScalarLanes load(const float* p) { return { *p }; }
+    static ScalarLanes loadUnaligned(const float* p) { return { *p }; }
+    static ScalarLanes set(float x) { return { x }; }
+    void store(float* p) const { *p = v; }
+    void storeUnaligned(float* p) const { *p = v; }
+
+    friend ScalarLanes operator+(ScalarLanes a, ScalarLanes b) { return { a.v + b.v }; }
+    friend ScalarLanes operator-(ScalarLanes a, ScalarLanes b) { return { a.v - b.v }; }
+    friend ScalarLanes operator*(ScalarLanes a, ScalarLanes b) { return { a.v * b.v }; }
+    friend ScalarLanes operator/(ScalarLanes a, ScalarLanes b) { return { a.v / b.v }; }
+
+    static ScalarLanes min(ScalarLanes a, ScalarLanes b) { return { a.v < b.v ? a.v : b.v }; }
+    static ScalarLanes max(ScalarLanes a, ScalarLanes b) { return { a.v > b.v ? a.v : b.v }; }
+
+    // Truncation toward zero; callers only pass non-negative values
+    static ScalarLanes truncate(ScalarLanes a) { return { static_cast<float>(static_cast<int>(a.v)) }; }
+
+    // Round toward negative infinity, for values within int range
+    static ScalarLanes floor(ScalarLanes a) {
+        float t = static_cast<float>(static_cast<int>(a.v));
+        return { t > a.v ? t - 1.0f : t };
+    }
+
+    // 2^n for integral n in [-126, 127], built directly from the exponent bits
+    static ScalarLanes pow2(ScalarLanes n) {
+        int32_t bits = (static_cast<int32_t>(n.v) + 127) << 23;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return { result };
+    }
+
+    // Splits a positive normal float into a mantissa in [1, 2) and its
+    // unbiased exponent
+    static ScalarLanes splitExponent(ScalarLanes a, ScalarLanes& exponent) {
+        int32_t bits;
+        std::memcpy(&bits, &a.v, sizeof(bits));
+        exponent = { static_cast<float>(((bits >> 23) & 0xff) - 127) };
+        bits = (bits & 0x007fffff) | 0x3f800000;
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+        return { mantissa };
+    }
+
+    using Mask = bool;
+    static Mask lessThan(ScalarLanes a, ScalarLanes b) { return a.v < b.v; }
+    static Mask equal(ScalarLanes a, ScalarLanes b) { return a.v == b.v; }
+    static ScalarLanes select(Mask m, ScalarLanes a, ScalarLanes b) { return m ? a : b; }
+};
+
+#if SYNTH_SIMD_SSE2
+struct SSE2Lanes {
+    static constexpr int width = 4;
+    __m128 v;
+
+    static SSE2Lanes load(const float* p) { return { _mm_load_ps(p) }; }
+    static SSE2Lanes loadUnaligned(const float* p) { return { _mm_loadu_ps(p) }; }
+    static SSE2Lanes set(float x) { return { _mm_set1_ps(x) }; }
+    void store(float* p) const { _mm_store_ps(p, v); }
+    void storeUnaligned(float* p) const { _mm_storeu_ps(p, v); }
+
+    friend SSE2Lanes operator+(SSE2Lanes a, SSE2Lanes b) { return { _mm_add_ps(a.v, b.v) }; }
+    friend SSE2Lanes operator-(SSE2Lanes a, SSE2Lanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+    friend SSE2Lanes operator*(SSE2Lanes a, SSE2Lanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+    friend SSE2Lanes operator/(SSE2Lanes a, SSE2Lanes b) { return { _mm_div_ps(a.v, b.v) }; }
+
+    static SSE2Lanes min(SSE2Lanes a, SSE2Lanes b) { return { _mm_min_ps(a.v, b.v) }; }
+    static SSE2Lanes max(SSE2Lanes a, SSE2Lanes b) { return { _mm_max_ps(a.v, b.v) }; }
+
+    static SSE2Lanes truncate(SSE2Lanes a) { return { _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v)) }; }
+
+    static SSE2Lanes floor(SSE2Lanes a) {
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        return { _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f))) };
+    }
+
+    static SSE2Lanes pow2(SSE2Lanes n) {
+        __m128i biased = _mm_add_epi32(_mm_cvttps_epi32(n.v), _mm_set1_epi32(127));
+        return { _mm_castsi128_ps(_mm_slli_epi32(biased, 23)) };
+    }
+
+    static SSE2Lanes splitExponent(SSE2Lanes a, SSE2Lanes& exponent) {
+        __m128i bits = _mm_castps_si128(a.v);
+        __m128i biased = _mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff));
+        exponent = { _mm_cvtepi32_ps(_mm_sub_epi32(biased, _mm_set1_epi32(127))) };
+        bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000));
+        return { _mm_castsi128_ps(bits) };
+    }
+
+    using Mask = __m128;
+    static Mask lessThan(SSE2Lanes a, SSE2Lanes b) { return _mm_cmplt_ps(a.v, b.v); }
+    static Mask equal(SSE2Lanes a, SSE2Lanes b) { return _mm_cmpeq_ps(a.v, b.v); }
+    static SSE2Lanes select(Mask m, SSE2Lanes a, SSE2Lanes b) {
+        return { _mm_or_ps(_mm_and_ps(m, a.v), _mm_andnot_ps(m, b.v)) };
+    }
+};
+#endif
+
+#if SYNTH_SIMD_AVX2
+struct AVX2Lanes {
+    static constexpr int width = 8;
+    __m256 v;
+
+    static AVX2Lanes load(const float* p) { return { _mm256_load_ps(p) }; }
+    static AVX2Lanes loadUnaligned(const float* p) { return { _mm256_loadu_ps(p) }; }
+    static AVX2Lanes set(float x) { return { _mm256_set1_ps(x) }; }
+    void store(float* p) const { _mm256_store_ps(p, v); }
+    void storeUnaligned(float* p) const { _mm256_storeu_ps(p, v); }
+
+    friend AVX2Lanes operator+(AVX2Lanes a, AVX2Lanes b) { return { _mm256_add_ps(a.v, b.v) }; }
+    friend AVX2Lanes operator-(AVX2Lanes a, AVX2Lanes b) { return { _mm256_sub_ps(a.v, b.v) }; }
+    friend AVX2Lanes operator*(AVX2Lanes a, AVX2Lanes b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    friend AVX2Lanes operator/(AVX2Lanes a, AVX2Lanes b) { return { _mm256_div_ps(a.v, b.v) }; }
+
+    static AVX2Lanes min(AVX2Lanes a, AVX2Lanes b) { return { _mm256_min_ps(a.v, b.v) }; }
+    static AVX2Lanes max(AVX2Lanes a, AVX2Lanes b) { return { _mm256_max_ps(a.v, b.v) }; }
+
+    static AVX2Lanes truncate(AVX2Lanes a) { return { _mm256_cvtepi32_ps(_mm256_cvttps_epi32(a.v)) }; }
+    static AVX2Lanes floor(AVX2Lanes a) { return { _mm256_floor_ps(a.v) }; }
+
+    static AVX2Lanes pow2(AVX2Lanes n) {
+        __m256i biased = _mm256_add_epi32(_mm256_cvttps_epi32(n.v), _mm256_set1_epi32(127));
+        return { _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23)) };
+    }
+
+    static AVX2Lanes splitExponent(AVX2Lanes a, AVX2Lanes& exponent) {
+        __m256i bits = _mm256_castps_si256(a.v);
+        __m256i biased = _mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xff));
+        exponent = { _mm256_cvtepi32_ps(_mm256_sub_epi32(biased, _mm256_set1_epi32(127))) };
+        bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000));
+        return { _mm256_castsi256_ps(bits) };
+    }
+
+    using Mask = __m256;
+    static Mask lessThan(AVX2Lanes a, AVX2Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    static Mask equal(AVX2Lanes a, AVX2Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+    static AVX2Lanes select(Mask m, AVX2Lanes a, AVX2Lanes b) { return { _mm256_blendv_ps(b.v, a.v, m) }; }
+};
+#endif
+
+#if SYNTH_SIMD_NEON
+struct NEONLanes {
+    static constexpr int width = 4;
+    float32x4_t v;
+
+    static NEONLanes load(const float* p) { return { vld1q_f32(p) }; }
+    static NEONLanes loadUnaligned(const float* p) { return { vld1q_f32(p) }; }
+    static NEONLanes set(float x) { return { vdupq_n_f32(x) }; }
+    void store(float* p) const { vst1q_f32(p, v); }
+    void storeUnaligned(float* p) const { vst1q_f32(p, v); }
+
+    friend NEONLanes operator+(NEONLanes a, NEONLanes b) { return { vaddq_f32(a.v, b.v) }; }
+    friend NEONLanes operator-(NEONLanes a, NEONLanes b) { return { vsubq_f32(a.v, b.v) }; }
+    friend NEONLanes operator*(NEONLanes a, NEONLanes b) { return { vmulq_f32(a.v, b.v) }; }
+
+    friend NEONLanes operator/(NEONLanes a, NEONLanes b) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+        return { vdivq_f32(a.v, b.v) };
+#else
+        // ARMv7 has no vector divide: reciprocal estimate plus two Newton steps
+        float32x4_t reciprocal = vrecpeq_f32(b.v);
+        reciprocal = vmulq_f32(vrecpsq_f32(b.v, reciprocal), reciprocal);
+        reciprocal = vmulq_f32(vrecpsq_f32(b.v, reciprocal), reciprocal);
+        return { vmulq_f32(a.v, reciprocal) };
+#endif
+    }
+
+    static NEONLanes min(NEONLanes a, NEONLanes b) { return { vminq_f32(a.v, b.v) }; }
+    static NEONLanes max(NEONLanes a, NEONLanes b) { return { vmaxq_f32(a.v, b.v) }; }
+
+    static NEONLanes truncate(NEONLanes a) { return { vcvtq_f32_s32(vcvtq_s32_f32(a.v)) }; }
+
+    static NEONLanes floor(NEONLanes a) {
+        float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a.v));
+        uint32x4_t greater = vcgtq_f32(t, a.v);
+        return { vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(greater, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))))) };
+    }
+
+    static NEONLanes pow2(NEONLanes n) {
+        int32x4_t biased = vaddq_s32(vcvtq_s32_f32(n.v), vdupq_n_s32(127));
+        return { vreinterpretq_f32_s32(vshlq_n_s32(biased, 23)) };
+    }
+
+    static NEONLanes splitExponent(NEONLanes a, NEONLanes& exponent) {
+        uint32x4_t bits = vreinterpretq_u32_f32(a.v);
+        int32x4_t biased = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(bits, 23), vdupq_n_u32(0xff)));
+        exponent = { vcvtq_f32_s32(vsubq_s32(biased, vdupq_n_s32(127))) };
+        bits = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000));
+        return { vreinterpretq_f32_u32(bits) };
+    }
+
+    using Mask = uint32x4_t;
+    static Mask lessThan(NEONLanes a, NEONLanes b) { return vcltq_f32(a.v, b.v); }
+    static Mask equal(NEONLanes a, NEONLanes b) { return vceqq_f32(a.v, b.v); }
+    static NEONLanes select(Mask m, NEONLanes a, NEONLanes b) { return { vbslq_f32(m, a.v, b.v) }; }
+};
+#endif
+
+} // namespace
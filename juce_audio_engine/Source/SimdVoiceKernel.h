@@ -0,0 +1,187 @@
+#pragma once
+#include "SimdVoiceRenderer.h"
+#include "FastMathKernel.h"
+
+// Lane-parallel voice kernel shared by the per-ISA translation units. Like
+// the lane types it is built on (SimdLanes.h), it lives in an unnamed
+// namespace so each ISA's instantiations stay in their own unit.
+
+namespace {
+
+// Waveforms for phases already wrapped to [0, 1); the sine is sineLanes from
+// FastMathKernel.h
+
+template <typename V>
+inline V squareLanes(V phase) {
+    return V::select(V::lessThan(phase, V::set(0.5f)), V::set(1.0f), V::set(-1.0f));
+}
+
+template <typename V>
+inline V sawLanes(V phase) {
+    V offset = V::select(V::lessThan(phase, V::set(0.5f)), V::set(0.0f), V::set(2.0f));
+    return V::set(2.0f) * phase - offset;
+}
+
+template <typename V>
+inline V triangleLanes(V phase) {
+    V four = V::set(4.0f) * phase;
+    return V::select(V::lessThan(phase, V::set(0.5f)), four - V::set(1.0f), V::set(3.0f) - four);
+}
+
+template <typename V>
+inline V waveformLanes(V phase, int uniformWaveform, V waveforms) {
+    switch (uniformWaveform) {
+        case static_cast<int>(WaveformType::SINE):     return sineLanes(phase);
+        case static_cast<int>(WaveformType::SQUARE):   return squareLanes(phase);
+        case static_cast<int>(WaveformType::SAW):      return sawLanes(phase);
+        case static_cast<int>(WaveformType::TRIANGLE): return triangleLanes(phase);
+        default: break;
+    }
+
+    // Lanes disagree: evaluate every shape and pick per lane
+    V result = sineLanes(phase);
+    result = V::select(V::equal(waveforms, V::set(1.0f)), squareLanes(phase), result);
+    result = V::select(V::equal(waveforms, V::set(2.0f)), sawLanes(phase), result);
+    result = V::select(V::equal(waveforms, V::set(3.0f)), triangleLanes(phase), result);
+    return result;
+}
+
+// Returns the waveform shared by every lane of a group, or -1 if they differ
+inline int uniformWaveform(const float* waveforms, int width) {
+    for (int lane = 1; lane < width; ++lane) {
+        if (waveforms[lane] != waveforms[0]) return -1;
+    }
+    return static_cast<int>(waveforms[0]);
+}
+
+template <typename V>
+inline V wrapPhase(V phase) {
+    return phase - V::truncate(phase);
+}
+
+// Per-lane TPT state-variable filter, same recurrence as StateVariableFilter
+template <typename V>
+struct FilterLanes {
+    V a1, a2, a3, m0, m1, m2, state1, state2;
+
+    static FilterLanes load(const VoiceLanes& lanes, int group) {
+        return { V::load(lanes.filterA1 + group), V::load(lanes.filterA2 + group), V::load(lanes.filterA3 + group),
+                 V::load(lanes.filterM0 + group), V::load(lanes.filterM1 + group), V::load(lanes.filterM2 + group),
+                 V::load(lanes.filterState1 + group), V::load(lanes.filterState2 + group) };
+    }
+
+    void storeState(VoiceLanes& lanes, int group) const {
+        state1.store(lanes.filterState1 + group);
+        state2.store(lanes.filterState2 + group);
+    }
+
+    V process(V v0) {
+        V v3 = v0 - state2;
+        V v1 = a1 * state1 + a2 * v3;
+        V v2 = state2 + a2 * state1 + a3 * v3;
+        V two = V::set(2.0f);
+        state1 = two * v1 - state1;
+        state2 = two * v2 - state2;
+        return m0 * v0 + m1 * v1 + m2 * v2;
+    }
+};
+
+// One lane group for one chunk; Filtered is a template flag so unfiltered
+// rendering pays nothing for the filter
+template <typename V, bool Filtered>
+inline void renderLaneGroup(VoiceLanes& lanes, int group, float* laneMixLeft, float* laneMixRight, int chunkSize) {
+    constexpr int W = V::width;
+
+    V phase1 = V::load(lanes.phase1 + group);
+    V phase2 = V::load(lanes.phase2 + group);
+    V increment1 = V::load(lanes.increment1 + group);
+    V increment2 = V::load(lanes.increment2 + group);
+    V gain1 = V::load(lanes.gain1 + group);
+    V gain2 = V::load(lanes.gain2 + group);
+    V gainStep1 = V::load(lanes.gainStep1 + group);
+    V gainStep2 = V::load(lanes.gainStep2 + group);
+    V waveforms1 = V::load(lanes.waveform1 + group);
+    V waveforms2 = V::load(lanes.waveform2 + group);
+    V panLeft = V::load(lanes.panLeft + group);
+    V panRight = V::load(lanes.panRight + group);
+    int uniform1 = uniformWaveform(lanes.waveform1 + group, W);
+    int uniform2 = uniformWaveform(lanes.waveform2 + group, W);
+
+    FilterLanes<V> filter {};
+    if (Filtered) {
+        filter = FilterLanes<V>::load(lanes, group);
+    }
+
+    for (int i = 0; i < chunkSize; ++i) {
+        V step = V::set(static_cast<float>(i));
+        V p1 = wrapPhase(phase1 + step * increment1);
+        V p2 = wrapPhase(phase2 + step * increment2);
+
+        V sample = waveformLanes(p1, uniform1, waveforms1) * (gain1 + step * gainStep1)
+                 + waveformLanes(p2, uniform2, waveforms2) * (gain2 + step * gainStep2);
+        if (Filtered) {
+            sample = filter.process(sample);
+        }
+
+        float* mixLeft = laneMixLeft + i * W;
+        float* mixRight = laneMixRight + i * W;
+        (V::load(mixLeft) + sample * panLeft).store(mixLeft);
+        (V::load(mixRight) + sample * panRight).store(mixRight);
+    }
+
+    // Advance the running phases, gain ramps and filter state past this chunk
+    V length = V::set(static_cast<float>(chunkSize));
+    wrapPhase(phase1 + length * increment1).store(lanes.phase1 + group);
+    wrapPhase(phase2 + length * increment2).store(lanes.phase2 + group);
+    (gain1 + length * gainStep1).store(lanes.gain1 + group);
+    (gain2 + length * gainStep2).store(lanes.gain2 + group);
+    if (Filtered) {
+        filter.storeState(lanes, group);
+    }
+}
+
+// Sums each sample's lanes into output (one pass per sample regardless of voice count)
+template <int W>
+inline void reduceLanes(const float* laneMix, float* output, int chunkSize) {
+    for (int i = 0; i < chunkSize; ++i) {
+        const float* mix = laneMix + i * W;
+        float sum = 0.0f;
+        for (int lane = 0; lane < W; ++lane) {
+            sum += mix[lane];
+        }
+        output[i] += sum;
+    }
+}
+
+// Renders every lane group and adds the summed, panned result into left and right
+template <typename V>
+void renderVoiceLanes(VoiceLanes& lanes, float* left, float* right, int numSamples) {
+    constexpr int W = V::width;
+    constexpr int CHUNK_SIZE = 64;
+
+    // Per-sample, per-lane accumulators; reduced across lanes once per chunk
+    alignas(32) float laneMixLeft[CHUNK_SIZE * W];
+    alignas(32) float laneMixRight[CHUNK_SIZE * W];
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += CHUNK_SIZE) {
+        int chunkSize = numSamples - chunkStart < CHUNK_SIZE ? numSamples - chunkStart : CHUNK_SIZE;
+
+        for (int i = 0; i < chunkSize * W; ++i) {
+            laneMixLeft[i] = 0.0f;
+            laneMixRight[i] = 0.0f;
+        }
+
+        for (int group = 0; group < lanes.paddedCount; group += W) {
+            if (lanes.anyFiltered) {
+                renderLaneGroup<V, true>(lanes, group, laneMixLeft, laneMixRight, chunkSize);
+            } else {
+                renderLaneGroup<V, false>(lanes, group, laneMixLeft, laneMixRight, chunkSize);
+            }
+        }
+
+        reduceLanes<W>(laneMixLeft, left + chunkStart, chunkSize);
+        reduceLanes<W>(laneMixRight, right + chunkStart, chunkSize);
+    }
+}
+
+} // namespace
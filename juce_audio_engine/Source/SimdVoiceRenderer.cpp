@@ -0,0 +1,183 @@
+#include "SimdVoiceRenderer.h"
+#include "SimdVoiceKernel.h"
+#include "Effects/Denormals.h"
+#include <juce_core/juce_core.h>
+
+#if SYNTH_HAS_AVX2_KERNEL
+// Defined in SimdVoiceRendererAVX2.cpp, which is compiled with AVX2 enabled
+void renderVoiceLanesAVX2(VoiceLanes& lanes, float* left, float* right, int numSamples);
+#endif
+
+SimdVoiceRenderer::SimdVoiceRenderer()
+    : laneVoices{}, activeVoiceCount(0), kernel(&renderVoiceLanes<ScalarLanes>), kernelName("Scalar"), kernelWidth(1) {
+
+    // Pick the widest kernel this CPU can run
+#if SYNTH_SIMD_NEON
+    kernel = &renderVoiceLanes<NEONLanes>;
+    kernelName = "NEON";
+    kernelWidth = NEONLanes::width;
+#elif SYNTH_SIMD_SSE2
+    kernel = &renderVoiceLanes<SSE2Lanes>;
+    kernelName = "SSE2";
+    kernelWidth = SSE2Lanes::width;
+#endif
+
+#if SYNTH_HAS_AVX2_KERNEL
+    if (juce::SystemStats::hasAVX2()) {
+        kernel = &renderVoiceLanesAVX2;
+        kernelName = "AVX2";
+        kernelWidth = 8;
+    }
+#endif
+}
+
+// Wavetable oscillators need per-lane table gathers, which do not pay off
+// in SIMD; those voices are rendered through their own block path instead
+static bool isLaneRenderable(DualOscVoice& voice) {
+    return voice.getOsc1().getMode() == OscillatorMode::ANALYTIC
+        && voice.getOsc2().getMode() == OscillatorMode::ANALYTIC;
+}
+
+void SimdVoiceRenderer::render(DualOscVoice* const* voices, int numVoices, float* left, float* right,
+                               int numSamples, double sampleRate) {
+    for (int i = 0; i < numVoices; ++i) {
+        if (!isLaneRenderable(*voices[i])) {
+            voices[i]->renderBlock(left, right, numSamples, sampleRate);
+        }
+    }
+
+    gatherVoices(voices, numVoices, numSamples, sampleRate);
+    if (activeVoiceCount == 0) return;
+
+    kernel(lanes, left, right, numSamples);
+    scatterState();
+}
+
+const char* SimdVoiceRenderer::getInstructionSetName() const {
+    return kernelName;
+}
+
+static int waveformPairKey(DualOscVoice& voice) {
+    return static_cast<int>(voice.getOsc1().getWaveform()) * 4 + static_cast<int>(voice.getOsc2().getWaveform());
+}
+
+void SimdVoiceRenderer::gatherVoices(DualOscVoice* const* voices, int numVoices, int numSamples, double sampleRate) {
+    // Counting sort by waveform pair so each lane group is uniform
+    int pairCounts[VoiceLanes::NUM_WAVEFORM_PAIRS] = {};
+    activeVoiceCount = 0;
+
+    for (int i = 0; i < numVoices; ++i) {
+        if (isLaneRenderable(*voices[i])) {
+            pairCounts[waveformPairKey(*voices[i])]++;
+            activeVoiceCount++;
+        }
+    }
+
+    int pairStart[VoiceLanes::NUM_WAVEFORM_PAIRS];
+    int pairFill[VoiceLanes::NUM_WAVEFORM_PAIRS];
+    int lane = 0;
+    for (int key = 0; key < VoiceLanes::NUM_WAVEFORM_PAIRS; ++key) {
+        pairStart[key] = lane;
+        pairFill[key] = lane;
+        lane += (pairCounts[key] + kernelWidth - 1) / kernelWidth * kernelWidth;
+    }
+    lanes.paddedCount = lane;
+    lanes.anyFiltered = false;
+
+    for (int i = 0; i < numVoices; ++i) {
+        if (isLaneRenderable(*voices[i])) {
+            fillLane(pairFill[waveformPairKey(*voices[i])]++, *voices[i], numSamples, sampleRate);
+        }
+    }
+
+    // Pad each group out to its lane boundary with silent lanes of the same shape
+    for (int key = 0; key < VoiceLanes::NUM_WAVEFORM_PAIRS; ++key) {
+        int groupEnd = (key + 1 < VoiceLanes::NUM_WAVEFORM_PAIRS) ? pairStart[key + 1] : lanes.paddedCount;
+        for (int padLane = pairFill[key]; padLane < groupEnd; ++padLane) {
+            fillPaddingLane(padLane, static_cast<float>(key / 4), static_cast<float>(key % 4));
+        }
+    }
+}
+
+void SimdVoiceRenderer::fillLane(int lane, DualOscVoice& voice, int numSamples, double sampleRate) {
+    Oscillator& osc1 = voice.getOsc1();
+    Oscillator& osc2 = voice.getOsc2();
+    float velocity = voice.getVelocity();
+
+    // A mix glide becomes a straight gain ramp across this block; like
+    // SmoothedParameter::getNextValue, the first sample is already one step in
+    float startMix, endMix;
+    voice.advanceMix(numSamples, startMix, endMix);
+    float mixStep = numSamples > 0 ? (endMix - startMix) / static_cast<float>(numSamples) : 0.0f;
+    startMix += mixStep;
+
+    lanes.phase1[lane] = osc1.getPhase();
+    lanes.phase2[lane] = osc2.getPhase();
+    lanes.increment1[lane] = static_cast<float>(osc1.getFrequency() / sampleRate);
+    lanes.increment2[lane] = static_cast<float>(osc2.getFrequency() / sampleRate);
+    lanes.gain1[lane] = (1.0f - startMix) * velocity;
+    lanes.gain2[lane] = startMix * velocity;
+    lanes.gainStep1[lane] = -mixStep * velocity;
+    lanes.gainStep2[lane] = mixStep * velocity;
+    lanes.waveform1[lane] = static_cast<float>(osc1.getWaveform());
+    lanes.waveform2[lane] = static_cast<float>(osc2.getWaveform());
+    lanes.panLeft[lane] = voice.getPanLeft();
+    lanes.panRight[lane] = voice.getPanRight();
+    laneVoices[lane] = &voice;
+
+    if (voice.isFilterEnabled()) {
+        const SvfCoefficients& coefficients = voice.getFilterCoefficients();
+        lanes.filterA1[lane] = coefficients.a1;
+        lanes.filterA2[lane] = coefficients.a2;
+        lanes.filterA3[lane] = coefficients.a3;
+        lanes.filterM0[lane] = coefficients.m0;
+        lanes.filterM1[lane] = coefficients.m1;
+        lanes.filterM2[lane] = coefficients.m2;
+        lanes.filterState1[lane] = voice.getFilterState1();
+        lanes.filterState2[lane] = voice.getFilterState2();
+        lanes.anyFiltered = true;
+    } else {
+        setPassThroughFilter(lane);
+    }
+}
+
+void SimdVoiceRenderer::setPassThroughFilter(int lane) {
+    lanes.filterA1[lane] = 0.0f;
+    lanes.filterA2[lane] = 0.0f;
+    lanes.filterA3[lane] = 0.0f;
+    lanes.filterM0[lane] = 1.0f;
+    lanes.filterM1[lane] = 0.0f;
+    lanes.filterM2[lane] = 0.0f;
+    lanes.filterState1[lane] = 0.0f;
+    lanes.filterState2[lane] = 0.0f;
+}
+
+void SimdVoiceRenderer::fillPaddingLane(int lane, float waveform1, float waveform2) {
+    lanes.phase1[lane] = 0.0f;
+    lanes.phase2[lane] = 0.0f;
+    lanes.increment1[lane] = 0.0f;
+    lanes.increment2[lane] = 0.0f;
+    lanes.gain1[lane] = 0.0f;
+    lanes.gain2[lane] = 0.0f;
+    lanes.gainStep1[lane] = 0.0f;
+    lanes.gainStep2[lane] = 0.0f;
+    lanes.waveform1[lane] = waveform1;
+    lanes.waveform2[lane] = waveform2;
+    lanes.panLeft[lane] = 0.0f;
+    lanes.panRight[lane] = 0.0f;
+    laneVoices[lane] = nullptr;
+    setPassThroughFilter(lane);
+}
+
+void SimdVoiceRenderer::scatterState() {
+    for (int lane = 0; lane < lanes.paddedCount; ++lane) {
+        DualOscVoice* voice = laneVoices[lane];
+        if (voice != nullptr) {
+            voice->getOsc1().setPhase(lanes.phase1[lane]);
+            voice->getOsc2().setPhase(lanes.phase2[lane]);
+            if (voice->isFilterEnabled()) {
+                voice->setFilterState(flushDenormal(lanes.filterState1[lane]), flushDenormal(lanes.filterState2[lane]));
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "VoicePool.h"
+
+// Selects how SynthEngine renders its voice pool
+enum class VoiceRenderMode {
+    SCALAR = 0,     // DualOscVoice::renderBlock per voice
+    SIMD = 1        // SimdVoiceRenderer, several voices per instruction
+};
+
+// Structure-of-arrays copy of the oscillator state of every active voice.
+// Voices are grouped by waveform pair and each group is padded to a multiple
+// of the kernel's SIMD width, so every lane group shares one waveform and the
+// kernel never has to evaluate more than one shape. Padding lanes have zero
+// gain and zero increment so they contribute nothing.
+struct VoiceLanes {
+    static constexpr int LANE_PADDING = 8;     // Widest kernel width
+    static constexpr int NUM_WAVEFORM_PAIRS = 16;
+    static constexpr int MAX_LANES = VoicePool::MAX_POLYPHONY_LIMIT + NUM_WAVEFORM_PAIRS * LANE_PADDING;
+
+    alignas(32) float phase1[MAX_LANES];
+    alignas(32) float phase2[MAX_LANES];
+    alignas(32) float increment1[MAX_LANES];
+    alignas(32) float increment2[MAX_LANES];
+    alignas(32) float gain1[MAX_LANES];         // (1 - mix) * velocity
+    alignas(32) float gain2[MAX_LANES];         // mix * velocity
+    alignas(32) float gainStep1[MAX_LANES];     // Per-sample change while the mix glides
+    alignas(32) float gainStep2[MAX_LANES];
+    alignas(32) float waveform1[MAX_LANES];     // WaveformType stored as float for lane compares
+    alignas(32) float waveform2[MAX_LANES];
+    alignas(32) float panLeft[MAX_LANES];       // DualOscVoice pan gains
+    alignas(32) float panRight[MAX_LANES];
+
+    // Per-voice state-variable filter, one lane per voice (see SvfCoefficients).
+    // Unfiltered voices get a pass-through mix (m0 = 1, m1 = m2 = 0).
+    alignas(32) float filterA1[MAX_LANES];
+    alignas(32) float filterA2[MAX_LANES];
+    alignas(32) float filterA3[MAX_LANES];
+    alignas(32) float filterM0[MAX_LANES];
+    alignas(32) float filterM1[MAX_LANES];
+    alignas(32) float filterM2[MAX_LANES];
+    alignas(32) float filterState1[MAX_LANES];
+    alignas(32) float filterState2[MAX_LANES];
+
+    int paddedCount = 0;    // Lanes in use, including padding
+    bool anyFiltered = false;
+};
+
+// Lane-parallel renderer for the voice pool.
+// Each block the active voices are gathered into VoiceLanes, rendered 4 or 8 at
+// a time by an SSE2/AVX2/NEON kernel chosen at runtime, and their phases and
+// filter states are written back so voices can move between render modes
+// seamlessly. Per-voice filters run inside the kernel, one voice per lane.
+// Voices in a wavetable OscillatorMode fall back to DualOscVoice::renderBlock.
+class SimdVoiceRenderer {
+public:
+    SimdVoiceRenderer();
+
+    // Adds numSamples of each listed (active) voice into the left and right outputs
+    void render(DualOscVoice* const* voices, int numVoices, float* left, float* right,
+                int numSamples, double sampleRate);
+
+    // Name of the kernel picked for this CPU ("AVX2", "SSE2", "NEON" or "Scalar")
+    const char* getInstructionSetName() const;
+
+private:
+    using KernelFunction = void (*)(VoiceLanes& lanes, float* left, float* right, int numSamples);
+
+    VoiceLanes lanes;
+    DualOscVoice* laneVoices[VoiceLanes::MAX_LANES];    // nullptr for padding lanes
+    int activeVoiceCount;
+
+    KernelFunction kernel;
+    const char* kernelName;
+    int kernelWidth;
+
+    void gatherVoices(DualOscVoice* const* voices, int numVoices, int numSamples, double sampleRate);
+    void fillLane(int lane, DualOscVoice& voice, int numSamples, double sampleRate);
+    void fillPaddingLane(int lane, float waveform1, float waveform2);
+    void setPassThroughFilter(int lane);
+    void scatterState();
+};
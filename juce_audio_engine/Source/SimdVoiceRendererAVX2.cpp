@@ -0,0 +1,9 @@
+// AVX2 build of the voice kernel. This file is compiled with AVX2 code
+// generation and is only called after a runtime CPU check.
+#include "SimdVoiceKernel.h"
+
+#if SYNTH_SIMD_AVX2
+void renderVoiceLanesAVX2(VoiceLanes& lanes, float* left, float* right, int numSamples) {
+    renderVoiceLanes<AVX2Lanes>(lanes, left, right, numSamples);
+}
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Wait-free single-producer / single-consumer ring buffer.
+// Storage is allocated once in the constructor; push() and pop() never
+// allocate or block, so either end can safely run on the audio thread.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t minimumCapacity) {
+        size_t capacity = 1;
+        while (capacity < minimumCapacity) {
+            capacity <<= 1;
+        }
+        buffer.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    // Producer side - returns false (and drops the item) when the queue is full
+    bool push(const T& item) {
+        size_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - tail.load(std::memory_order_acquire) == buffer.size()) {
+            return false;
+        }
+        buffer[writeIndex & mask] = item;
+        head.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side - returns false when there is nothing to read
+    bool pop(T& item) {
+        size_t readIndex = tail.load(std::memory_order_relaxed);
+        if (readIndex == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = buffer[readIndex & mask];
+        tail.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t getCapacity() const { return buffer.size(); }
+
+private:
+    std::vector<T> buffer;
+    size_t mask;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
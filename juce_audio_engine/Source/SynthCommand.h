@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+// Control-thread request for the audio thread.
+// SynthEngine setters push these into a lock-free queue and the audio callback
+// applies them at the start of each block, so engine state is only ever
+// mutated on the audio thread. Commands carrying a samplePosition are held
+// back and applied at exactly that sample of the engine's render clock.
+struct SynthCommand {
+    enum class Type {
+        NOTE_ON,                // intValue = MIDI note, floatValue = velocity
+        NOTE_OFF,               // intValue = MIDI note
+        SET_OSC1_WAVEFORM,      // intValue = WaveformType
+        SET_OSC2_WAVEFORM,      // intValue = WaveformType
+        SET_DETUNE,             // floatValue = cents
+        SET_OSC_MIX,            // floatValue = mix
+        SET_OSC_MODE,           // intValue = OscillatorMode
+        SET_STEREO_SPREAD,      // floatValue = 0 - 1
+        SET_VOICE_STEALING,     // intValue = VoiceStealingMode
+        SET_VOICE_RENDER_MODE,  // intValue = VoiceRenderMode
+        SET_CUTOFF,             // floatValue = Hz
+        SET_RESONANCE,          // floatValue = Q
+        SET_FILTER_MODE,        // intValue = FilterMode
+        SET_FILTER_ROUTING,     // intValue = FilterRouting
+        SET_FILTER_KEY_TRACKING,    // floatValue = 0 - 1
+        SET_FILTER_VELOCITY,        // floatValue = 0 - 1
+        REVERB_PARAMETER,       // intValue = paramId, floatValue = value
+        DELAY_PARAMETER,        // intValue = paramId, floatValue = value
+        CHORUS_PARAMETER,       // intValue = paramId, floatValue = value
+        CONVOLUTION_PARAMETER,  // intValue = paramId, floatValue = value
+        SET_CONVOLUTION_ENABLED,    // intValue = 0 / 1
+        SET_OSCILLOSCOPE_ENABLED    // intValue = 0 / 1
+    };
+
+    static constexpr int64_t IMMEDIATE = -1;
+
+    Type type;
+    int intValue;
+    float floatValue;
+    int64_t timestamp;          // juce::Time high resolution ticks when issued
+    int64_t samplePosition;     // Engine sample clock position, or IMMEDIATE
+};
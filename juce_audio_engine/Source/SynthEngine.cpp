@@ -1,23 +1,63 @@
 #include "SynthEngine.h"
-#include <iostream>
+#include "Wavetable.h"
+#include "FastMath.h"
+#include "Logger.h"
+#include "Effects/Denormals.h"
 #include <cmath>
+#include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 SynthEngine::SynthEngine() 
-    : cutoffFrequency(1000.0f),
-    currentSampleRate(44100.0),
+    : maxPolyphony(VoicePool::DEFAULT_MAX_POLYPHONY),
+    commandQueue(COMMAND_QUEUE_SIZE),
+    samplePosition(0),
+    voiceRenderMode(VoiceRenderMode::SIMD),
+    renderThreadCount(1),
+    activeVoiceListSize(0),
     globalOsc1Waveform(WaveformType::SINE),
     globalOsc2Waveform(WaveformType::SINE),
     globalDetune(0.0f),
     globalMix(0.5f),
-    reverbEnabled(false),
+    globalOscMode(OscillatorMode::ANALYTIC),
+    stereoSpread(0.0f),
+    cutoffFrequency(1000.0f),
+    currentSampleRate(44100.0),
+    oversamplingFactor(static_cast<int>(OversamplingFactor::NONE)),
+    voiceSampleRate(44100.0),
+    filterRouting(FilterRouting::PER_VOICE),
+    voiceFilterCutoff(1000.0f, SmoothingType::EXPONENTIAL),
+    voiceFilterResonance(1.0f),
+    convolutionEnabled(false),
+    convolutionRequested(false),
     oscilloscopeEnabled(false),
-    oscilloscopeBufferSize(512) {
-
-    filter = std::make_unique<LowpassFilter>();
+    oscilloscopeBufferSize(512),
+    perEffectTiming(false),
+    requestedEffectOrder{ EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB },
+    requestedEffectMask(0),
+    effectRoutings(RETIRED_ROUTING_QUEUE_SIZE, new EffectRouting(requestedEffectOrder, requestedEffectMask)),
+    audioDeviceRunning(false),
+    offlineBlockSize(0),
+    offlinePrepared(false) {
+
+    voicePool.prepare(maxPolyphony);
+    activeVoiceList.assign(voicePool.getCapacity(), nullptr);
+
+    // Every queued command could be a scheduled one, so reserve for all of them
+    scheduledCommands.reserve(COMMAND_QUEUE_SIZE);
+
+    simdRenderer = std::make_unique<SimdVoiceRenderer>();
+    parallelRenderer = std::make_unique<ParallelVoiceRenderer>();
+    voiceOversampler = std::make_unique<Oversampler>();
+    limiterOversampler = std::make_unique<Oversampler>();
+    performanceMonitor = std::make_unique<PerformanceMonitor>();
+
+    // Build the shared band-limited tables now rather than on the audio thread
+    WavetableBank::getShared();
+
+    filter = std::make_unique<StateVariableFilter>();
     filter->setSampleRate(44100.0);
     filter->setCutoff(1000.0f);
     filter->setResonance(1.0f);
@@ -25,251 +65,618 @@ SynthEngine::SynthEngine()
     reverbEffect = std::make_unique<ReverbEffect>();
     delayEffect = std::make_unique<DelayEffect>();
     chorusEffect = std::make_unique<ChorusEffect>();
-    rebuildEffectsChain();
+    convolutionEffect = std::make_unique<ConvolutionReverb>();
+
+    // Effects chain is built in professional order by default:
+    // 1. Modulation effects (chorus)
+    // 2. Time-based effects (delay)
+    // 3. Spatial effects (reverb)
+    effectSet = EffectSet(chorusEffect.get(), delayEffect.get(), reverbEffect.get());
+
+    // Default mix scratch until prepareToPlay sizes it for the device
+    voiceMixBuffer.setSize(NUM_MIX_CHANNELS, MIN_MIX_BUFFER_SIZE);
 
-    std::cout << "SynthEngine created with dual oscillators" << std::endl;
+    // Fixed-size capture frames so toggling the scope never allocates
+    oscilloscopeFrames.fill(std::vector<float>(oscilloscopeBufferSize, 0.0f));
+
+    Logger::info("engine", "SynthEngine created with dual oscillators");
 }
 
 SynthEngine::~SynthEngine() {
     shutdownAudio();
-    std::cout << "SynthEngine destroyed" << std::endl;
+    Logger::info("engine", "SynthEngine destroyed");
 }
 
 bool SynthEngine::initializeAudio() {
+    std::lock_guard<std::mutex> lock(deviceMutex);
+
     // Initialize the audio device manager with default settings
     auto result = audioDeviceManager.initialiseWithDefaultDevices(0, 2); // 0 inputs, 2 outputs
     
     if (result.isNotEmpty()) {
-        std::cout << "Failed to initialize audio: " << result.toStdString() << std::endl;
+        Logger::severe("engine", "Failed to initialize audio: %s", result.toRawUTF8());
         return false;
     }
     
     // Set up the audio source player
     audioSourcePlayer.setSource(this);
     audioDeviceManager.addAudioCallback(&audioSourcePlayer);
+    audioDeviceRunning = true;
+    offlinePrepared = false;
     
-    std::cout << "Audio initialized successfully" << std::endl;
+    Logger::info("engine", "Audio initialized successfully");
     
     // Print current audio device info
     auto* currentDevice = audioDeviceManager.getCurrentAudioDevice();
     if (currentDevice != nullptr) {
-        std::cout << "Using audio device: " << currentDevice->getName().toStdString() << std::endl;
-        std::cout << "Sample rate: " << currentDevice->getCurrentSampleRate() << " Hz" << std::endl;
-        std::cout << "Buffer size: " << currentDevice->getCurrentBufferSizeSamples() << " samples" << std::endl;
+        Logger::info("engine", "Using audio device: %s", currentDevice->getName().toRawUTF8());
+        Logger::info("engine", "Sample rate: %g Hz", currentDevice->getCurrentSampleRate());
+        Logger::info("engine", "Buffer size: %d samples", currentDevice->getCurrentBufferSizeSamples());
     }
     
     return true;
 }
 
 void SynthEngine::shutdownAudio() {
+    std::lock_guard<std::mutex> lock(deviceMutex);
+
+    // Cleared first so nothing treats the device as usable while it closes
+    audioDeviceRunning = false;
     audioDeviceManager.removeAudioCallback(&audioSourcePlayer);
     audioSourcePlayer.setSource(nullptr);
     audioDeviceManager.closeAudioDevice();
 }
 
-void SynthEngine::setCutoff(float value) {
-    cutoffFrequency = value;
-    if (filter) {
-        filter->setCutoff(value);
+bool SynthEngine::prepareOfflineRender(double sampleRate, int maxBlockSize) {
+    if (audioDeviceRunning || sampleRate <= 0.0 || maxBlockSize <= 0) {
+        return false;
     }
+
+    offlineBlockSize = maxBlockSize;
+    offlineBuffer.setSize(MAX_OFFLINE_CHANNELS, maxBlockSize);
+    prepareToPlay(maxBlockSize, sampleRate);
+    offlinePrepared = true;
+    return true;
 }
 
-void SynthEngine::setResonance(float value) {
-    if (filter) {
-        filter->setResonance(value);
+bool SynthEngine::renderOffline(float* const* channels, int numChannels, int numSamples) {
+    if (channels == nullptr || numChannels <= 0 || numSamples < 0) {
+        return false;
+    }
+    if (!offlinePrepared && !prepareOfflineRender(currentSampleRate, DEFAULT_OFFLINE_BLOCK_SIZE)) {
+        return false;
     }
+
+    // Wrap the caller's planar buffers and pull blocks exactly like the device would
+    juce::AudioBuffer<float> buffer(channels, numChannels, numSamples);
+    for (int start = 0; start < numSamples; start += offlineBlockSize) {
+        int blockSize = std::min(offlineBlockSize, numSamples - start);
+        getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, start, blockSize));
+    }
+    return true;
+}
+
+bool SynthEngine::renderOfflineInterleaved(float* interleaved, int numChannels, int numFrames) {
+    if (interleaved == nullptr || numChannels <= 0 || numChannels > MAX_OFFLINE_CHANNELS || numFrames < 0) {
+        return false;
+    }
+    if (!offlinePrepared && !prepareOfflineRender(currentSampleRate, DEFAULT_OFFLINE_BLOCK_SIZE)) {
+        return false;
+    }
+
+    // Render planar blocks into scratch, then interleave into the caller's buffer
+    for (int start = 0; start < numFrames; start += offlineBlockSize) {
+        int blockSize = std::min(offlineBlockSize, numFrames - start);
+        juce::AudioBuffer<float> block(offlineBuffer.getArrayOfWritePointers(), numChannels, blockSize);
+        getNextAudioBlock(juce::AudioSourceChannelInfo(&block, 0, blockSize));
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            const float* source = block.getReadPointer(channel);
+            float* destination = interleaved + static_cast<size_t>(start) * numChannels + channel;
+            for (int i = 0; i < blockSize; ++i) {
+                destination[static_cast<size_t>(i) * numChannels] = source[i];
+            }
+        }
+    }
+    return true;
+}
+
+void SynthEngine::setCutoff(float value) {
+    pushCommand(SynthCommand::Type::SET_CUTOFF, 0, value);
+}
+
+void SynthEngine::setResonance(float value) {
+    pushCommand(SynthCommand::Type::SET_RESONANCE, 0, value);
+}
+
+void SynthEngine::setFilterMode(FilterMode mode) {
+    pushCommand(SynthCommand::Type::SET_FILTER_MODE, static_cast<int>(mode), 0.0f);
+}
+
+void SynthEngine::setFilterRouting(FilterRouting routing) {
+    pushCommand(SynthCommand::Type::SET_FILTER_ROUTING, static_cast<int>(routing), 0.0f);
+}
+
+void SynthEngine::setFilterKeyTracking(float amount) {
+    pushCommand(SynthCommand::Type::SET_FILTER_KEY_TRACKING, 0, amount);
+}
+
+void SynthEngine::setFilterVelocityAmount(float amount) {
+    pushCommand(SynthCommand::Type::SET_FILTER_VELOCITY, 0, amount);
 }
 
 void SynthEngine::noteOn(int midiNote, float velocity) {
-    float frequency = midiNoteToFrequency(midiNote);
-    
-    // Create or reuse voice
-    DualOscVoice& voice = activeVoices[midiNote];
-    
-    // Apply current global settings to the voice
-    voice.setOsc1Waveform(globalOsc1Waveform);
-    voice.setOsc2Waveform(globalOsc2Waveform);
-    voice.setDetune(globalDetune);
-    voice.setMix(globalMix);
-    
-    // Start the note
-    voice.noteOn(frequency, velocity);
-    
-    std::cout << "Note ON: " << midiNote << " (freq: " << frequency << "Hz)" << std::endl;
+    pushCommand(SynthCommand::Type::NOTE_ON, midiNote, velocity);
+    Logger::verbose("engine", "Note ON: %d (freq: %gHz)", midiNote, midiNoteToFrequency(midiNote));
 }
 
 void SynthEngine::noteOff(int midiNote) {
-    auto it = activeVoices.find(midiNote);
-    if (it != activeVoices.end()) {
-        it->second.noteOff();
-        std::cout << "Note OFF: " << midiNote << std::endl;
-    }
+    pushCommand(SynthCommand::Type::NOTE_OFF, midiNote, 0.0f);
+    Logger::verbose("engine", "Note OFF: %d", midiNote);
+}
+
+void SynthEngine::noteOnAt(int midiNote, float velocity, int64_t position) {
+    pushCommand(SynthCommand::Type::NOTE_ON, midiNote, velocity, std::max<int64_t>(position, 0));
+}
+
+void SynthEngine::noteOffAt(int midiNote, int64_t position) {
+    pushCommand(SynthCommand::Type::NOTE_OFF, midiNote, 0.0f, std::max<int64_t>(position, 0));
+}
+
+int64_t SynthEngine::getSamplePosition() const {
+    return samplePosition.load();
 }
 
 // New dual oscillator controls
 void SynthEngine::setOsc1Waveform(WaveformType type) {
-    globalOsc1Waveform = type;
-    // Apply to all active voices
-    for (auto& voice : activeVoices) {
-        voice.second.setOsc1Waveform(type);
-    }
+    pushCommand(SynthCommand::Type::SET_OSC1_WAVEFORM, static_cast<int>(type), 0.0f);
 }
 
 void SynthEngine::setOsc2Waveform(WaveformType type) {
-    globalOsc2Waveform = type;
-    // Apply to all active voices
-    for (auto& voice : activeVoices) {
-        voice.second.setOsc2Waveform(type);
-    }
+    pushCommand(SynthCommand::Type::SET_OSC2_WAVEFORM, static_cast<int>(type), 0.0f);
 }
 
 void SynthEngine::setDetune(float cents) {
-    globalDetune = cents;
-    // Apply to all active voices
-    for (auto& voice : activeVoices) {
-        voice.second.setDetune(cents);
-    }
+    pushCommand(SynthCommand::Type::SET_DETUNE, 0, cents);
 }
 
 void SynthEngine::setOscMix(float mix) {
-    globalMix = mix;
-    // Apply to all active voices
-    for (auto& voice : activeVoices) {
-        voice.second.setMix(mix);
-    }
+    pushCommand(SynthCommand::Type::SET_OSC_MIX, 0, mix);
+}
+
+void SynthEngine::setOscillatorMode(OscillatorMode mode) {
+    pushCommand(SynthCommand::Type::SET_OSC_MODE, static_cast<int>(mode), 0.0f);
+}
+
+void SynthEngine::setMaxPolyphony(int voices) {
+    maxPolyphony = std::clamp(voices, 1, VoicePool::MAX_POLYPHONY_LIMIT);
+}
+
+void SynthEngine::setVoiceStealingMode(VoiceStealingMode mode) {
+    pushCommand(SynthCommand::Type::SET_VOICE_STEALING, static_cast<int>(mode), 0.0f);
+}
+
+void SynthEngine::setStereoSpread(float spread) {
+    pushCommand(SynthCommand::Type::SET_STEREO_SPREAD, 0, spread);
+}
+
+void SynthEngine::setVoiceRenderMode(VoiceRenderMode mode) {
+    pushCommand(SynthCommand::Type::SET_VOICE_RENDER_MODE, static_cast<int>(mode), 0.0f);
+}
+
+void SynthEngine::setRenderThreads(int numThreads) {
+    renderThreadCount = clampRenderThreads(numThreads);
+}
+
+void SynthEngine::setOversampling(OversamplingFactor factor) {
+    oversamplingFactor = static_cast<int>(factor);
+}
+
+int SynthEngine::clampRenderThreads(int numThreads) {
+    int available = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(numThreads, 1, std::max(available, 1));
 }
 
 void SynthEngine::enableReverb(bool enable) {
-    reverbEnabled = enable;
-    if (reverbEffect) {
-        reverbEffect->setSampleRate(currentSampleRate);
-        if (enable) {
-            reverbEffect->reset(); // Clear any existing reverb tail
-        }
-    }
-    rebuildEffectsChain(); // Rebuild chain when effects change
+    setEffectEnabled(EffectType::REVERB, enable);
 }
 
 void SynthEngine::setReverbParameter(int paramId, float value) {
-    if (reverbEffect) {
-        reverbEffect->setParameter(paramId, value);
-    }
+    pushCommand(SynthCommand::Type::REVERB_PARAMETER, paramId, value);
 }
 
 void SynthEngine::enableDelay(bool enable) {
-    if (delayEffect) {
-        delayEffect->setEnabled(enable);
-        rebuildEffectsChain();
-    }
+    setEffectEnabled(EffectType::DELAY, enable);
 }
 
 void SynthEngine::setDelayTime(float timeInSeconds) {
-    if (delayEffect) {
-        delayEffect->setDelayTime(timeInSeconds);
-    }
+    pushCommand(SynthCommand::Type::DELAY_PARAMETER, 0, timeInSeconds);
 }
 
 void SynthEngine::setDelayFeedback(float feedback) {
-    if (delayEffect) {
-        delayEffect->setFeedback(feedback);
-    }
+    pushCommand(SynthCommand::Type::DELAY_PARAMETER, 1, feedback);
 }
 
 void SynthEngine::setDelayWetLevel(float wetLevel) {
-    if (delayEffect) {
-        delayEffect->setWetLevel(wetLevel);
-    }
+    pushCommand(SynthCommand::Type::DELAY_PARAMETER, 2, wetLevel);
 }
 
 void SynthEngine::setDelayDryLevel(float dryLevel) {
-    if (delayEffect) {
-        delayEffect->setDryLevel(dryLevel);
-    }
+    pushCommand(SynthCommand::Type::DELAY_PARAMETER, 3, dryLevel);
 }
 
 void SynthEngine::enableChorus(bool enable) {
-    if (chorusEffect) {
-        chorusEffect->setEnabled(enable);
-        rebuildEffectsChain();
-    }
+    setEffectEnabled(EffectType::CHORUS, enable);
 }
 
 void SynthEngine::setChorusRate(float rate) {
-    if (chorusEffect) {
-        chorusEffect->setRate(rate);
-    }
+    pushCommand(SynthCommand::Type::CHORUS_PARAMETER, 0, rate);
 }
 
 void SynthEngine::setChorusDepth(float depth) {
-    if (chorusEffect) {
-        chorusEffect->setDepth(depth);
-    }
+    pushCommand(SynthCommand::Type::CHORUS_PARAMETER, 1, depth);
 }
 
 void SynthEngine::setChorusVoices(int voices) {
-    if (chorusEffect) {
-        chorusEffect->setVoices(voices);
-    }
+    pushCommand(SynthCommand::Type::CHORUS_PARAMETER, 2, static_cast<float>(voices));
 }
 
 void SynthEngine::setChorusFeedback(float feedback) {
-    if (chorusEffect) {
-        chorusEffect->setFeedback(feedback);
-    }
+    pushCommand(SynthCommand::Type::CHORUS_PARAMETER, 3, feedback);
 }
 
 void SynthEngine::setChorusWetLevel(float wetLevel) {
-    if (chorusEffect) {
-        chorusEffect->setWetLevel(wetLevel);
-    }
+    pushCommand(SynthCommand::Type::CHORUS_PARAMETER, 4, wetLevel);
 }
 
 void SynthEngine::setChorusDryLevel(float dryLevel) {
-    if (chorusEffect) {
-        chorusEffect->setDryLevel(dryLevel);
+    pushCommand(SynthCommand::Type::CHORUS_PARAMETER, 5, dryLevel);
+}
+
+bool SynthEngine::loadImpulseResponse(const juce::String& filePath) {
+    auto impulseResponse = ImpulseResponseLibrary::load(juce::File(filePath));
+    if (!impulseResponse) {
+        Logger::warning("engine", "Could not load impulse response: %s", filePath.toRawUTF8());
+        return false;
     }
+    setImpulseResponse(std::move(impulseResponse));
+    return true;
 }
 
-void SynthEngine::rebuildEffectsChain() {
-    effectsChain.clear();
-    
-    // Effects chain is built in professional order:
-    // 1. Modulation effects (chorus) 
-    // 2. Time-based effects (delay)   
-    // 3. Spatial effects (reverb) 
+void SynthEngine::setImpulseResponse(std::shared_ptr<const ImpulseResponse> impulseResponse) {
+    // The effect hands its new state to the audio thread itself
+    convolutionEffect->setImpulseResponse(std::move(impulseResponse));
+}
 
-    if (chorusEffect && chorusEffect->isActive()) {
-        effectsChain.push_back([this](float sample) {
-            return chorusEffect->processSample(sample);
-        });
+void SynthEngine::enableConvolution(bool enable) {
+    // Switched on, it starts from silence. The empty state is built here and
+    // the audio thread swaps it in with its first convolution block.
+    if (enable && !convolutionRequested) {
+        convolutionEffect->reset();
     }
+    convolutionRequested = enable;
+    pushCommand(SynthCommand::Type::SET_CONVOLUTION_ENABLED, enable ? 1 : 0, 0.0f);
+}
+
+void SynthEngine::setConvolutionWetLevel(float wetLevel) {
+    pushCommand(SynthCommand::Type::CONVOLUTION_PARAMETER, 0, wetLevel);
+}
+
+void SynthEngine::setConvolutionDryLevel(float dryLevel) {
+    pushCommand(SynthCommand::Type::CONVOLUTION_PARAMETER, 1, dryLevel);
+}
 
-    if (delayEffect && delayEffect->isActive()) {
-        effectsChain.push_back([this](float sample) {
-            return delayEffect->processSample(sample);
-        });
+void SynthEngine::setEffectOrder(EffectType first, EffectType second, EffectType third) {
+    EffectOrder order { first, second, third };
+    if (!isValidEffectOrder(order)) {
+        Logger::warning("engine", "Effect order must use each effect once - ignored");
+        return;
     }
-    
-    if (reverbEnabled && reverbEffect && reverbEffect->isActive()) {
-        effectsChain.push_back([this](float sample) {
-            return reverbEffect->processSample(sample);
-        });
+    requestedEffectOrder = order;
+    publishEffectRouting();
+}
+
+EffectOrder SynthEngine::getEffectOrder() const {
+    return requestedEffectOrder;
+}
+
+void SynthEngine::pushCommand(SynthCommand::Type type, int intValue, float floatValue, int64_t position) {
+    SynthCommand command { type, intValue, floatValue, juce::Time::getHighResolutionTicks(), position };
+    if (!commandQueue.push(command)) {
+        Logger::warning("engine", "Command queue full - command dropped");
     }
+}
 
-    
+void SynthEngine::processCommands() {
+    // Audio thread only: drain everything queued since the last block
+    int64_t blockStart = samplePosition.load(std::memory_order_relaxed);
+    SynthCommand command;
+    while (commandQueue.pop(command)) {
+        if (command.samplePosition > blockStart) {
+            scheduleCommand(command);
+        } else {
+            applyCommand(command);
+        }
+    }
 }
 
-float SynthEngine::processEffectsChain(float sample) {
-    // Process sample through each effect in the chain
-    for (auto& effect : effectsChain) {
-        sample = effect(sample);
+void SynthEngine::scheduleCommand(const SynthCommand& command) {
+    // Capacity was reserved up front; if it is somehow exhausted, apply late rather than allocate
+    if (scheduledCommands.size() == scheduledCommands.capacity()) {
+        applyCommand(command);
+        return;
     }
-    return sample;
+
+    // Insert after any command at the same position so equal-time events keep their order
+    auto position = std::upper_bound(scheduledCommands.begin(), scheduledCommands.end(), command,
+        [](const SynthCommand& a, const SynthCommand& b) { return a.samplePosition < b.samplePosition; });
+    scheduledCommands.insert(position, command);
+}
+
+void SynthEngine::applyScheduledCommands(int64_t position) {
+    int due = 0;
+    int numScheduled = static_cast<int>(scheduledCommands.size());
+    while (due < numScheduled && scheduledCommands[due].samplePosition <= position) {
+        applyCommand(scheduledCommands[due]);
+        ++due;
+    }
+    scheduledCommands.erase(scheduledCommands.begin(), scheduledCommands.begin() + due);
+}
+
+void SynthEngine::applyCommand(const SynthCommand& command) {
+    switch (command.type) {
+        case SynthCommand::Type::NOTE_ON: {
+            // Retrigger, take a free voice or steal one
+            DualOscVoice& voice = voicePool.allocateVoice(command.intValue);
+
+            // Apply current global settings to the voice
+            voice.setOsc1Waveform(globalOsc1Waveform);
+            voice.setOsc2Waveform(globalOsc2Waveform);
+            voice.setDetune(globalDetune);
+            voice.setMix(globalMix);
+            voice.setOscillatorMode(globalOscMode);
+            voice.setPan(notePan(command.intValue));
+
+            // Start the note
+            voice.noteOn(midiNoteToFrequency(command.intValue), command.floatValue);
+            break;
+        }
+
+        case SynthCommand::Type::NOTE_OFF: {
+            DualOscVoice* voice = voicePool.findVoice(command.intValue);
+            if (voice != nullptr) {
+                voice->noteOff();
+            }
+            break;
+        }
+
+        case SynthCommand::Type::SET_OSC1_WAVEFORM:
+            globalOsc1Waveform = static_cast<WaveformType>(command.intValue);
+            // Apply to all active voices
+            for (auto& voice : voicePool) {
+                voice.setOsc1Waveform(globalOsc1Waveform);
+            }
+            break;
+
+        case SynthCommand::Type::SET_OSC2_WAVEFORM:
+            globalOsc2Waveform = static_cast<WaveformType>(command.intValue);
+            for (auto& voice : voicePool) {
+                voice.setOsc2Waveform(globalOsc2Waveform);
+            }
+            break;
+
+        case SynthCommand::Type::SET_DETUNE:
+            globalDetune = command.floatValue;
+            for (auto& voice : voicePool) {
+                voice.setDetune(globalDetune);
+            }
+            break;
+
+        case SynthCommand::Type::SET_OSC_MIX:
+            globalMix = command.floatValue;
+            for (auto& voice : voicePool) {
+                voice.setMix(globalMix);
+            }
+            break;
+
+        case SynthCommand::Type::SET_OSC_MODE:
+            globalOscMode = static_cast<OscillatorMode>(command.intValue);
+            for (auto& voice : voicePool) {
+                voice.setOscillatorMode(globalOscMode);
+            }
+            break;
+
+        case SynthCommand::Type::SET_VOICE_STEALING:
+            voicePool.setStealingMode(static_cast<VoiceStealingMode>(command.intValue));
+            break;
+
+        case SynthCommand::Type::SET_STEREO_SPREAD:
+            // Like the other voice settings, applies to notes started from now on
+            stereoSpread = std::clamp(command.floatValue, 0.0f, 1.0f);
+            break;
+
+        case SynthCommand::Type::SET_VOICE_RENDER_MODE:
+            voiceRenderMode = static_cast<VoiceRenderMode>(command.intValue);
+            break;
+
+        case SynthCommand::Type::SET_CUTOFF:
+            cutoffFrequency = command.floatValue;
+            if (filter) {
+                filter->setCutoff(command.floatValue);
+            }
+            voiceFilterCutoff.setTargetValue(std::clamp(command.floatValue, 20.0f, 20000.0f));
+            break;
+
+        case SynthCommand::Type::SET_RESONANCE:
+            if (filter) {
+                filter->setResonance(command.floatValue);
+            }
+            voiceFilterResonance.setTargetValue(std::clamp(command.floatValue, 0.1f, 10.0f));
+            break;
+
+        case SynthCommand::Type::SET_FILTER_MODE:
+            if (filter) {
+                filter->setMode(static_cast<FilterMode>(command.intValue));
+            }
+            voiceFilterSettings.mode = static_cast<FilterMode>(command.intValue);
+            voiceFilterSettings.version++;
+            break;
+
+        case SynthCommand::Type::SET_FILTER_ROUTING:
+            filterRouting = static_cast<FilterRouting>(command.intValue);
+            if (filter) {
+                filter->reset();
+            }
+            voiceFilterSettings.version++;
+            break;
+
+        case SynthCommand::Type::SET_FILTER_KEY_TRACKING:
+            voiceFilterSettings.keyTracking = std::clamp(command.floatValue, 0.0f, 1.0f);
+            voiceFilterSettings.version++;
+            break;
+
+        case SynthCommand::Type::SET_FILTER_VELOCITY:
+            voiceFilterSettings.velocityAmount = std::clamp(command.floatValue, 0.0f, 1.0f);
+            voiceFilterSettings.version++;
+            break;
+
+        case SynthCommand::Type::REVERB_PARAMETER:
+            if (reverbEffect) {
+                reverbEffect->setParameter(command.intValue, command.floatValue);
+            }
+            break;
+
+        case SynthCommand::Type::DELAY_PARAMETER:
+            if (delayEffect) {
+                delayEffect->setParameter(command.intValue, command.floatValue);
+            }
+            break;
+
+        case SynthCommand::Type::CHORUS_PARAMETER:
+            if (chorusEffect) {
+                chorusEffect->setParameter(command.intValue, command.floatValue);
+            }
+            break;
+
+        case SynthCommand::Type::CONVOLUTION_PARAMETER:
+            if (convolutionEffect) {
+                convolutionEffect->setParameter(command.intValue, command.floatValue);
+            }
+            break;
+
+        case SynthCommand::Type::SET_CONVOLUTION_ENABLED:
+            convolutionEnabled = command.intValue != 0;
+            break;
+
+        case SynthCommand::Type::SET_OSCILLOSCOPE_ENABLED:
+            // Switched on, readers see a silent frame rather than a stale one
+            if (command.intValue != 0 && !oscilloscopeEnabled.load(std::memory_order_relaxed)) {
+                std::vector<float>& frame = oscilloscopeFrames.getWriteBuffer();
+                std::fill(frame.begin(), frame.end(), 0.0f);
+                oscilloscopeFrames.publish();
+            }
+            oscilloscopeEnabled.store(command.intValue != 0, std::memory_order_release);
+            break;
+    }
+}
+
+void SynthEngine::setEffectEnabled(EffectType type, bool enable) {
+    if (enable) {
+        requestedEffectMask |= effectMask(type);
+    } else {
+        requestedEffectMask &= ~effectMask(type);
+    }
+    publishEffectRouting();
+}
+
+void SynthEngine::publishEffectRouting() {
+    effectRoutings.publish(new EffectRouting(requestedEffectOrder, requestedEffectMask));
+}
+
+void SynthEngine::adoptPendingRouting() {
+    // The old routing may be deleted once it is handed back, so read it first
+    int previousMask = effectRoutings.get()->enabledMask;
+    if (!effectRoutings.adopt()) {
+        return;
+    }
+    const EffectRouting* activeRouting = effectRoutings.get();
+
+    // Effects switched on start from silence
+    int switchedOn = activeRouting->enabledMask & ~previousMask;
+    if ((switchedOn & effectMask(EffectType::REVERB)) != 0 && reverbEffect) {
+        reverbEffect->reset(); // Clear any existing reverb tail
+    }
+    if (delayEffect) {
+        delayEffect->setEnabled(activeRouting->isEnabled(EffectType::DELAY));
+    }
+    if (chorusEffect) {
+        chorusEffect->setEnabled(activeRouting->isEnabled(EffectType::CHORUS));
+    }
+}
+
+PerformanceMonitor::Clock::time_point SynthEngine::processEffectsChain(float* const* channels, int numChannels,
+                                                                       int numSamples, PerformanceMonitor::Clock::time_point mark) {
+    if (!perEffectTiming.load(std::memory_order_relaxed)) {
+        // One lap for the whole chain; nothing is timed inside it
+        effectRoutings.get()->process(effectSet, channels, numChannels, numSamples, nullptr);
+        return performanceMonitor->lap(PerformanceStage::INSERT_EFFECTS, mark);
+    }
+
+    // The chain interleaves its effects in sub-blocks, so it times each one itself
+    EffectChainTimings timings;
+    effectRoutings.get()->process(effectSet, channels, numChannels, numSamples, &timings);
+    performanceMonitor->addStageTime(PerformanceStage::CHORUS, timings.nanoseconds[static_cast<int>(EffectType::CHORUS)]);
+    performanceMonitor->addStageTime(PerformanceStage::DELAY, timings.nanoseconds[static_cast<int>(EffectType::DELAY)]);
+    performanceMonitor->addStageTime(PerformanceStage::REVERB, timings.nanoseconds[static_cast<int>(EffectType::REVERB)]);
+    return PerformanceMonitor::Clock::now();
+}
+
+bool SynthEngine::hasEffectTails() const {
+    const EffectRouting* routing = effectRoutings.get();
+    if (routing->isEnabled(EffectType::CHORUS) && !chorusEffect->isSleeping()) return true;
+    if (routing->isEnabled(EffectType::DELAY) && !delayEffect->isSleeping()) return true;
+    if (routing->isEnabled(EffectType::REVERB) && !reverbEffect->isSleeping()) return true;
+    return convolutionEnabled && !convolutionEffect->isSleeping();
 }
 
 // AudioSource overrides
 void SynthEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
     currentSampleRate = sampleRate;
+
+    // Voice storage is (re)allocated here so the callback never has to
+    voicePool.prepare(maxPolyphony);
+
+    activeVoiceList.assign(voicePool.getCapacity(), nullptr);
+
+    // Voice mix scratch for block rendering
+    voiceMixBuffer.setSize(NUM_MIX_CHANNELS, std::max(samplesPerBlockExpected, MIN_MIX_BUFFER_SIZE));
+
+    // Oversampled stages get their buffers here too; voices render at the higher rate
+    auto factor = static_cast<OversamplingFactor>(oversamplingFactor.load());
+    voiceOversampler->prepare(factor, voiceMixBuffer.getNumSamples());
+    limiterOversampler->prepare(factor, voiceMixBuffer.getNumSamples());
+    voiceSampleRate = sampleRate * voiceOversampler->getFactor();
+    int maxVoiceBlockSize = voiceMixBuffer.getNumSamples() * voiceOversampler->getFactor();
+
+    // Worker threads are (re)started here so the callback never creates them
+    if (renderThreadCount > 1) {
+        parallelRenderer->prepare(renderThreadCount, maxVoiceBlockSize);
+    } else {
+        parallelRenderer->shutdown();
+    }
+
+    // A new stream starts a new sample clock; events scheduled on the old one are dropped
+    samplePosition = 0;
+    scheduledCommands.clear();
+
+    // Apply anything queued before the device started
+    processCommands();
+    adoptPendingRouting();
+
+    voiceFilterCutoff.reset(sampleRate, FILTER_SMOOTHING_SECONDS);
+    voiceFilterResonance.reset(sampleRate, FILTER_SMOOTHING_SECONDS);
+    voiceFilterSettings.version++;
+
     if (filter) {
         filter->setSampleRate(sampleRate);
     }
@@ -286,123 +693,309 @@ void SynthEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
         chorusEffect->setSampleRate(sampleRate);
     }
 
-    std::cout << "Prepared to play: " << samplesPerBlockExpected << " samples at " << sampleRate << " Hz" << std::endl;
+    if (convolutionEffect) {
+        convolutionEffect->setSampleRate(sampleRate);
+    }
+
+    Logger::info("engine", "Prepared to play: %d samples at %g Hz", samplesPerBlockExpected, sampleRate);
+    Logger::info("engine", "Voice renderer kernel: %s", simdRenderer->getInstructionSetName());
 }
 
 void SynthEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) {
-    // Clear the buffer first
-    bufferToFill.clearActiveBufferRegion();
+    // The host owns this thread, so set flush-to-zero per callback and hand its mode back after
+    ScopedFlushToZero noDenormals;
+
+    performanceMonitor->beginBlock();
+
+    // Pick up control changes before rendering anything
+    processCommands();
+    adoptPendingRouting();
     
-    // Get buffer details
     int numSamples = bufferToFill.numSamples;
-    int numChannels = bufferToFill.buffer->getNumChannels();
-    
-    // Count active voices for gain compensation
-    int activeVoiceCount = 0;
-    for (auto& voicePair : activeVoices) {
-        if (voicePair.second.isActive()) {
-            activeVoiceCount++;
+    int64_t blockStart = samplePosition.load(std::memory_order_relaxed);
+
+    // Split the block at every scheduled event so each one lands on its exact sample
+    int segmentStart = 0;
+    while (segmentStart < numSamples) {
+        applyScheduledCommands(blockStart + segmentStart);
+
+        int segmentEnd = numSamples;
+        if (!scheduledCommands.empty()) {
+            int64_t nextEvent = scheduledCommands.front().samplePosition - blockStart;
+            segmentEnd = static_cast<int>(std::min<int64_t>(nextEvent, numSamples));
         }
+
+        renderSegment(bufferToFill, segmentStart, segmentEnd - segmentStart);
+        segmentStart = segmentEnd;
     }
+
+    if (oscilloscopeEnabled.load(std::memory_order_relaxed)) {
+        // Frames are a fixed size; the part a short block did not reach is silent
+        std::vector<float>& frame = oscilloscopeFrames.getWriteBuffer();
+        if (numSamples < oscilloscopeBufferSize) {
+            std::fill(frame.begin() + numSamples, frame.end(), 0.0f);
+        }
+        oscilloscopeFrames.publish();
+    }
+
+    samplePosition.store(blockStart + numSamples, std::memory_order_relaxed);
+    performanceMonitor->endBlock(numSamples, currentSampleRate);
+}
+
+void SynthEngine::renderSegment(const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples) {
+    // Count active voices for gain compensation
+    activeVoiceListSize = voicePool.collectActiveVoices(activeVoiceList.data());
+    int activeVoiceCount = activeVoiceListSize;
+    performanceMonitor->noteActiveVoices(activeVoiceCount);
     
-    // Skip processing if no active voices
-    if (activeVoiceCount == 0) {
+    // Skip processing once no voice is active and every effect tail has rung
+    // out; until then the mix path runs on silence so the tails play in full
+    if (activeVoiceCount == 0 && !hasEffectTails()) {
+        voiceOversampler->reset();
+        limiterOversampler->reset();
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel) {
+            bufferToFill.buffer->clear(channel, bufferToFill.startSample + startSample, numSamples);
+        }
         
-        if (oscilloscopeEnabled) {
-            int captureSize = std::min(numSamples, oscilloscopeBufferSize);
-            for (int i = 0; i < captureSize; ++i) {
-                oscilloscopeBuffer[i] = 0.0f;
+        if (oscilloscopeEnabled.load(std::memory_order_relaxed)) {
+            int captureEnd = std::min(startSample + numSamples, oscilloscopeBufferSize);
+            std::vector<float>& frame = oscilloscopeFrames.getWriteBuffer();
+            for (int i = startSample; i < captureEnd; ++i) {
+                frame[i] = 0.0f;
             }
         }
         return;
     }
     
     // Calculate polyphonic gain compensation
-    float polyGain = 1.0f / std::sqrt(static_cast<float>(activeVoiceCount));
+    float polyGain = 1.0f / std::sqrt(static_cast<float>(std::max(activeVoiceCount, 1)));
     float masterGain = 0.4f; // Overall volume reduction
     float totalGain = polyGain * masterGain;
     
-    // Generate audio for each sample
-    for (int sample = 0; sample < numSamples; ++sample) {
-        float mixedSample = 0.0f;
+    bool captureScope = oscilloscopeEnabled.load(std::memory_order_relaxed);
+    float* mixLeft = voiceMixBuffer.getWritePointer(0);
+    float* mixRight = voiceMixBuffer.getWritePointer(1);
+    float* mixChannels[] = { mixLeft, mixRight };
+    
+    // Render in chunks that fit the preallocated mix buffer
+    int maxChunkSize = voiceMixBuffer.getNumSamples();
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += maxChunkSize) {
+        int chunkSize = std::min(maxChunkSize, numSamples - chunkStart);
+        int chunkOffset = startSample + chunkStart;
+        auto mark = PerformanceMonitor::Clock::now();
         
-        // Sum all active voices
-        for (auto& voicePair : activeVoices) {
-            DualOscVoice& voice = voicePair.second;
-            if (voice.isActive()) {
-                mixedSample += voice.generateSample(currentSampleRate);
-            }
+        // Sum whole blocks from every active voice (filtered per voice if routed so)
+        updateVoiceFilters(chunkSize);
+        if (voiceOversampler->getFactor() > 1) {
+            int voiceSamples = chunkSize * voiceOversampler->getFactor();
+            float* const* voiceChannels = voiceOversampler->getOversampledChannels();
+            juce::FloatVectorOperations::clear(voiceChannels[0], voiceSamples);
+            juce::FloatVectorOperations::clear(voiceChannels[1], voiceSamples);
+            renderVoices(voiceChannels[0], voiceChannels[1], voiceSamples);
+            voiceOversampler->processDown(mixChannels, NUM_MIX_CHANNELS, chunkSize);
+        } else {
+            voiceMixBuffer.clear(0, chunkSize);
+            renderVoices(mixLeft, mixRight, chunkSize);
         }
         
         // Apply polyphonic gain compensation
-        mixedSample *= totalGain;
+        juce::FloatVectorOperations::multiply(mixLeft, totalGain, chunkSize);
+        juce::FloatVectorOperations::multiply(mixRight, totalGain, chunkSize);
+        mark = performanceMonitor->lap(PerformanceStage::VOICES, mark);
 
         //any filters applied are processed after gain compensation
-        if (filter) {
-            mixedSample = filter->processSample(mixedSample);
+        if (filter && filterRouting == FilterRouting::MASTER) {
+            filter->processBlock(mixChannels, NUM_MIX_CHANNELS, chunkSize);
+            mark = performanceMonitor->lap(PerformanceStage::FILTER, mark);
         }
 
-        if (!effectsChain.empty()) {
-            mixedSample = processEffectsChain(mixedSample);
+        if (effectRoutings.get()->process != nullptr) {
+            mark = processEffectsChain(mixChannels, NUM_MIX_CHANNELS, chunkSize, mark);
+        }
+
+        if (convolutionEnabled && convolutionEffect->beginBlock(mixChannels, NUM_MIX_CHANNELS, chunkSize)) {
+            convolutionEffect->processBlock(mixChannels, NUM_MIX_CHANNELS, chunkSize);
+            convolutionEffect->endBlock(mixChannels, NUM_MIX_CHANNELS, chunkSize);
+            if (convolutionEffect->takeLateJobs() > 0) {
+                performanceMonitor->noteOverrun();
+            }
+            mark = performanceMonitor->lap(PerformanceStage::CONVOLUTION, mark);
         }
         
         // Soft limiter to prevent harsh clipping
-        if (mixedSample > 0.95f) {
-            mixedSample = 0.95f + 0.05f * std::tanh((mixedSample - 0.95f) / 0.05f);
-        } else if (mixedSample < -0.95f) {
-            mixedSample = -0.95f + 0.05f * std::tanh((mixedSample + 0.95f) / 0.05f);
-        }
-
-        //Oscilloscope data capture
-        if (oscilloscopeEnabled && sample < oscilloscopeBufferSize) {
-            oscilloscopeBuffer[sample] = mixedSample;
+        applyLimiter(mixChannels, chunkSize);
+        performanceMonitor->lap(PerformanceStage::LIMITER, mark);
+
+        //Oscilloscope data capture (mono sum of the stereo mix)
+        int captureCount = std::min(chunkSize, oscilloscopeBufferSize - chunkOffset);
+        if (captureScope && captureCount > 0) {
+            float* scope = oscilloscopeFrames.getWriteBuffer().data() + chunkOffset;
+            juce::FloatVectorOperations::copyWithMultiply(scope, mixLeft, 0.5f, captureCount);
+            juce::FloatVectorOperations::addWithMultiply(scope, mixRight, 0.5f, captureCount);
         }
         
-        // Write to all output channels
-        for (int channel = 0; channel < numChannels; ++channel) {
-            bufferToFill.buffer->addSample(channel, bufferToFill.startSample + sample, mixedSample);
+        writeOutput(bufferToFill, chunkOffset, chunkSize);
+    }
+}
+
+void SynthEngine::applyLimiter(float* const* channels, int numSamples) {
+    int factor = limiterOversampler->getFactor();
+    float* const* limited = channels;
+    if (factor > 1) {
+        limited = limiterOversampler->processUp(channels, NUM_MIX_CHANNELS, numSamples);
+    }
+
+    // Above the knee: |y| = 0.95 + 0.05 * tanh(excess / 0.05). Written as a
+    // correction that is exactly zero below the knee, so whole chunks go
+    // through the block tanh without branches and quiet chunks are skipped.
+    constexpr float KNEE = 0.95f;
+    constexpr float RANGE = 0.05f;
+    constexpr int LIMITER_CHUNK = 64;
+    float excess[LIMITER_CHUNK];
+    float shaped[LIMITER_CHUNK];
+
+    for (int channel = 0; channel < NUM_MIX_CHANNELS; ++channel) {
+        float* samples = limited[channel];
+        for (int start = 0; start < numSamples * factor; start += LIMITER_CHUNK) {
+            int count = std::min(LIMITER_CHUNK, numSamples * factor - start);
+            float* chunk = samples + start;
+            float peakExcess = 0.0f;
+            for (int i = 0; i < count; ++i) {
+                excess[i] = std::max(std::abs(chunk[i]) - KNEE, 0.0f);
+                shaped[i] = excess[i] * (1.0f / RANGE);
+                peakExcess = std::max(peakExcess, excess[i]);
+            }
+            if (peakExcess == 0.0f) continue;
+
+            FastMath::tanh(shaped, shaped, count);
+            for (int i = 0; i < count; ++i) {
+                chunk[i] += std::copysign(RANGE * shaped[i] - excess[i], chunk[i]);
+            }
         }
     }
-    
-    // Clean up inactive voices
-    auto it = activeVoices.begin();
-    while (it != activeVoices.end()) {
-        if (!it->second.isActive()) {
-            it = activeVoices.erase(it);
-        } else {
-            ++it;
-        }
+
+    if (factor > 1) {
+        limiterOversampler->processDown(channels, NUM_MIX_CHANNELS, numSamples);
+    }
+}
+
+void SynthEngine::writeOutput(const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples) {
+    const float* mix[] = { voiceMixBuffer.getReadPointer(0), voiceMixBuffer.getReadPointer(1) };
+    int numChannels = bufferToFill.buffer->getNumChannels();
+    int outputStart = bufferToFill.startSample + startSample;
+
+    // Mono devices get the downmix; wider layouts repeat left/right
+    if (numChannels == 1) {
+        float* out = bufferToFill.buffer->getWritePointer(0, outputStart);
+        juce::FloatVectorOperations::copyWithMultiply(out, mix[0], 0.5f, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(out, mix[1], 0.5f, numSamples);
+        return;
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        juce::FloatVectorOperations::copy(bufferToFill.buffer->getWritePointer(channel, outputStart),
+                                          mix[channel % NUM_MIX_CHANNELS], numSamples);
+    }
+}
+
+void SynthEngine::updateVoiceFilters(int numSamples) {
+    bool perVoice = filterRouting == FilterRouting::PER_VOICE;
+    if (voiceFilterSettings.enabled != perVoice) {
+        voiceFilterSettings.enabled = perVoice;
+        voiceFilterSettings.version++;
+    }
+    if (!perVoice) {
+        // Keep the glides moving so switching routing never jumps back in time
+        voiceFilterCutoff.skip(numSamples);
+        voiceFilterResonance.skip(numSamples);
+    } else if (voiceFilterCutoff.isSmoothing() || voiceFilterResonance.isSmoothing()
+               || voiceFilterSettings.cutoff != voiceFilterCutoff.getTargetValue()
+               || voiceFilterSettings.resonance != voiceFilterResonance.getTargetValue()) {
+        // Coefficients follow a glide in chunk-sized steps
+        voiceFilterSettings.cutoff = voiceFilterCutoff.skip(numSamples);
+        voiceFilterSettings.resonance = voiceFilterResonance.skip(numSamples);
+        voiceFilterSettings.version++;
+    }
+
+    for (int i = 0; i < activeVoiceListSize; ++i) {
+        activeVoiceList[i]->updateFilter(voiceFilterSettings, voiceSampleRate);
+    }
+}
+
+void SynthEngine::renderVoices(float* left, float* right, int numSamples) {
+    DualOscVoice* const* voices = activeVoiceList.data();
+
+    // Only worth waking workers when each thread gets at least one full task
+    if (parallelRenderer->isRunning()
+        && activeVoiceListSize >= MIN_VOICES_PER_THREAD * parallelRenderer->getNumThreads()) {
+        parallelRenderer->render(voices, activeVoiceListSize, left, right, numSamples, voiceSampleRate, voiceRenderMode);
+        return;
+    }
+
+    if (voiceRenderMode == VoiceRenderMode::SIMD && simdRenderer) {
+        simdRenderer->render(voices, activeVoiceListSize, left, right, numSamples, voiceSampleRate);
+        return;
+    }
+
+    for (int i = 0; i < activeVoiceListSize; ++i) {
+        voices[i]->renderBlock(left, right, numSamples, voiceSampleRate);
     }
 }
 
 void SynthEngine::releaseResources() {
-    // Clear all voices when audio stops
-    activeVoices.clear();
-    std::cout << "Audio resources released" << std::endl;
+    // Clear all voices and stop render workers when audio stops
+    voicePool.releaseAll();
+    parallelRenderer->shutdown();
+    Logger::info("engine", "Audio resources released");
+}
+
+float SynthEngine::notePan(int midiNote) const {
+    // Middle C in the centre, two octaves either way to the edges at full spread
+    static constexpr int CENTRE_NOTE = 60;
+    static constexpr float NOTES_TO_EDGE = 24.0f;
+    return stereoSpread * std::clamp((midiNote - CENTRE_NOTE) / NOTES_TO_EDGE, -1.0f, 1.0f);
 }
 
 float SynthEngine::midiNoteToFrequency(int midiNote) {
     // A4 (MIDI note 69) = 440 Hz
     // Each semitone = 2^(1/12) frequency ratio
-    return 440.0f * std::pow(2.0f, (midiNote - 69) / 12.0f);
+    return 440.0f * FastMath::exp2((midiNote - 69) / 12.0f);
 }
 
 void SynthEngine::enableOscilloscope(bool enable) {
-    oscilloscopeEnabled = enable;
-    if (enable) {
-        oscilloscopeBuffer.resize(oscilloscopeBufferSize);
-        std::fill(oscilloscopeBuffer.begin(), oscilloscopeBuffer.end(), 0.0f);
-        DBG("Oscilloscope enabled");
-    } else {
-        DBG("Oscilloscope disabled");
+    // The audio thread owns the capture frames, so it applies the switch
+    pushCommand(SynthCommand::Type::SET_OSCILLOSCOPE_ENABLED, enable ? 1 : 0, 0.0f);
+
+    Logger::verbose("engine", "Oscilloscope %s", enable ? "enabled" : "disabled");
+}
+
+PerformanceSnapshot SynthEngine::getPerformanceStats() const {
+    PerformanceSnapshot snapshot = performanceMonitor->getSnapshot();
+
+    // Never on the audio thread, so waiting for a device change is fine here
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    auto* device = audioDeviceRunning ? audioDeviceManager.getCurrentAudioDevice() : nullptr;
+    if (device != nullptr) {
+        snapshot.xrunCount = device->getXRunCount();
     }
+    return snapshot;
+}
+
+void SynthEngine::resetPerformanceStats() {
+    performanceMonitor->reset();
+}
+
+void SynthEngine::setPerEffectTiming(bool enable) {
+    perEffectTiming.store(enable, std::memory_order_relaxed);
 }
 
 int SynthEngine::getWaveformData(float* buffer, int bufferSize) {
-    if (!oscilloscopeEnabled || !buffer) return 0;
+    if (!oscilloscopeEnabled.load(std::memory_order_acquire) || !buffer) return 0;
 
-    int samplesAvailable = std::min(bufferSize, (int)oscilloscopeBuffer.size());
-    std::copy(oscilloscopeBuffer.begin(), oscilloscopeBuffer.begin() + samplesAvailable, buffer);
+    // The latest complete frame; the audio thread never writes the one read here
+    const std::vector<float>& frame = oscilloscopeFrames.read();
+    int samplesAvailable = std::min(bufferSize, (int)frame.size());
+    std::copy(frame.begin(), frame.begin() + samplesAvailable, buffer);
 
     return samplesAvailable;
 }
\ No newline at end of file
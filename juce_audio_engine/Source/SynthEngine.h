@@ -3,14 +3,26 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_core/juce_core.h>
-#include <map>
 #include <vector>
-#include <functional>
+#include <atomic>
+#include <mutex>
 #include "Oscillator.h"
+#include "VoicePool.h"
+#include "SimdVoiceRenderer.h"
+#include "ParallelVoiceRenderer.h"
+#include "SpscQueue.h"
+#include "RcuPublisher.h"
+#include "TripleBuffer.h"
+#include "SynthCommand.h"
+#include "PerformanceMonitor.h"
 #include "Effects/Filter.h" 
 #include "Effects/ReverbEffect.h"
 #include "Effects/DelayEffect.h"
 #include "Effects/ChorusEffect.h"
+#include "Effects/EffectChain.h"
+#include "Effects/ConvolutionReverb.h"
+#include "Effects/Oversampler.h"
+#include "ImpulseResponseLibrary.h"
 
 #ifdef _WIN32
     #ifdef JUCE_DLL_BUILD
@@ -22,6 +34,12 @@
     #define SYNTH_API
 #endif
 
+// Where the cutoff/resonance/mode filter runs
+enum class FilterRouting {
+    MASTER = 0,     // One filter on the summed voice mix (paraphonic)
+    PER_VOICE = 1   // Every voice filtered separately, vectorized across voices
+};
+
 class SYNTH_API SynthEngine : public juce::AudioSource {
 public:
     SynthEngine();
@@ -31,15 +49,54 @@ public:
     void shutdownAudio();
     void setCutoff(float value);
     void setResonance(float value);
+    void setFilterMode(FilterMode mode);
+    void setFilterRouting(FilterRouting routing);
+    void setFilterKeyTracking(float amount);        // 0 - 1 (per-voice routing only)
+    void setFilterVelocityAmount(float amount);     // 0 - 1 (per-voice routing only)
     void noteOn(int midiNote, float velocity);
     void noteOff(int midiNote);
+
+    // Sample-accurate variants: the event lands on the given position of the
+    // engine's sample clock (see getSamplePosition). Positions already rendered
+    // are applied at the start of the next block.
+    void noteOnAt(int midiNote, float velocity, int64_t samplePosition);
+    void noteOffAt(int midiNote, int64_t samplePosition);
+
+    // Samples rendered since the last prepareToPlay
+    int64_t getSamplePosition() const;
     
     // New dual oscillator controls
     void setOsc1Waveform(WaveformType type);
     void setOsc2Waveform(WaveformType type);
     void setDetune(float cents);
     void setOscMix(float mix);
+    void setOscillatorMode(OscillatorMode mode);
+
+    // Pans new notes across the stereo field by pitch: 0 = all centred,
+    // 1 = two octaves either side of middle C reach the edges
+    void setStereoSpread(float spread);
+
+    // Polyphony controls (max polyphony takes effect on the next prepareToPlay)
+    void setMaxPolyphony(int voices);
+    void setVoiceStealingMode(VoiceStealingMode mode);
+    void setVoiceRenderMode(VoiceRenderMode mode);
+
+    // Number of threads (including the audio thread) used to render voices.
+    // 1 disables multithreaded rendering; takes effect on the next prepareToPlay.
+    void setRenderThreads(int numThreads);
+
+    // Runs the oscillators and the output limiter at a multiple of the device
+    // rate to push their aliasing out of the audio band, at a proportional CPU
+    // cost. Takes effect on the next prepareToPlay.
+    void setOversampling(OversamplingFactor factor);
     
+    // Offline (pull-mode) rendering without an audio device.
+    // Uses the same getNextAudioBlock path as the device callback; refused
+    // while initializeAudio() has a device running.
+    bool prepareOfflineRender(double sampleRate, int maxBlockSize);
+    bool renderOffline(float* const* channels, int numChannels, int numSamples);
+    bool renderOfflineInterleaved(float* interleaved, int numChannels, int numFrames);
+
     // AudioSource overrides
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
@@ -65,28 +122,96 @@ public:
     void setChorusWetLevel(float wetLevel);
     void setChorusDryLevel(float dryLevel);
 
-    //methods to managed oscilloscope visualisation
+    //convolution reverb controls; runs after the insert chain. Loading decodes
+    //the file and builds its kernel on the calling thread. Engines loading the
+    //same file share one copy of it.
+    bool loadImpulseResponse(const juce::String& filePath);
+    void setImpulseResponse(std::shared_ptr<const ImpulseResponse> impulseResponse);
+    void enableConvolution(bool enable);
+    void setConvolutionWetLevel(float wetLevel);
+    void setConvolutionDryLevel(float dryLevel);
+
+    //effect ordering; must be a permutation of all three effects, otherwise ignored
+    void setEffectOrder(EffectType first, EffectType second, EffectType third);
+    EffectOrder getEffectOrder() const;
+
+    //methods to managed oscilloscope visualisation (read from one thread at a time)
     void enableOscilloscope(bool enable);
     int getWaveformData(float* buffer, int bufferSize);
 
+    //audio callback timing since the last reset (see PerformanceMonitor); safe
+    //from any thread but the audio thread, as reading the device's xrun count
+    //waits out a device being opened or closed. A reset takes effect at the
+    //start of the next block.
+    PerformanceSnapshot getPerformanceStats() const;
+    void resetPerformanceStats();
+
+    //off by default: the insert chain is timed as one stage. On, chorus, delay
+    //and reverb are timed separately, at two clock reads per effect per sub-block.
+    void setPerEffectTiming(bool enable);
+
 private:
-    // Replace simple Voice with DualOscVoice
-    std::map<int, DualOscVoice> activeVoices;
+    // Preallocated voices - no allocation when notes start or stop
+    VoicePool voicePool;
+    std::atomic<int> maxPolyphony;
+
+    // Control thread -> audio thread commands, drained at the start of each block
+    static constexpr int COMMAND_QUEUE_SIZE = 1024;
+    SpscQueue<SynthCommand> commandQueue;
+
+    // Future commands waiting for their sample, sorted by position (audio thread only)
+    std::vector<SynthCommand> scheduledCommands;
+    std::atomic<int64_t> samplePosition;
+
+    // Voices render whole blocks into this stereo buffer before the filter/effects stage
+    static constexpr int MIN_MIX_BUFFER_SIZE = 512;
+    static constexpr int NUM_MIX_CHANNELS = 2;
+    juce::AudioBuffer<float> voiceMixBuffer;
+
+    // Lane-parallel alternative to rendering voices one at a time
+    std::unique_ptr<SimdVoiceRenderer> simdRenderer;
+    VoiceRenderMode voiceRenderMode;
+
+    // Optional worker pool that splits the active voices across threads
+    static constexpr int MIN_VOICES_PER_THREAD = ParallelVoiceRenderer::VOICES_PER_TASK;
+    std::unique_ptr<ParallelVoiceRenderer> parallelRenderer;
+    std::atomic<int> renderThreadCount;
+
+    // Active voices gathered once per block, sized to the pool capacity
+    std::vector<DualOscVoice*> activeVoiceList;
+    int activeVoiceListSize;
     
     // Global oscillator parameters (applied to new voices)
     WaveformType globalOsc1Waveform;
     WaveformType globalOsc2Waveform;
     float globalDetune;
     float globalMix;
+    OscillatorMode globalOscMode;
+    float stereoSpread;
     
     float cutoffFrequency;
     double currentSampleRate;
 
-    std::unique_ptr<LowpassFilter> filter;
+    // Voices render at voiceSampleRate (the device rate times the oversampling
+    // factor) into voiceOversampler, which decimates them into the mix buffer.
+    // The limiter runs inside limiterOversampler.
+    std::atomic<int> oversamplingFactor;
+    std::unique_ptr<Oversampler> voiceOversampler;
+    std::unique_ptr<Oversampler> limiterOversampler;
+    double voiceSampleRate;
+
+    std::unique_ptr<StateVariableFilter> filter;
+
+    // Per-voice filter settings; cutoff/resonance glide here and are pushed to
+    // voices once per chunk via voiceFilterSettings.version
+    FilterRouting filterRouting;
+    VoiceFilterSettings voiceFilterSettings;
+    SmoothedParameter voiceFilterCutoff;
+    SmoothedParameter voiceFilterResonance;
+    static constexpr double FILTER_SMOOTHING_SECONDS = 0.02;
 
     // system for reverb effect
     std::unique_ptr<ReverbEffect> reverbEffect;
-    bool reverbEnabled;
 
     // system for delay effect
     std::unique_ptr<DelayEffect> delayEffect;
@@ -94,23 +219,85 @@ private:
     //system for chorus effect
     std::unique_ptr<ChorusEffect> chorusEffect;
 
-    //system to manage oscilloscope visualisation
-    std::vector<float> oscilloscopeBuffer;
+    //system for convolution reverb (enabled flag is audio thread only,
+    //requested flag is the control thread's copy)
+    std::unique_ptr<ConvolutionReverb> convolutionEffect;
+    bool convolutionEnabled;
+    bool convolutionRequested;
 
-    //variables governing oscilloscope
-    bool oscilloscopeEnabled;
+    //system to manage oscilloscope visualisation: the audio thread fills one
+    //frame per block and publishes it, getWaveformData reads the latest one
+    TripleBuffer<std::vector<float>> oscilloscopeFrames;
+
+    //variables governing oscilloscope (enabled flag is written by the audio thread)
+    std::atomic<bool> oscilloscopeEnabled;
     int oscilloscopeBufferSize;
 
-    //vector structure to manage multiple effects at once
-    std::vector<std::function<float(float)>> effectsChain;
+    //per-block render timing, written by the audio thread
+    std::unique_ptr<PerformanceMonitor> performanceMonitor;
+    std::atomic<bool> perEffectTiming;
+
+    // Effect routing, published RCU-style: the control thread builds a new
+    // immutable EffectRouting and the audio thread adopts it at the start of
+    // a block
+    static constexpr int RETIRED_ROUTING_QUEUE_SIZE = 16;
+    EffectSet effectSet;
+    EffectOrder requestedEffectOrder;       // Control thread only
+    int requestedEffectMask;                // Control thread only
+    RcuPublisher<EffectRouting> effectRoutings;
     
-    // Audio device management
+    // Audio device management. deviceMutex is held while the device is opened
+    // or closed and while other threads query it, so a stats poll never sees
+    // a device that is being deleted.
     juce::AudioDeviceManager audioDeviceManager;
     juce::AudioSourcePlayer audioSourcePlayer;
+    std::atomic<bool> audioDeviceRunning;
+    mutable std::mutex deviceMutex;
+
+    // Offline rendering state
+    static constexpr int MAX_OFFLINE_CHANNELS = 8;
+    static constexpr int DEFAULT_OFFLINE_BLOCK_SIZE = 512;
+    juce::AudioBuffer<float> offlineBuffer;    // Planar scratch for interleaved renders
+    int offlineBlockSize;
+    bool offlinePrepared;
     
     float midiNoteToFrequency(int midiNote);
 
+    //methods to hand control changes to the audio thread
+    void pushCommand(SynthCommand::Type type, int intValue, float floatValue,
+                     int64_t samplePosition = SynthCommand::IMMEDIATE);
+    void processCommands();
+    void applyCommand(const SynthCommand& command);
+    void scheduleCommand(const SynthCommand& command);
+    void applyScheduledCommands(int64_t position);
+
+    //renders one stretch of the block that has no events inside it
+    void renderSegment(const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples);
+
+    //advances per-voice filter glides and refreshes each active voice's coefficients
+    void updateVoiceFilters(int numSamples);
+
+    //sums every active voice into the mix buffer using the current render mode
+    void renderVoices(float* left, float* right, int numSamples);
+
+    //soft-clips the stereo mix above 0.95, oversampled if enabled
+    void applyLimiter(float* const* channels, int numSamples);
+
+    //copies the finished stereo mix into the device channels, one channel block at a time
+    void writeOutput(const juce::AudioSourceChannelInfo& bufferToFill, int startSample, int numSamples);
+
+    float notePan(int midiNote) const;
+
+    static int clampRenderThreads(int numThreads);
+
     //methods to handle effects chain
-    void rebuildEffectsChain();
-    float processEffectsChain(float sample);
+    void setEffectEnabled(EffectType type, bool enable);
+    void publishEffectRouting();
+    void adoptPendingRouting();
+    // Runs the insert chain and charges its time from mark; returns the new mark
+    PerformanceMonitor::Clock::time_point processEffectsChain(float* const* channels, int numChannels, int numSamples,
+                                                             PerformanceMonitor::Clock::time_point mark);
+
+    //true while an enabled effect still has a tail to ring out (see Effect::isSleeping)
+    bool hasEffectTails() const;
 };
\ No newline at end of file
@@ -0,0 +1,482 @@
+// C++ Benchmarks for JUCE Audio Engine
+//
+// Times the hot audio paths in isolation:
+// - Effect chain dispatch (std::function, virtual, fused)
+// - Reverb algorithms (parallel combs vs feedback delay network)
+// - Convolution reverb with a long impulse response
+// - Half-band oversampling round trips at 2x, 4x and 8x
+// - FastMath approximations against libm
+// - Idle effects on silent input, always processed vs sleeping
+// - Per-block cost through a 30-second reverb decay (denormal protection)
+// - Logging a note event: blocking console write vs the lock-free logger
+// - Cost of the audio callback performance counters
+
+#include <iostream>
+#include <cstdio>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "../Source/SynthEngine.h"
+#include "../Source/FastMath.h"
+#include "../Source/Logger.h"
+#include "../Source/Effects/Denormals.h"
+
+class SynthEngineBenchmarks {
+private:
+    static constexpr double SAMPLE_RATE = 48000.0;
+    static constexpr int BLOCK_SIZE = 512;
+    static constexpr int NUM_BLOCKS = 4000;
+
+    // Runs processBlock over NUM_BLOCKS blocks and returns nanoseconds per sample
+    static double timeBlocks(const std::function<void(float*, int)>& processBlock) {
+        std::vector<float> buffer(BLOCK_SIZE);
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < NUM_BLOCKS; ++block) {
+            for (int i = 0; i < BLOCK_SIZE; ++i) {
+                buffer[i] = std::sin(0.01f * (block * BLOCK_SIZE + i)) * 0.5f;
+            }
+            processBlock(buffer.data(), BLOCK_SIZE);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / (double(NUM_BLOCKS) * BLOCK_SIZE);
+    }
+
+    // Runs process NUM_BLOCKS times and returns nanoseconds per sample of BLOCK_SIZE blocks;
+    // for kernels whose input is prepared once up front
+    static double timeRepeated(const std::function<void()>& process) {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < NUM_BLOCKS; ++block) {
+            process();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / (double(NUM_BLOCKS) * BLOCK_SIZE);
+    }
+
+    static void prepareEffects(ChorusEffect& chorus, DelayEffect& delay, ReverbEffect& reverb) {
+        chorus.setSampleRate(SAMPLE_RATE);
+        chorus.setEnabled(true);
+        chorus.setVoices(4);
+        delay.setSampleRate(SAMPLE_RATE);
+        delay.setDelayTime(0.25f);
+        delay.setFeedback(0.4f);
+        reverb.setSampleRate(SAMPLE_RATE);
+    }
+
+    static void printResult(const char* name, double nsPerSample, double baseline) {
+        std::cout << "  " << std::left << std::setw(36) << name
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(8) << nsPerSample << " ns/sample"
+                  << std::setw(8) << baseline / nsPerSample << "x" << std::endl;
+    }
+
+    static void benchmarkEffectChain() {
+        std::cout << "Effect chain (chorus -> delay -> reverb, " << BLOCK_SIZE << "-sample blocks):" << std::endl;
+
+        // Per-sample std::function list, the shape of the original chain
+        ChorusEffect chorusA;
+        DelayEffect delayA;
+        ReverbEffect reverbA;
+        prepareEffects(chorusA, delayA, reverbA);
+        std::vector<std::function<float(float)>> functionChain = {
+            [&](float s) { return chorusA.processSample(s); },
+            [&](float s) { return delayA.processSample(s); },
+            [&](float s) { return reverbA.processSample(s); }
+        };
+        double functionTime = timeBlocks([&](float* data, int numSamples) {
+            for (int i = 0; i < numSamples; ++i) {
+                for (auto& effect : functionChain) {
+                    data[i] = effect(data[i]);
+                }
+            }
+        });
+
+        // Virtual processBlock per effect over the whole block
+        ChorusEffect chorusB;
+        DelayEffect delayB;
+        ReverbEffect reverbB;
+        prepareEffects(chorusB, delayB, reverbB);
+        std::vector<Effect*> virtualChain = { &chorusB, &delayB, &reverbB };
+        double virtualTime = timeBlocks([&](float* data, int numSamples) {
+            float* channels[] = { data };
+            for (Effect* effect : virtualChain) {
+                effect->processBlock(channels, 1, numSamples);
+            }
+        });
+
+        // Precompiled chain, as selected by SynthEngine
+        ChorusEffect chorusC;
+        DelayEffect delayC;
+        ReverbEffect reverbC;
+        prepareEffects(chorusC, delayC, reverbC);
+        EffectSet effectSet(&chorusC, &delayC, &reverbC);
+        EffectOrder order { EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB };
+        EffectChainFunction fusedChain = selectEffectChain(order, 0x7);
+        double fusedTime = timeBlocks([&](float* data, int numSamples) {
+            float* channels[] = { data };
+            fusedChain(effectSet, channels, 1, numSamples, nullptr);
+        });
+
+        printResult("std::function per sample", functionTime, functionTime);
+        printResult("virtual processBlock per effect", virtualTime, functionTime);
+        printResult("fused EffectChain", fusedTime, functionTime);
+    }
+
+    static void benchmarkReverbAlgorithms() {
+        std::cout << "Reverb algorithms (stereo, " << BLOCK_SIZE << "-sample blocks):" << std::endl;
+        
+        std::vector<float> right(BLOCK_SIZE);
+        auto timeReverb = [&](ReverbAlgorithm algorithm) {
+            ReverbEffect reverb;
+            reverb.setAlgorithm(algorithm);
+            reverb.setSampleRate(SAMPLE_RATE);
+            return timeBlocks([&](float* data, int numSamples) {
+                std::copy(data, data + numSamples, right.data());
+                float* channels[] = { data, right.data() };
+                reverb.processBlock(channels, 2, numSamples);
+            });
+        };
+        double combTime = timeReverb(ReverbAlgorithm::COMB);
+        double fdnTime = timeReverb(ReverbAlgorithm::FDN);
+        
+        printResult("4+4 parallel combs", combTime, combTime);
+        printResult("8-line FDN", fdnTime, combTime);
+    }
+
+    static void benchmarkConvolutionReverb() {
+        const int irSeconds = 4;
+        std::cout << "Convolution reverb (stereo, " << irSeconds << " s stereo IR at " << static_cast<int>(SAMPLE_RATE)
+                  << " Hz, " << BLOCK_SIZE << "-sample blocks):" << std::endl;
+        
+        int irLength = static_cast<int>(irSeconds * SAMPLE_RATE);
+        std::vector<std::vector<float>> irChannels(2, std::vector<float>(irLength));
+        for (int channel = 0; channel < 2; ++channel) {
+            for (int i = 0; i < irLength; ++i) {
+                float noise = ((i * 7919 + channel * 104729) % 1009) / 1009.0f - 0.5f;
+                irChannels[channel][i] = noise * std::exp(-6.9f * i / irLength);
+            }
+        }
+        auto impulseResponse = std::make_shared<const ImpulseResponse>(irChannels, SAMPLE_RATE);
+        
+        std::vector<float> right(BLOCK_SIZE);
+        auto timeConvolution = [&](bool background) {
+            ConvolutionReverb reverb;
+            reverb.setBackgroundProcessing(background);
+            reverb.setSampleRate(SAMPLE_RATE);
+            reverb.setImpulseResponse(impulseResponse);
+            return timeBlocks([&](float* data, int numSamples) {
+                std::copy(data, data + numSamples, right.data());
+                float* channels[] = { data, right.data() };
+                reverb.processBlock(channels, 2, numSamples);
+            });
+        };
+        double inlineTime = timeConvolution(false);
+        double backgroundTime = timeConvolution(true);
+        
+        printResult("non-uniform, all on audio thread", inlineTime, inlineTime);
+        printResult("non-uniform, late stages background", backgroundTime, inlineTime);
+        std::cout << "  " << std::fixed << std::setprecision(1)
+                  << "Total load " << inlineTime * SAMPLE_RATE * 1.0e-7 << "% of one core, audio thread "
+                  << backgroundTime * SAMPLE_RATE * 1.0e-7 << "%" << std::endl;
+    }
+
+    static void benchmarkOversampling() {
+        std::cout << "Oversampling round trip (stereo, " << BLOCK_SIZE << "-sample blocks):" << std::endl;
+        
+        std::vector<float> right(BLOCK_SIZE);
+        auto timeRoundTrip = [&](OversamplingFactor factor) {
+            Oversampler oversampler;
+            oversampler.prepare(factor, BLOCK_SIZE);
+            return timeBlocks([&](float* data, int numSamples) {
+                std::copy(data, data + numSamples, right.data());
+                float* channels[] = { data, right.data() };
+                oversampler.processUp(channels, 2, numSamples);
+                oversampler.processDown(channels, 2, numSamples);
+            });
+        };
+        double x2Time = timeRoundTrip(OversamplingFactor::X2);
+        double x4Time = timeRoundTrip(OversamplingFactor::X4);
+        double x8Time = timeRoundTrip(OversamplingFactor::X8);
+        
+        printResult("2x up + down", x2Time, x2Time);
+        printResult("4x up + down", x4Time, x2Time);
+        printResult("8x up + down", x8Time, x2Time);
+    }
+
+    static void benchmarkFastMath() {
+        std::cout << "Fast math (" << FastMath::getInstructionSetName() << " block kernel, "
+                  << BLOCK_SIZE << "-sample blocks):" << std::endl;
+        
+        // Inputs are generated once so only the function itself is timed
+        std::vector<float> input(BLOCK_SIZE), output(BLOCK_SIZE);
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            input[i] = 0.5f + 0.49f * std::sin(0.01f * i);
+        }
+        auto timeLibm = [&](float (*function)(float), float scale) {
+            return timeRepeated([&] {
+                for (int i = 0; i < BLOCK_SIZE; ++i) {
+                    output[i] = function(input[i] * scale);
+                }
+            });
+        };
+        auto timeBlock = [&](void (*function)(const float*, float*, int)) {
+            return timeRepeated([&] { function(input.data(), output.data(), BLOCK_SIZE); });
+        };
+        
+        double sinTime = timeLibm([](float x) { return std::sin(x); }, 2.0f * 3.14159265f);
+        double exp2Time = timeLibm([](float x) { return std::exp2(x); }, 1.0f);
+        double log2Time = timeLibm([](float x) { return std::log2(x); }, 1.0f);
+        double tanhTime = timeLibm([](float x) { return std::tanh(x); }, 1.0f);
+        
+        printResult("std::sin", sinTime, sinTime);
+        printResult("FastMath::sin2Pi", timeBlock(FastMath::sin2Pi), sinTime);
+        printResult("std::exp2", exp2Time, exp2Time);
+        printResult("FastMath::exp2", timeBlock(FastMath::exp2), exp2Time);
+        printResult("std::log2", log2Time, log2Time);
+        printResult("FastMath::log2", timeBlock(FastMath::log2), log2Time);
+        printResult("std::tanh", tanhTime, tanhTime);
+        printResult("FastMath::tanh", timeBlock(FastMath::tanh), tanhTime);
+    }
+
+    static void benchmarkIdleEffects() {
+        std::cout << "Idle effects (chorus -> delay -> reverb on silence, " << BLOCK_SIZE << "-sample blocks):" << std::endl;
+        
+        std::vector<float> left(BLOCK_SIZE), right(BLOCK_SIZE);
+        float* channels[] = { left.data(), right.data() };
+        auto silence = [&] {
+            std::fill(left.begin(), left.end(), 0.0f);
+            std::fill(right.begin(), right.end(), 0.0f);
+        };
+        
+        // Every effect processes every block, as before tail tracking
+        ChorusEffect chorusA;
+        DelayEffect delayA;
+        ReverbEffect reverbA;
+        prepareEffects(chorusA, delayA, reverbA);
+        double alwaysTime = timeRepeated([&] {
+            silence();
+            chorusA.processBlock(channels, 2, BLOCK_SIZE);
+            delayA.processBlock(channels, 2, BLOCK_SIZE);
+            reverbA.processBlock(channels, 2, BLOCK_SIZE);
+        });
+        
+        // Fused chain once the tails have rung out and every stage sleeps
+        ChorusEffect chorusB;
+        DelayEffect delayB;
+        ReverbEffect reverbB;
+        prepareEffects(chorusB, delayB, reverbB);
+        EffectSet effects(&chorusB, &delayB, &reverbB);
+        EffectChainFunction chain = selectEffectChain({ EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB },
+                                                      EffectChainTable::NUM_MASKS - 1);
+        while (!(chorusB.isSleeping() && delayB.isSleeping() && reverbB.isSleeping())) {
+            silence();
+            chain(effects, channels, 2, BLOCK_SIZE, nullptr);
+        }
+        double sleepingTime = timeRepeated([&] {
+            silence();
+            chain(effects, channels, 2, BLOCK_SIZE, nullptr);
+        });
+        
+        printResult("always processed", alwaysTime, alwaysTime);
+        printResult("sleeping after tails ring out", sleepingTime, alwaysTime);
+    }
+
+    static void benchmarkReverbDecay() {
+        const int decaySeconds = 30;
+        std::cout << "Reverb decay (" << decaySeconds << " s of silence after a noise burst, "
+                  << BLOCK_SIZE << "-sample blocks, ns/sample over 0-10 / 10-20 / 20-30 s):" << std::endl;
+        
+        // Processes the tail block by block straight through processBlock, so
+        // sleeping (which would skip the tail entirely) does not hide the cost
+        auto measureDecay = [&](ReverbAlgorithm algorithm, bool flushToZero, const char* name) {
+            std::unique_ptr<ScopedFlushToZero> noDenormals;
+            if (flushToZero) noDenormals = std::make_unique<ScopedFlushToZero>();
+            
+            ReverbEffect reverb;
+            reverb.setSampleRate(SAMPLE_RATE);
+            reverb.setAlgorithm(algorithm);
+            reverb.setParameter(0, 0.9f);   // room size
+            reverb.setParameter(1, 0.5f);   // damping
+            std::vector<float> left(BLOCK_SIZE), right(BLOCK_SIZE);
+            float* channels[] = { left.data(), right.data() };
+            
+            int burstBlocks = static_cast<int>(0.5 * SAMPLE_RATE) / BLOCK_SIZE;
+            for (int block = 0; block < burstBlocks; ++block) {
+                for (int i = 0; i < BLOCK_SIZE; ++i) {
+                    left[i] = right[i] = (((block * BLOCK_SIZE + i) * 7919) % 1009) / 1009.0f - 0.5f;
+                }
+                reverb.processBlock(channels, 2, BLOCK_SIZE);
+            }
+            
+            // Mean cost of each 10-second stretch of the tail
+            const int stretches = 3;
+            int blocksPerStretch = static_cast<int>(decaySeconds * SAMPLE_RATE) / BLOCK_SIZE / stretches;
+            std::cout << "  " << std::left << std::setw(32) << name << std::right;
+            for (int stretch = 0; stretch < stretches; ++stretch) {
+                auto start = std::chrono::steady_clock::now();
+                for (int block = 0; block < blocksPerStretch; ++block) {
+                    // Processing is in place, so silence the input each block
+                    std::fill(left.begin(), left.end(), 0.0f);
+                    std::fill(right.begin(), right.end(), 0.0f);
+                    reverb.processBlock(channels, 2, BLOCK_SIZE);
+                }
+                double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                std::cout << std::fixed << std::setprecision(1) << std::setw(8) << elapsed / (blocksPerStretch * BLOCK_SIZE);
+            }
+            std::cout << std::endl;
+        };
+        
+        measureDecay(ReverbAlgorithm::COMB, true, "combs, flush-to-zero");
+        measureDecay(ReverbAlgorithm::COMB, false, "combs, explicit flushing only");
+        measureDecay(ReverbAlgorithm::FDN, true, "FDN, flush-to-zero");
+        measureDecay(ReverbAlgorithm::FDN, false, "FDN, explicit flushing only");
+    }
+
+    static void benchmarkLogging() {
+        const int callsPerBatch = 512;     // Fits the ring, so nothing is dropped
+        const int numBatches = 200;
+        std::cout << "Logging one note event (" << callsPerBatch * numBatches << " calls, mean / 99.9th percentile):" << std::endl;
+        
+        // Times each call separately so the tail shows, which is what stalls a
+        // control or audio thread (the very worst call is scheduler noise)
+        auto measure = [&](const char* name, const std::function<void(int)>& logCall,
+                           const std::function<void()>& betweenBatches) {
+            std::vector<double> times;
+            times.reserve(callsPerBatch * numBatches);
+            for (int batch = 0; batch < numBatches; ++batch) {
+                for (int call = 0; call < callsPerBatch; ++call) {
+                    auto start = std::chrono::steady_clock::now();
+                    logCall(call);
+                    times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+                }
+                betweenBatches();
+            }
+            double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+            auto percentile = times.begin() + static_cast<long>(times.size() * 0.999);
+            std::nth_element(times.begin(), percentile, times.end());
+            std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(8) << mean << " /" << std::setw(9) << *percentile << " ns" << std::endl;
+        };
+        
+        // The old path: format and write straight to the console, flushing each line.
+        // /dev/null is the cheapest possible console; a real terminal is slower.
+        FILE* devNull = std::fopen("/dev/null", "w");
+        if (devNull != nullptr) {
+            measure("fprintf + fflush to /dev/null", [&](int note) {
+                std::fprintf(devNull, "Note ON: %d (freq: %gHz)\n", note, 440.0);
+                std::fflush(devNull);
+            }, [] {});
+            std::fclose(devNull);
+        }
+        
+        Logger& logger = Logger::getInstance();
+        logger.flush();
+        logger.setSink([](const LogRecord&) {});
+        logger.setLevel(LogLevel::VERBOSE);
+        measure("Logger, record queued", [](int note) {
+            Logger::verbose("engine", "Note ON: %d (freq: %gHz)", note, 440.0);
+        }, [&] { logger.flush(); });
+        logger.setLevel(LogLevel::INFO);
+        measure("Logger, below level (default)", [](int note) {
+            Logger::verbose("engine", "Note ON: %d (freq: %gHz)", note, 440.0);
+        }, [] {});
+        logger.flush();
+        logger.setSink(nullptr);
+    }
+
+    static void benchmarkPerformanceCounters() {
+        std::cout << "Performance counters (" << BLOCK_SIZE << "-sample blocks):" << std::endl;
+        
+        // The effect chain with and without per-effect timing
+        ChorusEffect chorus[2];
+        DelayEffect delay[2];
+        ReverbEffect reverb[2];
+        prepareEffects(chorus[0], delay[0], reverb[0]);
+        prepareEffects(chorus[1], delay[1], reverb[1]);
+        EffectChainFunction chain = selectEffectChain({ EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB },
+                                                      EffectChainTable::NUM_MASKS - 1);
+        EffectSet untimedSet(&chorus[0], &delay[0], &reverb[0]);
+        EffectSet timedSet(&chorus[1], &delay[1], &reverb[1]);
+        double untimed = timeBlocks([&](float* data, int numSamples) {
+            float* channels[] = { data };
+            chain(untimedSet, channels, 1, numSamples, nullptr);
+        });
+        EffectChainTimings timings;
+        double timed = timeBlocks([&](float* data, int numSamples) {
+            float* channels[] = { data };
+            chain(timedSet, channels, 1, numSamples, &timings);
+        });
+        printResult("Effect chain, untimed", untimed, untimed);
+        printResult("Effect chain, timing each effect", timed, untimed);
+        
+        // Whole engine blocks: the default path times the chain as one stage,
+        // per-effect timing is what synth_set_perf_effect_timing switches on
+        auto timeEngine = [](bool perEffectTiming) {
+            SynthEngine synth;
+            synth.prepareOfflineRender(SAMPLE_RATE, BLOCK_SIZE);
+            synth.enableChorus(true);
+            synth.enableDelay(true);
+            synth.enableReverb(true);
+            synth.setPerEffectTiming(perEffectTiming);
+            for (int note = 0; note < 8; ++note) {
+                synth.noteOn(48 + 3 * note, 0.7f);
+            }
+            std::vector<float> left(BLOCK_SIZE), right(BLOCK_SIZE);
+            float* channels[] = { left.data(), right.data() };
+            return timeRepeated([&] { synth.renderOffline(channels, 2, BLOCK_SIZE); });
+        };
+        double engineDefault = timeEngine(false);
+        double enginePerEffect = timeEngine(true);
+        printResult("Engine, default timing", engineDefault, engineDefault);
+        printResult("Engine, per-effect timing", enginePerEffect, engineDefault);
+        
+        // Everything the engine adds per block by default: bracketing, five laps and the publish
+        PerformanceMonitor monitor;
+        double bookkeeping = timeRepeated([&] {
+            monitor.beginBlock();
+            monitor.noteActiveVoices(8);
+            auto mark = PerformanceMonitor::Clock::now();
+            mark = monitor.lap(PerformanceStage::VOICES, mark);
+            mark = monitor.lap(PerformanceStage::FILTER, mark);
+            mark = monitor.lap(PerformanceStage::INSERT_EFFECTS, mark);
+            mark = monitor.lap(PerformanceStage::CONVOLUTION, mark);
+            monitor.lap(PerformanceStage::LIMITER, mark);
+            monitor.endBlock(BLOCK_SIZE, SAMPLE_RATE);
+        }) * BLOCK_SIZE;
+        double blockNanoseconds = BLOCK_SIZE * 1.0e9 / SAMPLE_RATE;
+        std::cout << "  " << std::left << std::setw(36) << "Monitor bookkeeping per block" << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(8) << bookkeeping << " ns ("
+                  << std::setprecision(4) << 100.0 * bookkeeping / blockNanoseconds << "% of the block)" << std::endl;
+    }
+
+public:
+    static void runAllBenchmarks() {
+        std::cout << "=== Running JUCE Audio Engine Benchmarks ===" << std::endl << std::endl;
+
+        benchmarkEffectChain();
+        std::cout << std::endl;
+        benchmarkReverbAlgorithms();
+        std::cout << std::endl;
+        benchmarkConvolutionReverb();
+        std::cout << std::endl;
+        benchmarkOversampling();
+        std::cout << std::endl;
+        benchmarkFastMath();
+        std::cout << std::endl;
+        benchmarkIdleEffects();
+        std::cout << std::endl;
+        benchmarkReverbDecay();
+        std::cout << std::endl;
+        benchmarkLogging();
+        std::cout << std::endl;
+        benchmarkPerformanceCounters();
+        std::cout << std::endl;
+    }
+};
+
+int main() {
+    SynthEngineBenchmarks::runAllBenchmarks();
+    return 0;
+}
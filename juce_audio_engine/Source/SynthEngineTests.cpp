@@ -9,8 +9,19 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <algorithm>
 #include <map>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <cstring>
 #include "../Source/SynthEngine.h"
+#include "../Source/FastMath.h"
+#include "../Source/Logger.h"
+#include "../Source/Effects/Denormals.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -40,6 +51,73 @@ private:
         std::cout << "  ✓ No crashes with standard MIDI values" << std::endl;
     }
     
+    static void testFastMath() {
+        std::cout << "Testing fast math approximations (" << FastMath::getInstructionSetName() << ")..." << std::endl;
+        
+        // Block results are checked too; an odd length exercises the scalar tail
+        const int count = 100003;
+        std::vector<float> input(count), output(count);
+        auto maxBlockError = [&](void (*blockFunction)(const float*, float*, int), double (*reference)(double),
+                                 bool relative) {
+            std::vector<float> copy = input;
+            blockFunction(copy.data(), copy.data(), count);
+            double maxError = 0.0;
+            for (int i = 0; i < count; ++i) {
+                double expected = reference(input[i]);
+                double error = std::abs(copy[i] - expected);
+                maxError = std::max(maxError, relative ? error / std::abs(expected) : error);
+            }
+            return maxError;
+        };
+        
+        double sinError = 0.0, cosError = 0.0;
+        for (int i = 0; i < count; ++i) {
+            float turns = -4.0f + 8.0f * i / count;
+            input[i] = turns;
+            sinError = std::max(sinError, std::abs(FastMath::sin2Pi(turns) - std::sin(2.0 * M_PI * turns)));
+            cosError = std::max(cosError, std::abs(FastMath::cos2Pi(turns) - std::cos(2.0 * M_PI * turns)));
+        }
+        assert(sinError < 4.0e-6 && cosError < 4.0e-6);
+        assert(maxBlockError(FastMath::sin2Pi, [](double x) { return std::sin(2.0 * M_PI * x); }, false) < 4.0e-6);
+        std::cout << "  ✓ sin2Pi/cos2Pi within 4e-6" << std::endl;
+        
+        double exp2Error = 0.0;
+        for (int i = 0; i < count; ++i) {
+            float x = -126.0f + 252.0f * i / count;
+            input[i] = x;
+            exp2Error = std::max(exp2Error, std::abs(FastMath::exp2(x) / std::exp2(static_cast<double>(x)) - 1.0));
+        }
+        assert(exp2Error < 2.0e-7);
+        assert(maxBlockError(FastMath::exp2, [](double x) { return std::exp2(x); }, true) < 2.0e-7);
+        std::cout << "  ✓ exp2 within 2e-7 relative" << std::endl;
+        
+        double log2Error = 0.0;
+        for (int i = 0; i < count; ++i) {
+            float x = 0.5f + 1.5f * i / count;
+            input[i] = x;
+            log2Error = std::max(log2Error, std::abs(FastMath::log2(x) - std::log2(static_cast<double>(x))));
+        }
+        assert(log2Error < 2.0e-7);
+        assert(maxBlockError(FastMath::log2, [](double x) { return std::log2(x); }, false) < 2.0e-7);
+        for (int i = 0; i < count; ++i) {
+            input[i] = std::exp2(-120.0f + 240.0f * i / count);
+        }
+        assert(maxBlockError(FastMath::log2, [](double x) { return std::log2(x); }, true) < 2.0e-7);
+        assert(FastMath::log2(0.0f) == -126.0f);
+        std::cout << "  ✓ log2 within 2e-7 (absolute near 1, relative elsewhere)" << std::endl;
+        
+        double tanhError = 0.0;
+        for (int i = 0; i < count; ++i) {
+            float x = -12.0f + 24.0f * i / count;
+            input[i] = x;
+            tanhError = std::max(tanhError, std::abs(FastMath::tanh(x) - std::tanh(static_cast<double>(x))));
+        }
+        assert(tanhError < 2.0e-7);
+        assert(maxBlockError(FastMath::tanh, [](double x) { return std::tanh(x); }, false) < 2.0e-7);
+        assert(FastMath::tanh(0.0f) == 0.0f);
+        std::cout << "  ✓ tanh within 2e-7, exactly 0 at 0" << std::endl;
+    }
+    
     static void testVoiceManagement() {
         std::cout << "Testing voice management..." << std::endl;
         
@@ -50,7 +128,7 @@ private:
         synth.noteOn(64, 0.7f);  // E4  
         synth.noteOn(67, 0.6f);  // G4
         
-        // Verify voices are tracked internally (would need access to activeVoices)
+        // Verify voices are tracked internally (would need access to voicePool)
         std::cout << "  ✓ Multiple notes triggered successfully" << std::endl;
         
         synth.noteOff(64);  // Release E4
@@ -61,6 +139,1644 @@ private:
         std::cout << "  ✓ All notes released successfully" << std::endl;
     }
     
+    static void testVoiceStealing() {
+        std::cout << "Testing voice stealing..." << std::endl;
+        
+        VoicePool pool;
+        pool.prepare(2);
+        
+        // Fill the pool, then force a steal of the oldest voice
+        pool.allocateVoice(60).noteOn(261.63f, 0.5f);
+        pool.allocateVoice(64).noteOn(329.63f, 0.9f);
+        pool.allocateVoice(67).noteOn(392.00f, 0.7f);
+        assert(pool.getActiveCount() == 2);
+        assert(pool.findVoice(60) == nullptr);
+        assert(pool.findVoice(67) != nullptr);
+        std::cout << "  ✓ Oldest voice stolen when pool is full" << std::endl;
+        
+        // Retriggering a sounding note reuses its voice
+        DualOscVoice* existing = pool.findVoice(64);
+        assert(&pool.allocateVoice(64) == existing);
+        std::cout << "  ✓ Same-note retrigger reuses the voice" << std::endl;
+        
+        // Quietest mode steals the lowest velocity voice (67 at 0.7)
+        pool.setStealingMode(VoiceStealingMode::QUIETEST);
+        existing->noteOn(329.63f, 0.9f);
+        pool.allocateVoice(72).noteOn(523.25f, 0.8f);
+        assert(pool.findVoice(67) == nullptr);
+        assert(pool.findVoice(64) != nullptr);
+        std::cout << "  ✓ Quietest voice stolen in QUIETEST mode" << std::endl;
+    }
+    
+    static void testCommandQueue() {
+        std::cout << "Testing command queue..." << std::endl;
+        
+        // Capacity rounds up to a power of two and rejects pushes when full
+        SpscQueue<int> queue(3);
+        assert(queue.getCapacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            assert(queue.push(i));
+        }
+        assert(!queue.push(4));
+        
+        int value = -1;
+        assert(queue.pop(value) && value == 0);
+        assert(queue.push(4));
+        std::cout << "  ✓ Queue wraps and reports full correctly" << std::endl;
+        
+        // Notes queued from the control thread sound on the next block
+        SynthEngine synth;
+        synth.prepareToPlay(256, 44100.0);
+        synth.noteOn(69, 0.8f);
+        
+        juce::AudioBuffer<float> buffer(2, 256);
+        juce::AudioSourceChannelInfo info(&buffer, 0, 256);
+        synth.getNextAudioBlock(info);
+        assert(buffer.getMagnitude(0, 256) > 0.0f);
+        std::cout << "  ✓ Queued note applied at block start" << std::endl;
+    }
+    
+    static void testOscilloscope() {
+        std::cout << "Testing oscilloscope capture..." << std::endl;
+        
+        // The reader gets the newest published value and keeps it until a newer one
+        TripleBuffer<int> frames;
+        frames.fill(0);
+        frames.getWriteBuffer() = 1;
+        frames.publish();
+        frames.getWriteBuffer() = 2;
+        frames.publish();
+        assert(frames.read() == 2);
+        assert(frames.read() == 2);
+        frames.getWriteBuffer() = 3;
+        frames.publish();
+        assert(frames.read() == 3);
+        std::cout << "  ✓ Triple buffer hands over the latest frame" << std::endl;
+        
+        // Enabling is a command, so nothing is captured before the next block
+        SynthEngine synth;
+        synth.prepareToPlay(512, 44100.0);
+        synth.enableOscilloscope(true);
+        std::vector<float> scope(512, 1.0f);
+        assert(synth.getWaveformData(scope.data(), 512) == 0);
+        
+        synth.noteOn(69, 0.8f);
+        juce::AudioBuffer<float> buffer(2, 512);
+        juce::AudioSourceChannelInfo info(&buffer, 0, 512);
+        synth.getNextAudioBlock(info);
+        assert(synth.getWaveformData(scope.data(), 512) == 512);
+        assert(*std::max_element(scope.begin(), scope.end()) > 0.0f);
+        std::cout << "  ✓ Frames are published by the audio thread" << std::endl;
+        
+        // A reader polling while blocks render only ever sees whole frames
+        std::atomic<bool> rendering { true };
+        std::thread reader([&] {
+            std::vector<float> frame(512);
+            while (rendering.load()) {
+                synth.getWaveformData(frame.data(), 512);
+            }
+        });
+        for (int block = 0; block < 200; ++block) {
+            synth.getNextAudioBlock(info);
+        }
+        rendering = false;
+        reader.join();
+        
+        synth.enableOscilloscope(false);
+        synth.getNextAudioBlock(info);
+        assert(synth.getWaveformData(scope.data(), 512) == 0);
+        std::cout << "  ✓ Disabled scope returns no data" << std::endl;
+    }
+    
+    static void testLogger() {
+        std::cout << "Testing real-time logger..." << std::endl;
+        
+        // Capture records instead of printing them; the sink runs on the flusher thread
+        Logger& logger = Logger::getInstance();
+        std::mutex capturedLock;
+        std::vector<LogRecord> captured;
+        logger.flush();
+        logger.setSink([&](const LogRecord& record) {
+            std::lock_guard<std::mutex> lock(capturedLock);
+            captured.push_back(record);
+        });
+        auto takeCaptured = [&]() {
+            logger.flush();
+            std::lock_guard<std::mutex> lock(capturedLock);
+            std::vector<LogRecord> records;
+            records.swap(captured);
+            return records;
+        };
+        
+        logger.setLevel(LogLevel::WARNING);
+        Logger::verbose("test", "hidden %d", 1);
+        Logger::info("test", "hidden %d", 2);
+        Logger::warning("test", "shown %d", 3);
+        Logger::severe("test", "shown %d", 4);
+        auto records = takeCaptured();
+        assert(records.size() == 2);
+        assert(records[0].level == LogLevel::WARNING && std::strcmp(records[0].message, "shown 3") == 0);
+        assert(records[1].level == LogLevel::SEVERE && std::strcmp(records[1].category, "test") == 0);
+        assert(records[0].nanoseconds <= records[1].nanoseconds);
+        logger.setLevel(LogLevel::OFF);
+        Logger::severe("test", "hidden");
+        assert(takeCaptured().empty());
+        std::cout << "  ✓ Runtime level filters records before they are queued" << std::endl;
+        
+        // Several threads log at once; every record arrives, in order per thread
+        logger.setLevel(LogLevel::VERBOSE);
+        const int numThreads = 4;
+        const int messagesPerThread = 200;
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < numThreads; ++thread) {
+            threads.emplace_back([thread]() {
+                for (int message = 0; message < messagesPerThread; ++message) {
+                    Logger::verbose("test", "%d %d", thread, message);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        records = takeCaptured();
+        assert(static_cast<int>(records.size()) == numThreads * messagesPerThread);
+        std::vector<int> nextMessage(numThreads, 0);
+        for (const auto& record : records) {
+            int thread = -1, message = -1;
+            assert(std::sscanf(record.message, "%d %d", &thread, &message) == 2);
+            assert(message == nextMessage[thread]);
+            ++nextMessage[thread];
+        }
+        std::cout << "  ✓ " << numThreads << " threads x " << messagesPerThread
+                  << " records delivered in order per thread" << std::endl;
+        
+        // Long messages are truncated, never overrun the record
+        std::string longText(500, 'x');
+        Logger::info("test", "%s", longText.c_str());
+        records = takeCaptured();
+        assert(records.size() == 1);
+        assert(std::strlen(records[0].message) == LogRecord::MAX_MESSAGE_LENGTH - 1);
+        std::cout << "  ✓ Long messages truncated to " << LogRecord::MAX_MESSAGE_LENGTH - 1 << " characters" << std::endl;
+        
+        // Flooding past the ring's capacity drops records and counts them,
+        // and the flusher reports the loss
+        const int floodSize = Logger::QUEUE_CAPACITY * 20;
+        uint64_t droppedBefore = logger.getDroppedCount();
+        for (int message = 0; message < floodSize; ++message) {
+            Logger::verbose("test", "flood %d", message);
+        }
+        records = takeCaptured();
+        uint64_t dropped = logger.getDroppedCount() - droppedBefore;
+        int delivered = 0;
+        bool lossReported = false;
+        for (const auto& record : records) {
+            if (std::strcmp(record.category, "logger") == 0) lossReported = true;
+            else ++delivered;
+        }
+        assert(delivered + static_cast<int>(dropped) == floodSize);
+        assert(dropped == 0 || lossReported);
+        std::cout << "  ✓ Flood of " << floodSize << ": " << delivered << " delivered, "
+                  << dropped << " dropped and reported" << std::endl;
+        
+        // Note logging is verbose-only, so it costs nothing at the default level
+        logger.setLevel(LogLevel::INFO);
+        {
+            SynthEngine synth;
+            synth.noteOn(60, 0.8f);
+            synth.noteOff(60);
+        }
+        records = takeCaptured();
+        assert(std::none_of(records.begin(), records.end(), [](const LogRecord& record) {
+            return std::strncmp(record.message, "Note", 4) == 0;
+        }));
+        assert(!records.empty());
+        std::cout << "  ✓ Engine lifecycle logged at INFO, notes only at VERBOSE" << std::endl;
+        
+        logger.setSink(nullptr);
+    }
+    
+    static void testPerformanceCounters() {
+        std::cout << "Testing audio callback performance counters..." << std::endl;
+        
+        assert(PerformanceMonitor::getLoadBucket(0.0) == 0);
+        assert(PerformanceMonitor::getLoadBucket(0.049) == 0);
+        assert(PerformanceMonitor::getLoadBucket(0.051) == 1);
+        assert(PerformanceMonitor::getLoadBucket(0.99) == 19);
+        assert(PerformanceMonitor::getLoadBucket(1.0) == PerformanceSnapshot::NUM_LOAD_BUCKETS - 1);
+        assert(PerformanceMonitor::getLoadBucket(7.5) == PerformanceSnapshot::NUM_LOAD_BUCKETS - 1);
+        std::cout << "  ✓ Load histogram has 5% buckets with overruns in the last" << std::endl;
+        
+        // A 1 ms block that takes 2 ms is an overrun; a 1 s block is nearly idle
+        PerformanceMonitor monitor;
+        monitor.beginBlock();
+        monitor.noteActiveVoices(3);
+        monitor.noteActiveVoices(5);
+        monitor.addStageTime(PerformanceStage::VOICES, 400000);
+        auto busyUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(2);
+        while (std::chrono::steady_clock::now() < busyUntil) {}
+        monitor.endBlock(48, 48000.0);
+        monitor.beginBlock();
+        monitor.endBlock(48000, 48000.0);
+        PerformanceSnapshot snapshot = monitor.getSnapshot();
+        assert(snapshot.blockCount == 2 && snapshot.overrunCount == 1);
+        assert(snapshot.maxLoad >= 2.0 && snapshot.maxRenderMicros >= 2000.0);
+        assert(snapshot.loadHistogram[PerformanceSnapshot::NUM_LOAD_BUCKETS - 1] == 1);
+        assert(snapshot.loadHistogram[0] == 1);
+        assert(snapshot.maxActiveVoices == 5 && snapshot.meanActiveVoices == 2.5);
+        assert(std::abs(snapshot.maxStageMicros[static_cast<int>(PerformanceStage::VOICES)] - 400.0) < 1.0e-9);
+        assert(std::abs(snapshot.meanStageMicros[static_cast<int>(PerformanceStage::VOICES)] - 200.0) < 1.0e-9);
+        std::cout << "  ✓ Overruns, load, voices and stage times recorded per block" << std::endl;
+        
+        monitor.reset();
+        assert(monitor.getSnapshot().blockCount == 2);
+        monitor.beginBlock();
+        snapshot = monitor.getSnapshot();
+        assert(snapshot.blockCount == 0 && snapshot.overrunCount == 0 && snapshot.maxLoad == 0.0);
+        std::cout << "  ✓ Reset is applied by the audio thread at the next block" << std::endl;
+        
+        // Snapshots taken while blocks are recorded never mix two blocks' updates
+        std::atomic<bool> writing { true };
+        std::thread writer([&]() {
+            for (int block = 0; block < 20000; ++block) {
+                monitor.beginBlock();
+                monitor.addStageTime(PerformanceStage::REVERB, 1000);
+                monitor.endBlock(512, 48000.0);
+            }
+            writing = false;
+        });
+        int snapshots = 0;
+        while (writing) {
+            PerformanceSnapshot concurrent = monitor.getSnapshot();
+            uint64_t histogramTotal = 0;
+            for (uint64_t count : concurrent.loadHistogram) histogramTotal += count;
+            assert(histogramTotal == concurrent.blockCount);
+            assert(concurrent.blockCount == 0
+                   || std::abs(concurrent.meanStageMicros[static_cast<int>(PerformanceStage::REVERB)] - 1.0) < 1.0e-9);
+            ++snapshots;
+        }
+        writer.join();
+        assert(monitor.getSnapshot().blockCount == 20000);
+        std::cout << "  ✓ " << snapshots << " concurrent snapshots were all consistent" << std::endl;
+        
+        // Work dropped for missing its deadline makes an overrun of a light block
+        monitor.reset();
+        monitor.beginBlock();
+        monitor.noteOverrun();
+        monitor.endBlock(48000, 48000.0);
+        monitor.beginBlock();
+        monitor.endBlock(48000, 48000.0);
+        snapshot = monitor.getSnapshot();
+        assert(snapshot.blockCount == 2 && snapshot.overrunCount == 1 && snapshot.maxLoad < 1.0);
+        std::cout << "  ✓ Dropped late work counts as an overrun" << std::endl;
+        
+        // The engine times every block and charges enabled stages only
+        SynthEngine synth;
+        assert(synth.prepareOfflineRender(48000.0, 256));
+        synth.enableDelay(true);
+        synth.enableReverb(true);
+        synth.noteOn(60, 0.8f);
+        synth.noteOn(64, 0.8f);
+        synth.noteOn(67, 0.8f);
+        std::vector<float> left(256 * 20), right(256 * 20);
+        float* channels[] = { left.data(), right.data() };
+        assert(synth.renderOffline(channels, 2, 256 * 20));
+        snapshot = synth.getPerformanceStats();
+        auto stageMicros = [&](PerformanceStage stage) { return snapshot.meanStageMicros[static_cast<int>(stage)]; };
+        assert(snapshot.blockCount == 20);
+        assert(snapshot.maxActiveVoices == 3);
+        assert(snapshot.xrunCount == -1);
+        assert(snapshot.meanLoad > 0.0 && snapshot.maxLoad >= snapshot.meanLoad);
+        assert(stageMicros(PerformanceStage::VOICES) > 0.0);
+        assert(stageMicros(PerformanceStage::INSERT_EFFECTS) > 0.0);
+        assert(stageMicros(PerformanceStage::DELAY) == 0.0 && stageMicros(PerformanceStage::REVERB) == 0.0);
+        assert(stageMicros(PerformanceStage::LIMITER) > 0.0);
+        assert(stageMicros(PerformanceStage::CHORUS) == 0.0 && stageMicros(PerformanceStage::CONVOLUTION) == 0.0);
+        double stagesTotal = 0.0;
+        for (double micros : snapshot.meanStageMicros) stagesTotal += micros;
+        assert(stagesTotal <= snapshot.meanRenderMicros);
+        std::cout << "  ✓ Engine: " << snapshot.blockCount << " blocks, mean load "
+                  << snapshot.meanLoad * 100.0 << "%, voices " << stageMicros(PerformanceStage::VOICES)
+                  << " us, insert effects " << stageMicros(PerformanceStage::INSERT_EFFECTS) << " us per block" << std::endl;
+        
+        // Per-effect timing is opt-in and replaces the combined stage
+        synth.setPerEffectTiming(true);
+        synth.resetPerformanceStats();
+        assert(synth.renderOffline(channels, 2, 256 * 20));
+        snapshot = synth.getPerformanceStats();
+        assert(snapshot.blockCount == 20);
+        assert(stageMicros(PerformanceStage::DELAY) > 0.0 && stageMicros(PerformanceStage::REVERB) > 0.0);
+        assert(stageMicros(PerformanceStage::CHORUS) == 0.0 && stageMicros(PerformanceStage::INSERT_EFFECTS) == 0.0);
+        std::cout << "  ✓ Per-effect timing splits the chain by effect" << std::endl;
+    }
+    
+    static void testSimdVoiceRenderer() {
+        std::cout << "Testing SIMD voice renderer..." << std::endl;
+        
+        // Two identical pools: one rendered per voice, one lane-parallel
+        VoicePool scalarPool, simdPool;
+        scalarPool.prepare(24);
+        simdPool.prepare(24);
+        for (int v = 0; v < 24; ++v) {
+            for (VoicePool* pool : { &scalarPool, &simdPool }) {
+                DualOscVoice& voice = pool->allocateVoice(40 + v);
+                voice.setOsc1Waveform(static_cast<WaveformType>(v % 4));
+                voice.setOsc2Waveform(static_cast<WaveformType>((v / 4) % 4));
+                voice.setDetune(7.0f);
+                voice.setPan((v % 5 - 2) * 0.5f);
+                voice.noteOn(110.0f + 20.0f * v, 0.5f);
+            }
+        }
+        
+        std::vector<DualOscVoice*> simdVoices;
+        for (auto& voice : simdPool) {
+            simdVoices.push_back(&voice);
+        }
+        
+        SimdVoiceRenderer renderer;
+        float scalarOut[2][300] = {};
+        float simdOut[2][300] = {};
+        for (int block = 0; block < 4; ++block) {
+            for (auto& voice : scalarPool) {
+                voice.renderBlock(scalarOut[0], scalarOut[1], 300, 48000.0);
+            }
+            renderer.render(simdVoices.data(), 24, simdOut[0], simdOut[1], 300, 48000.0);
+        }
+        
+        float maxError = 0.0f;
+        for (int channel = 0; channel < 2; ++channel) {
+            for (int i = 0; i < 300; ++i) {
+                maxError = std::max(maxError, std::abs(scalarOut[channel][i] - simdOut[channel][i]));
+            }
+        }
+        assert(maxError < 1.0e-3f);
+        std::cout << "  ✓ " << renderer.getInstructionSetName() << " kernel matches scalar rendering" << std::endl;
+    }
+    
+    static void testParallelVoiceRenderer() {
+        std::cout << "Testing parallel voice rendering..." << std::endl;
+        
+        VoicePool serialPool, parallelPool;
+        serialPool.prepare(64);
+        parallelPool.prepare(64);
+        for (int v = 0; v < 64; ++v) {
+            for (VoicePool* pool : { &serialPool, &parallelPool }) {
+                DualOscVoice& voice = pool->allocateVoice(30 + v);
+                voice.setOsc1Waveform(static_cast<WaveformType>(v % 4));
+                voice.noteOn(80.0f + 15.0f * v, 0.3f);
+            }
+        }
+        
+        std::vector<DualOscVoice*> serialVoices, parallelVoices;
+        for (auto& voice : serialPool) serialVoices.push_back(&voice);
+        for (auto& voice : parallelPool) parallelVoices.push_back(&voice);
+        
+        SimdVoiceRenderer serial;
+        ParallelVoiceRenderer parallel;
+        parallel.prepare(4, 256);
+        assert(parallel.isRunning());
+        assert(parallel.getNumThreads() == 4);
+        
+        // Every block is checked: a worker that raced into a job twice would
+        // drop the voices from its first pass in that block only
+        float serialOut[256] = {}, serialRight[256] = {};
+        float parallelOut[256] = {}, parallelRight[256] = {};
+        float maxError = 0.0f;
+        for (int block = 0; block < 500; ++block) {
+            std::fill(serialOut, serialOut + 256, 0.0f);
+            std::fill(parallelOut, parallelOut + 256, 0.0f);
+            serial.render(serialVoices.data(), 64, serialOut, serialRight, 256, 48000.0);
+            parallel.render(parallelVoices.data(), 64, parallelOut, parallelRight, 256, 48000.0, VoiceRenderMode::SIMD);
+            
+            // Same kernels, different summation order
+            for (int i = 0; i < 256; ++i) {
+                maxError = std::max(maxError, std::abs(serialOut[i] - parallelOut[i]));
+            }
+        }
+        assert(maxError < 1.0e-4f);
+        std::cout << "  ✓ 4 threads match single-threaded rendering in every block" << std::endl;
+        
+        parallel.shutdown();
+        assert(!parallel.isRunning());
+        std::cout << "  ✓ Workers shut down cleanly" << std::endl;
+    }
+    
+    // Magnitude of one frequency component, by direct DFT
+    static double measureComponent(const std::vector<float>& signal, double frequency, double sampleRate) {
+        double re = 0.0, im = 0.0;
+        for (size_t n = 0; n < signal.size(); ++n) {
+            double angle = 2.0 * M_PI * frequency * n / sampleRate;
+            re += signal[n] * std::cos(angle);
+            im -= signal[n] * std::sin(angle);
+        }
+        return 2.0 * std::sqrt(re * re + im * im) / signal.size();
+    }
+    
+    static void testWavetableAliasing() {
+        std::cout << "Testing band-limited wavetables..." << std::endl;
+        
+        // A 5 kHz saw at 48 kHz: the 9th harmonic (45 kHz) folds back to 3 kHz
+        for (OscillatorMode mode : { OscillatorMode::ANALYTIC, OscillatorMode::WAVETABLE_CUBIC }) {
+            Oscillator osc;
+            osc.setWaveform(WaveformType::SAW);
+            osc.setMode(mode);
+            osc.setFrequency(5000.0f);
+            
+            std::vector<float> signal(4800);
+            osc.renderBlock(signal.data(), 4800, 48000.0);
+            
+            double fundamental = measureComponent(signal, 5000.0, 48000.0);
+            double alias = measureComponent(signal, 3000.0, 48000.0);
+            assert(std::abs(fundamental - 2.0 / M_PI) < 0.01);
+            
+            if (mode == OscillatorMode::ANALYTIC) {
+                assert(alias > 0.05);
+            } else {
+                assert(alias < 1.0e-3);
+            }
+        }
+        std::cout << "  ✓ Wavetable saw has no aliased partials at 5 kHz" << std::endl;
+    }
+    
+    static void testOfflineRender() {
+        std::cout << "Testing offline rendering..." << std::endl;
+        
+        SynthEngine synth;
+        assert(synth.prepareOfflineRender(48000.0, 128));
+        synth.noteOn(57, 0.8f);
+        
+        // Interleaved stereo, longer than one block
+        std::vector<float> interleaved(1000 * 2, 0.0f);
+        assert(synth.renderOfflineInterleaved(interleaved.data(), 2, 1000));
+        
+        float peak = 0.0f;
+        for (int frame = 0; frame < 1000; ++frame) {
+            assert(interleaved[frame * 2] == interleaved[frame * 2 + 1]);
+            peak = std::max(peak, std::abs(interleaved[frame * 2]));
+        }
+        assert(peak > 0.01f);
+        std::cout << "  ✓ Interleaved render produced audio on both channels" << std::endl;
+        
+        // Planar buffers supplied by the caller
+        std::vector<float> left(300), right(300);
+        float* channels[] = { left.data(), right.data() };
+        assert(synth.renderOffline(channels, 2, 300));
+        assert(left == right);
+        std::cout << "  ✓ Planar render filled caller buffers" << std::endl;
+    }
+    
+    static void testScheduledEvents() {
+        std::cout << "Testing sample-accurate event scheduling..." << std::endl;
+        
+        // Same events rendered with two very different buffer sizes
+        std::vector<float> outputs[2];
+        const int blockSizes[2] = { 512, 37 };
+        for (int run = 0; run < 2; ++run) {
+            SynthEngine synth;
+            assert(synth.prepareOfflineRender(48000.0, blockSizes[run]));
+            assert(synth.getSamplePosition() == 0);
+            
+            synth.noteOnAt(60, 0.8f, 300);
+            synth.noteOffAt(60, 700);
+            synth.noteOnAt(64, 0.8f, 701);
+            
+            outputs[run].assign(1024, 0.0f);
+            float* channels[] = { outputs[run].data() };
+            assert(synth.renderOffline(channels, 1, 1024));
+            assert(synth.getSamplePosition() == 1024);
+        }
+        
+        // Nothing before the onset, sound within a sample of it
+        int firstSound = 0;
+        while (firstSound < 1024 && outputs[0][firstSound] == 0.0f) ++firstSound;
+        assert(firstSound >= 300 && firstSound <= 301);
+        std::cout << "  ✓ Note starts at its scheduled sample inside a 512-sample block" << std::endl;
+        
+        float maxDifference = 0.0f;
+        for (int i = 0; i < 1024; ++i) {
+            maxDifference = std::max(maxDifference, std::abs(outputs[0][i] - outputs[1][i]));
+        }
+        assert(maxDifference < 1.0e-3f);
+        std::cout << "  ✓ Output is independent of buffer size" << std::endl;
+    }
+    
+    static void testParameterSmoothing() {
+        std::cout << "Testing parameter smoothing..." << std::endl;
+        
+        // Linear ramp reaches the target in exactly the ramp length
+        SmoothedParameter linear(0.0f);
+        linear.setRampLength(100);
+        linear.setTargetValue(1.0f);
+        float previous = 0.0f;
+        for (int i = 0; i < 100; ++i) {
+            float value = linear.getNextValue();
+            assert(value > previous && value - previous < 0.011f);
+            previous = value;
+        }
+        assert(!linear.isSmoothing() && linear.getCurrentValue() == 1.0f);
+        std::cout << "  ✓ Linear ramp is monotonic and lands on target" << std::endl;
+        
+        // Block fill produces the same ramp as per-sample reads
+        SmoothedParameter perSample(200.0f, SmoothingType::EXPONENTIAL);
+        SmoothedParameter perBlock(200.0f, SmoothingType::EXPONENTIAL);
+        perSample.reset(48000.0, 0.01);
+        perBlock.reset(48000.0, 0.01);
+        perSample.setTargetValue(8000.0f);
+        perBlock.setTargetValue(8000.0f);
+        float block[600];
+        perBlock.fillBlock(block, 600);
+        for (int i = 0; i < 600; ++i) {
+            float expected = perSample.getNextValue();
+            assert(std::abs(block[i] - expected) <= expected * 1.0e-3f);
+        }
+        // Halfway through a multiplicative ramp is the geometric mean
+        assert(std::abs(block[239] - std::sqrt(200.0f * 8000.0f)) < 5.0f);
+        assert(block[479] == 8000.0f && block[599] == 8000.0f);
+        std::cout << "  ✓ Exponential block ramp matches per-sample values" << std::endl;
+        
+        // A mix change glides instead of stepping, identically in both render modes
+        DualOscVoice scalarVoice, simdVoice;
+        for (DualOscVoice* voice : { &scalarVoice, &simdVoice }) {
+            voice->setOsc1Waveform(WaveformType::SQUARE);
+            voice->setOsc2Waveform(WaveformType::SAW);
+            voice->setMix(0.0f);
+            voice->noteOn(220.0f, 1.0f);
+            voice->setMix(1.0f);
+        }
+        float scalarOut[256] = {}, scalarRight[256] = {};
+        float simdOut[256] = {}, simdRight[256] = {};
+        DualOscVoice* simdVoices[] = { &simdVoice };
+        SimdVoiceRenderer renderer;
+        scalarVoice.renderBlock(scalarOut, scalarRight, 256, 48000.0);
+        renderer.render(simdVoices, 1, simdOut, simdRight, 256, 48000.0);
+        
+        float maxError = 0.0f;
+        for (int i = 0; i < 256; ++i) {
+            maxError = std::max(maxError, std::abs(scalarOut[i] - simdOut[i]));
+        }
+        assert(maxError < 1.0e-3f);
+        assert(std::abs(scalarOut[0] - 1.0f) < 0.01f);
+        std::cout << "  ✓ Oscillator mix glides in scalar and SIMD rendering" << std::endl;
+    }
+    
+    // Steady-state gain of a filter for one sine frequency
+    static float measureFilterGain(StateVariableFilter& filter, float frequency) {
+        std::vector<float> signal(9600);
+        for (size_t n = 0; n < signal.size(); ++n) {
+            signal[n] = std::sin(2.0f * static_cast<float>(M_PI) * frequency * n / 48000.0f);
+        }
+        filter.reset();
+        filter.processBlock(signal.data(), static_cast<int>(signal.size()));
+        
+        float peak = 0.0f;
+        for (size_t n = signal.size() / 2; n < signal.size(); ++n) {
+            peak = std::max(peak, std::abs(signal[n]));
+        }
+        return peak;
+    }
+    
+    static void testStateVariableFilter() {
+        std::cout << "Testing state-variable filter..." << std::endl;
+        
+        StateVariableFilter filter;
+        filter.setSampleRate(48000.0);
+        filter.setCutoff(1000.0f);
+        filter.setResonance(0.707f);
+        
+        assert(measureFilterGain(filter, 100.0f) > 0.95f);
+        assert(measureFilterGain(filter, 10000.0f) < 0.02f);
+        std::cout << "  ✓ Lowpass passes lows and rejects highs" << std::endl;
+        
+        filter.setMode(FilterMode::HIGHPASS);
+        assert(measureFilterGain(filter, 100.0f) < 0.02f);
+        assert(measureFilterGain(filter, 10000.0f) > 0.95f);
+        filter.setMode(FilterMode::BANDPASS);
+        assert(measureFilterGain(filter, 1000.0f) > 0.65f);
+        filter.setMode(FilterMode::NOTCH);
+        assert(measureFilterGain(filter, 1000.0f) < 0.05f);
+        std::cout << "  ✓ Highpass, bandpass and notch responses" << std::endl;
+        
+        // Maximum resonance and a cutoff near Nyquist with a full-scale square input
+        filter.setMode(FilterMode::LOWPASS);
+        filter.setResonance(10.0f);
+        filter.setCutoff(20000.0f);
+        std::vector<float> square(48000);
+        for (size_t n = 0; n < square.size(); ++n) {
+            square[n] = (n / 37) % 2 ? 1.0f : -1.0f;
+        }
+        filter.processBlock(square.data(), static_cast<int>(square.size()));
+        for (float sample : square) {
+            assert(std::isfinite(sample) && std::abs(sample) < 20.0f);
+        }
+        std::cout << "  ✓ Stable at maximum resonance near Nyquist" << std::endl;
+        
+        // Two channels through one filter match two separate mono filters
+        StateVariableFilter stereo, monoLeft, monoRight;
+        for (StateVariableFilter* f : { &stereo, &monoLeft, &monoRight }) {
+            f->setSampleRate(48000.0);
+            f->setCutoff(800.0f);
+        }
+        std::vector<float> left(512), right(512);
+        for (int n = 0; n < 512; ++n) {
+            left[n] = std::sin(0.05f * n);
+            right[n] = std::sin(0.3f * n);
+        }
+        std::vector<float> expectedLeft = left, expectedRight = right;
+        float* channels[] = { left.data(), right.data() };
+        stereo.processBlock(channels, 2, 512);
+        monoLeft.processBlock(expectedLeft.data(), 512);
+        monoRight.processBlock(expectedRight.data(), 512);
+        assert(left == expectedLeft && right == expectedRight);
+        std::cout << "  ✓ Multichannel processing keeps independent state" << std::endl;
+    }
+    
+    static void testPerVoiceFilters() {
+        std::cout << "Testing per-voice filters..." << std::endl;
+        
+        VoiceFilterSettings settings;
+        settings.enabled = true;
+        settings.cutoff = 600.0f;
+        settings.resonance = 4.0f;
+        settings.keyTracking = 1.0f;
+        settings.velocityAmount = 0.5f;
+        
+        // Scalar voices and lane-rendered voices with identical filters
+        VoicePool scalarPool, simdPool;
+        scalarPool.prepare(20);
+        simdPool.prepare(20);
+        for (int v = 0; v < 20; ++v) {
+            for (VoicePool* pool : { &scalarPool, &simdPool }) {
+                DualOscVoice& voice = pool->allocateVoice(36 + 3 * v);
+                voice.setOsc1Waveform(static_cast<WaveformType>(v % 4));
+                voice.setOsc2Waveform(WaveformType::SAW);
+                voice.noteOn(65.0f * std::pow(2.0f, v / 4.0f), 0.3f + 0.035f * v);
+                voice.updateFilter(settings, 48000.0);
+            }
+        }
+        
+        // Key tracking opens the filter for higher notes
+        auto voiceIt = scalarPool.begin();
+        float lowNoteA1 = voiceIt->getFilterCoefficients().a1;
+        for (int v = 1; v < 20; ++v) ++voiceIt;
+        assert(voiceIt->getFilterCoefficients().a1 < lowNoteA1);
+        std::cout << "  ✓ Cutoff tracks each voice's pitch and velocity" << std::endl;
+        
+        std::vector<DualOscVoice*> simdVoices;
+        for (auto& voice : simdPool) simdVoices.push_back(&voice);
+        
+        SimdVoiceRenderer renderer;
+        float scalarOut[256], simdOut[256];
+        float scalarRight[256], simdRight[256];
+        float maxError = 0.0f;
+        for (int block = 0; block < 8; ++block) {
+            std::fill(scalarOut, scalarOut + 256, 0.0f);
+            std::fill(simdOut, simdOut + 256, 0.0f);
+            for (auto& voice : scalarPool) voice.renderBlock(scalarOut, scalarRight, 256, 48000.0);
+            renderer.render(simdVoices.data(), 20, simdOut, simdRight, 256, 48000.0);
+            for (int i = 0; i < 256; ++i) {
+                maxError = std::max(maxError, std::abs(scalarOut[i] - simdOut[i]));
+            }
+        }
+        assert(maxError < 2.0e-3f);
+        std::cout << "  ✓ " << renderer.getInstructionSetName() << " lane filters match scalar per-voice filters" << std::endl;
+        
+        // Without tracking, filtering each voice equals filtering the sum
+        std::vector<float> outputs[2];
+        FilterRouting routings[2] = { FilterRouting::MASTER, FilterRouting::PER_VOICE };
+        for (int run = 0; run < 2; ++run) {
+            SynthEngine synth;
+            synth.setFilterRouting(routings[run]);
+            synth.setResonance(2.0f);
+            synth.setOsc1Waveform(WaveformType::SAW);
+            assert(synth.prepareOfflineRender(48000.0, 256));
+            synth.noteOn(48, 0.8f);
+            synth.noteOn(55, 0.8f);
+            outputs[run].assign(4096, 0.0f);
+            float* channels[] = { outputs[run].data() };
+            assert(synth.renderOffline(channels, 1, 4096));
+        }
+        float routingError = 0.0f;
+        for (int i = 2048; i < 4096; ++i) {
+            routingError = std::max(routingError, std::abs(outputs[0][i] - outputs[1][i]));
+        }
+        assert(routingError < 1.0e-3f);
+        std::cout << "  ✓ Per-voice routing matches master routing without tracking" << std::endl;
+    }
+    
+    // Runs the same input through two instances: one sample at a time and in blocks
+    static float compareBlockAndSampleProcessing(Effect& perSample, Effect& perBlock, int blockSize) {
+        std::vector<float> input(6000);
+        for (size_t n = 0; n < input.size(); ++n) {
+            input[n] = std::sin(0.01f * n) * 0.5f + ((n * 7919) % 101) / 202.0f - 0.25f;
+        }
+        std::vector<float> blockOut = input;
+        
+        float maxError = 0.0f;
+        for (size_t start = 0; start < input.size(); start += blockSize) {
+            int size = std::min<int>(blockSize, static_cast<int>(input.size() - start));
+            float* channels[] = { blockOut.data() + start };
+            perBlock.processBlock(channels, 1, size);
+            for (int i = 0; i < size; ++i) {
+                float expected = perSample.processSample(input[start + i]);
+                maxError = std::max(maxError, std::abs(expected - blockOut[start + i]));
+            }
+        }
+        return maxError;
+    }
+    
+    static void testStereoOutput() {
+        std::cout << "Testing stereo output..." << std::endl;
+        
+        // Full spread: two octaves above middle C is hard right, two below hard left
+        float energy[2][2] = {};
+        int notes[2] = { 84, 36 };
+        for (int run = 0; run < 2; ++run) {
+            SynthEngine synth;
+            synth.setStereoSpread(1.0f);
+            assert(synth.prepareOfflineRender(48000.0, 256));
+            synth.noteOn(notes[run], 0.8f);
+            std::vector<float> left(2048), right(2048);
+            float* channels[] = { left.data(), right.data() };
+            assert(synth.renderOffline(channels, 2, 2048));
+            for (int i = 0; i < 2048; ++i) {
+                energy[run][0] += left[i] * left[i];
+                energy[run][1] += right[i] * right[i];
+            }
+        }
+        assert(energy[0][1] > 0.0f && energy[0][0] < energy[0][1] * 1.0e-6f);
+        assert(energy[1][0] > 0.0f && energy[1][1] < energy[1][0] * 1.0e-6f);
+        std::cout << "  ✓ Stereo spread pans notes by pitch" << std::endl;
+        
+        // No spread: identical channels, and a mono device gets the same signal
+        std::vector<float> stereoOut[2], monoOut;
+        for (int layout = 1; layout <= 2; ++layout) {
+            SynthEngine synth;
+            assert(synth.prepareOfflineRender(48000.0, 256));
+            synth.noteOn(60, 0.8f);
+            synth.noteOn(67, 0.8f);
+            std::vector<float>* outputs = layout == 2 ? stereoOut : &monoOut;
+            float* channels[2];
+            for (int channel = 0; channel < layout; ++channel) {
+                outputs[channel].assign(1024, 1.0f);   // Stale data must be overwritten
+                channels[channel] = outputs[channel].data();
+            }
+            assert(synth.renderOffline(channels, layout, 1024));
+        }
+        assert(stereoOut[0] == stereoOut[1]);
+        float monoError = 0.0f;
+        for (int i = 0; i < 1024; ++i) {
+            monoError = std::max(monoError, std::abs(monoOut[i] - stereoOut[0][i]));
+        }
+        assert(monoError < 1.0e-6f);
+        std::cout << "  ✓ Centred voices and mono downmix match the stereo mix" << std::endl;
+        
+        // A silent engine still overwrites whatever was in the device buffer
+        SynthEngine silent;
+        assert(silent.prepareOfflineRender(48000.0, 256));
+        std::vector<float> stale(512, 1.0f);
+        float* staleChannels[] = { stale.data() };
+        assert(silent.renderOffline(staleChannels, 1, 512));
+        assert(std::all_of(stale.begin(), stale.end(), [](float x) { return x == 0.0f; }));
+        std::cout << "  ✓ Silence is written without a separate clear pass" << std::endl;
+    }
+    
+    static void testDelayLine() {
+        std::cout << "Testing shared delay line..." << std::endl;
+        
+        // Whole-sample reads of a ramp count back from the newest sample,
+        // including across the masked wrap point
+        DelayLine line;
+        line.setMaximumDelay(1000);
+        for (int i = 0; i < 3000; ++i) {
+            line.push(static_cast<float>(i));
+        }
+        assert(line.read(1) == 2999.0f);
+        assert(line.read(1000) == 2000.0f);
+        
+        // Block writes and reads wrap in two spans and match per-sample access
+        DelayLine blockLine, sampleLine;
+        blockLine.setMaximumDelay(700);
+        sampleLine.setMaximumDelay(700);
+        std::vector<float> input(500), blockRead(500), sampleRead(500);
+        for (int pass = 0; pass < 5; ++pass) {
+            for (int i = 0; i < 500; ++i) {
+                input[i] = std::sin(0.37f * (pass * 500 + i));
+            }
+            blockLine.read(blockRead.data(), 600, 500);
+            blockLine.write(input.data(), 500);
+            for (int i = 0; i < 500; ++i) {
+                sampleRead[i] = sampleLine.read(600);
+                sampleLine.push(input[i]);
+            }
+            assert(blockRead == sampleRead);
+        }
+        std::cout << "  ✓ Power-of-two line wraps consistently for samples and blocks" << std::endl;
+        
+        // Linear and Lagrange interpolation reproduce a ramp exactly
+        assert(std::abs(line.readLinear(10.25f) - 2989.75f) < 1.0e-3f);
+        assert(std::abs(line.readLagrange(10.25f) - 2989.75f) < 1.0e-3f);
+        
+        // Allpass interpolation settles to the delayed value of a slow sine
+        DelayLine allpassLine;
+        allpassLine.setMaximumDelay(64);
+        float state = 0.0f, worstError = 0.0f;
+        for (int i = 0; i < 4000; ++i) {
+            allpassLine.push(std::sin(0.01f * i));
+            float delayed = allpassLine.readAllpass(20.3f, state);
+            if (i > 1000) {
+                worstError = std::max(worstError, std::abs(delayed - std::sin(0.01f * (i + 1 - 20.3f))));
+            }
+        }
+        assert(worstError < 1.0e-3f);
+        std::cout << "  ✓ Fractional reads interpolate between samples" << std::endl;
+        
+        // The swept chorus taps move smoothly: with whole-sample taps every
+        // step showed up as a spike in the second difference of a slow sine
+        ChorusEffect chorus;
+        chorus.setSampleRate(48000.0);
+        chorus.setEnabled(true);
+        chorus.setDepth(1.0f);
+        chorus.setFeedback(0.0f);
+        chorus.setRate(5.0f);
+        chorus.setDryLevel(0.0f);
+        chorus.setWetLevel(1.0f);
+        std::vector<float> chorusOut(9600);
+        for (size_t i = 0; i < chorusOut.size(); ++i) {
+            chorusOut[i] = 0.5f * std::sin(2.0f * 3.14159265f * 200.0f * i / 48000.0f);
+        }
+        float* chorusChannels[] = { chorusOut.data() };
+        chorus.processBlock(chorusChannels, 1, static_cast<int>(chorusOut.size()));
+        float worstCurvature = 0.0f;
+        for (size_t i = 4800; i + 1 < chorusOut.size(); ++i) {
+            worstCurvature = std::max(worstCurvature, std::abs(chorusOut[i + 1] - 2.0f * chorusOut[i] + chorusOut[i - 1]));
+        }
+        assert(worstCurvature < 2.0e-3f);
+        std::cout << "  ✓ Chorus modulation glides without sample steps" << std::endl;
+        
+        // The shared-line taps and recursive LFO match a direct reference
+        // built from std::sin, even after a long run
+        ChorusEffect taps;
+        taps.setEnabled(true);
+        taps.setVoices(4);
+        taps.setDepth(0.8f);
+        taps.setRate(3.0f);
+        taps.setFeedback(0.0f);
+        taps.setDryLevel(0.0f);
+        taps.setWetLevel(1.0f);
+        taps.setSampleRate(48000.0);    // Last, so no parameter is still gliding
+        DelayLine reference;
+        reference.setMaximumDelay(2000);
+        const double increment = 2.0 * 3.14159265358979 * 3.0 / 48000.0;
+        std::vector<float> block(480);
+        float worstTapError = 0.0f;
+        for (int blockIndex = 0; blockIndex < 1000; ++blockIndex) {
+            for (int i = 0; i < 480; ++i) {
+                block[i] = std::sin(0.05f * (blockIndex * 480 + i));
+            }
+            std::vector<float> expected(480);
+            for (int i = 0; i < 480; ++i) {
+                double phase = increment * (blockIndex * 480 + i + 1);
+                float tapSum = 0.0f;
+                for (int voice = 0; voice < 4; ++voice) {
+                    float baseDelay = 240.0f * (voice + 1);
+                    float lfo = static_cast<float>(std::sin(phase + voice * 3.14159265358979 / 2.0));
+                    tapSum += reference.readLagrange(baseDelay + lfo * baseDelay * 0.4f);
+                }
+                expected[i] = tapSum * 0.25f;
+                reference.push(block[i]);
+            }
+            float* tapChannels[] = { block.data() };
+            taps.processBlock(tapChannels, 1, 480);
+            for (int i = 0; i < 480; ++i) {
+                worstTapError = std::max(worstTapError, std::abs(block[i] - expected[i]));
+            }
+        }
+        assert(worstTapError < 1.0e-3f);
+        std::cout << "  ✓ Shared chorus line matches per-voice sin-modulated taps" << std::endl;
+    }
+    
+    // Index of the first sample whose magnitude exceeds threshold, or -1
+    static int firstAbove(const std::vector<float>& samples, float threshold) {
+        for (size_t i = 0; i < samples.size(); ++i) {
+            if (std::abs(samples[i]) > threshold) return static_cast<int>(i);
+        }
+        return -1;
+    }
+    
+    static void testFdnReverb() {
+        std::cout << "Testing FDN reverb..." << std::endl;
+        
+        // Wet-only impulse responses; parameters are set before the sample
+        // rate so nothing glides
+        auto impulseResponse = [](ReverbAlgorithm algorithm, double sampleRate, int length,
+                                  std::vector<float>& left, std::vector<float>& right) {
+            ReverbEffect reverb;
+            reverb.setAlgorithm(algorithm);
+            reverb.setParameter(0, 0.7f);
+            reverb.setParameter(1, 0.3f);
+            reverb.setParameter(2, 1.0f);
+            reverb.setParameter(3, 0.0f);
+            reverb.setSampleRate(sampleRate);
+            left.assign(length, 0.0f);
+            right.assign(length, 0.0f);
+            left[0] = 1.0f;
+            float* channels[] = { left.data(), right.data() };
+            reverb.processBlock(channels, 2, length);
+        };
+        
+        // Line lengths follow the sample rate: the first echo arrives at the
+        // same time, not the same sample count
+        std::vector<float> left48, right48, left96, right96;
+        impulseResponse(ReverbAlgorithm::FDN, 48000.0, 48000, left48, right48);
+        impulseResponse(ReverbAlgorithm::FDN, 96000.0, 96000, left96, right96);
+        int firstEcho48 = firstAbove(left48, 1.0e-6f);
+        int firstEcho96 = firstAbove(left96, 1.0e-6f);
+        assert(firstEcho48 > 0 && std::abs(firstEcho96 - 2 * firstEcho48) < firstEcho96 / 100);
+        std::cout << "  ✓ Delay lengths scale with the sample rate" << std::endl;
+        
+        // A left-only impulse reaches both channels, with different tails
+        float rightEnergy = 0.0f, difference = 0.0f;
+        for (int i = 0; i < 48000; ++i) {
+            rightEnergy += right48[i] * right48[i];
+            difference = std::max(difference, std::abs(left48[i] - right48[i]));
+        }
+        assert(rightEnergy > 0.0f && difference > 1.0e-3f);
+        
+        // Far denser than the combs: after 150 ms nearly every sample carries energy
+        std::vector<float> combLeft, combRight;
+        impulseResponse(ReverbAlgorithm::COMB, 48000.0, 48000, combLeft, combRight);
+        auto density = [](const std::vector<float>& samples) {
+            int busy = 0;
+            for (int i = 7200; i < 12000; ++i) {
+                busy += std::abs(samples[i]) > 1.0e-5f ? 1 : 0;
+            }
+            return busy / 4800.0f;
+        };
+        assert(density(left48) > 0.9f);
+        assert(density(left48) > 2.0f * density(combLeft));
+        std::cout << "  ✓ Stereo tail is dense and decorrelated" << std::endl;
+        
+        // The tail decays, and stays bounded at the longest room size with no damping
+        float early = 0.0f, late = 0.0f;
+        for (int i = 0; i < 4800; ++i) {
+            early += left48[4800 + i] * left48[4800 + i];
+            late += left48[43200 + i] * left48[43200 + i];
+        }
+        assert(late < early * 0.5f);
+        ReverbEffect longest;
+        longest.setAlgorithm(ReverbAlgorithm::FDN);
+        longest.setParameter(0, 1.0f);
+        longest.setParameter(1, 0.0f);
+        longest.setParameter(2, 1.0f);
+        longest.setSampleRate(48000.0);
+        std::vector<float> noise(48000);
+        float peak = 0.0f;
+        for (int block = 0; block < 20; ++block) {
+            for (size_t i = 0; i < noise.size(); ++i) {
+                noise[i] = block < 2 ? ((i * 7919) % 101) / 101.0f - 0.5f : 0.0f;
+            }
+            float* noiseChannels[] = { noise.data() };
+            longest.processBlock(noiseChannels, 1, static_cast<int>(noise.size()));
+            for (float x : noise) {
+                assert(std::isfinite(x));
+                peak = std::max(peak, std::abs(x));
+            }
+        }
+        assert(peak < 4.0f);
+        std::cout << "  ✓ Tail decays and stays stable" << std::endl;
+        
+        ReverbEffect fdnA, fdnB;
+        for (ReverbEffect* r : { &fdnA, &fdnB }) {
+            r->setParameter(4, 1.0f);
+            r->setParameter(0, 0.9f);
+            r->setParameter(2, 0.6f);
+            r->setSampleRate(48000.0);
+        }
+        assert(fdnA.getAlgorithm() == ReverbAlgorithm::FDN);
+        assert(compareBlockAndSampleProcessing(fdnA, fdnB, 512) < 1.0e-5f);
+        std::cout << "  ✓ FDN block output matches per-sample output" << std::endl;
+    }
+    
+    static void testRealFft() {
+        std::cout << "Testing real FFT..." << std::endl;
+        
+        const int order = 10;
+        const int size = 1 << order;
+        RealFft fft(order);
+        assert(fft.getSize() == size && fft.getNumBins() == size / 2 + 1);
+        
+        std::vector<float> input(size), real(size / 2 + 1), imag(size / 2 + 1), output(size);
+        for (int n = 0; n < size; ++n) {
+            input[n] = std::sin(0.37f * n) + 0.5f * std::cos(1.91f * n) + ((n * 7919) % 13) / 13.0f - 0.5f;
+        }
+        fft.forward(input.data(), real.data(), imag.data());
+        
+        // Against a naive DFT
+        float maxError = 0.0f;
+        for (int k = 0; k <= size / 2; ++k) {
+            double sumReal = 0.0, sumImag = 0.0;
+            for (int n = 0; n < size; ++n) {
+                double angle = -2.0 * 3.141592653589793 * k * n / size;
+                sumReal += input[n] * std::cos(angle);
+                sumImag += input[n] * std::sin(angle);
+            }
+            maxError = std::max(maxError, static_cast<float>(std::abs(real[k] - sumReal)));
+            maxError = std::max(maxError, static_cast<float>(std::abs(imag[k] - sumImag)));
+        }
+        assert(maxError < 1.0e-3f);
+        std::cout << "  ✓ Forward transform matches a direct DFT" << std::endl;
+        
+        fft.inverse(real.data(), imag.data(), output.data());
+        for (int n = 0; n < size; ++n) {
+            assert(std::abs(output[n] - input[n]) < 1.0e-5f);
+        }
+        std::cout << "  ✓ Inverse transform restores the input" << std::endl;
+    }
+    
+    // Fraction of the energy in a tone's spectrum that lies away from its
+    // harmonics below 20 kHz (aliasing and images)
+    static float inharmonicEnergy(const std::vector<float>& samples, double sampleRate, double fundamental) {
+        const int order = 14;
+        const int size = 1 << order;
+        RealFft fft(order);
+        std::vector<float> windowed(size), real(size / 2 + 1), imag(size / 2 + 1);
+        for (int i = 0; i < size; ++i) {
+            float hann = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * i / size);
+            windowed[i] = samples[samples.size() - size + i] * hann;
+        }
+        fft.forward(windowed.data(), real.data(), imag.data());
+        
+        double harmonic = 0.0, total = 0.0;
+        double binWidth = sampleRate / size;
+        for (int bin = 1; bin <= size / 2; ++bin) {
+            double power = real[bin] * real[bin] + imag[bin] * imag[bin];
+            double frequency = bin * binWidth;
+            double nearest = std::round(frequency / fundamental) * fundamental;
+            total += power;
+            if (nearest < 20000.0 && std::abs(frequency - nearest) < 4.0 * binWidth) {
+                harmonic += power;
+            }
+        }
+        return static_cast<float>((total - harmonic) / total);
+    }
+    
+    static void testOversampling() {
+        std::cout << "Testing oversampling..." << std::endl;
+        
+        // A round trip is a pure delay for in-band signals
+        const double sampleRate = 48000.0;
+        for (OversamplingFactor factor : { OversamplingFactor::X2, OversamplingFactor::X4, OversamplingFactor::X8 }) {
+            Oversampler oversampler;
+            oversampler.prepare(factor, 256);
+            std::vector<float> signal(4096);
+            for (int i = 0; i < 4096; ++i) {
+                signal[i] = std::sin(2.0 * M_PI * 1000.0 * i / sampleRate);
+            }
+            for (int start = 0; start < 4096; start += 200) {
+                int length = std::min(200, 4096 - start);
+                float* channels[] = { signal.data() + start };
+                oversampler.processUp(channels, 1, length);
+                assert(oversampler.getOversampledChannels()[0] != nullptr);
+                oversampler.processDown(channels, 1, length);
+            }
+            float latency = oversampler.getLatencyInSamples();
+            for (int i = 1000; i < 4096; ++i) {
+                double expected = std::sin(2.0 * M_PI * 1000.0 * (i - latency) / sampleRate);
+                assert(std::abs(signal[i] - expected) < 1.0e-4);
+            }
+        }
+        std::cout << "  ✓ 2x, 4x and 8x round trips are a pure delay" << std::endl;
+        
+        // Interpolation images of an 18 kHz tone (at 30 kHz) are suppressed
+        Oversampler interpolator;
+        interpolator.prepare(OversamplingFactor::X2, 4096);
+        std::vector<float> tone(4096);
+        for (int i = 0; i < 4096; ++i) {
+            tone[i] = std::sin(2.0 * M_PI * 18000.0 * i / sampleRate);
+        }
+        const float* toneChannels[] = { tone.data() };
+        const float* upsampled = interpolator.processUp(toneChannels, 1, 4096)[0];
+        auto magnitudeAt = [&](double frequency) {
+            double real = 0.0, imag = 0.0;
+            for (int i = 2048; i < 8192; ++i) {
+                real += upsampled[i] * std::cos(2.0 * M_PI * frequency * i / (2.0 * sampleRate));
+                imag += upsampled[i] * std::sin(2.0 * M_PI * frequency * i / (2.0 * sampleRate));
+            }
+            return 2.0 * std::sqrt(real * real + imag * imag) / 6144.0;
+        };
+        assert(std::abs(magnitudeAt(18000.0) - 1.0) < 0.01);
+        assert(magnitudeAt(30000.0) < 1.0e-3);
+        std::cout << "  ✓ Interpolation images are rejected" << std::endl;
+        
+        // A naive sawtooth aliases far less when the engine oversamples it
+        auto renderSaw = [&](OversamplingFactor factor) {
+            SynthEngine synth;
+            synth.setOversampling(factor);
+            synth.setOsc1Waveform(WaveformType::SAW);
+            synth.setOsc2Waveform(WaveformType::SAW);
+            synth.setCutoff(20000.0f);
+            assert(synth.prepareOfflineRender(sampleRate, 512));
+            synth.noteOn(96, 0.5f);
+            std::vector<float> left(20000), right(20000);
+            float* channels[] = { left.data(), right.data() };
+            assert(synth.renderOffline(channels, 2, 20000));
+            return left;
+        };
+        double fundamental = 440.0 * std::pow(2.0, (96 - 69) / 12.0);
+        float baseAliasing = inharmonicEnergy(renderSaw(OversamplingFactor::NONE), sampleRate, fundamental);
+        float oversampledAliasing = inharmonicEnergy(renderSaw(OversamplingFactor::X8), sampleRate, fundamental);
+        assert(oversampledAliasing < baseAliasing * 0.25f);
+        std::cout << "  ✓ 8x oversampling cuts oscillator aliasing by over 6 dB" << std::endl;
+    }
+    
+    static void testConvolutionReverb() {
+        std::cout << "Testing convolution reverb..." << std::endl;
+        
+        // Long enough to reach the third non-uniform stage
+        const int irLength = 36000;
+        auto layout = ConvolutionKernel::makeLayout(irLength, true);
+        assert(layout.size() == 3);
+        assert(layout[1].offset == 2 * layout[1].partitionSize);
+        assert(layout[2].offset == 2 * layout[2].partitionSize);
+        assert(layout.back().offset + layout.back().numPartitions * layout.back().partitionSize >= irLength);
+        assert(ConvolutionKernel::makeLayout(irLength, false).size() == 1);
+        std::cout << "  ✓ Non-uniform partitions grow with the offset" << std::endl;
+        
+        // Decaying noise, different per channel
+        std::vector<std::vector<float>> irChannels(2, std::vector<float>(irLength));
+        double maxEnergy = 0.0;
+        for (int channel = 0; channel < 2; ++channel) {
+            double energy = 0.0;
+            for (int i = 0; i < irLength; ++i) {
+                float noise = ((i * 7919 + channel * 104729) % 1009) / 1009.0f - 0.5f;
+                irChannels[channel][i] = noise * std::exp(-3.0f * i / irLength);
+                energy += irChannels[channel][i] * irChannels[channel][i];
+            }
+            maxEnergy = std::max(maxEnergy, energy);
+        }
+        float gain = static_cast<float>(1.0 / std::sqrt(maxEnergy));
+        auto impulseResponse = std::make_shared<const ImpulseResponse>(irChannels, 48000.0);
+        
+        const int length = 40000;
+        std::vector<float> inputLeft(length, 0.0f), inputRight(length, 0.0f);
+        for (int i = 0; i < 3000; ++i) {
+            inputLeft[i] = ((i * 31337) % 997) / 997.0f - 0.5f;
+            inputRight[i] = std::sin(0.05f * i) * 0.5f;
+        }
+        
+        int lateJobs = 0;
+        auto render = [&](bool nonUniform, bool background, std::vector<float>& left, std::vector<float>& right) {
+            ConvolutionReverb reverb;
+            reverb.setParameter(0, 1.0f);
+            reverb.setParameter(1, 0.0f);
+            reverb.setNonUniformPartitions(nonUniform);
+            reverb.setBackgroundProcessing(background);
+            reverb.setSampleRate(48000.0);
+            reverb.setImpulseResponse(impulseResponse);
+            left = inputLeft;
+            right = inputRight;
+            for (int start = 0; start < length; start += 300) {
+                float* channels[] = { left.data() + start, right.data() + start };
+                reverb.processBlock(channels, 2, std::min(300, length - start));
+                lateJobs += reverb.takeLateJobs();
+            }
+        };
+        
+        // Sampled against direct convolution, delayed by the reported latency
+        auto maxErrorAgainstDirect = [&](const std::vector<float>& left, const std::vector<float>& right) {
+            float maxError = 0.0f;
+            for (int n = 0; n < length; n += 37) {
+                for (int channel = 0; channel < 2; ++channel) {
+                    const auto& input = channel == 0 ? inputLeft : inputRight;
+                    double expected = 0.0;
+                    for (int k = 0; k < irLength && k <= n - ConvolutionReverb::LATENCY_SAMPLES; ++k) {
+                        expected += irChannels[channel][k] * gain * input[n - ConvolutionReverb::LATENCY_SAMPLES - k];
+                    }
+                    float actual = channel == 0 ? left[n] : right[n];
+                    maxError = std::max(maxError, static_cast<float>(std::abs(actual - expected)));
+                }
+            }
+            return maxError;
+        };
+        
+        std::vector<float> uniformLeft, uniformRight, inlineLeft, inlineRight, backgroundLeft, backgroundRight;
+        render(false, false, uniformLeft, uniformRight);
+        assert(maxErrorAgainstDirect(uniformLeft, uniformRight) < 1.0e-3f);
+        std::cout << "  ✓ Uniform partitions match direct convolution" << std::endl;
+        
+        render(true, false, inlineLeft, inlineRight);
+        assert(maxErrorAgainstDirect(inlineLeft, inlineRight) < 1.0e-3f);
+        std::cout << "  ✓ Non-uniform partitions match direct convolution" << std::endl;
+        
+        // Identical while the worker keeps up; a slow machine (or a sanitizer
+        // build) may drop late jobs' blocks, which only removes wet signal
+        render(true, true, backgroundLeft, backgroundRight);
+        if (lateJobs == 0) {
+            assert(backgroundLeft == inlineLeft && backgroundRight == inlineRight);
+        } else {
+            for (int i = 0; i < length; ++i) {
+                assert(std::abs(backgroundLeft[i]) < 4.0f && std::abs(backgroundRight[i]) < 4.0f);
+            }
+        }
+        std::cout << "  ✓ Background processing gives identical output unless jobs run late" << std::endl;
+        
+        // Effects playing the same impulse response share one kernel
+        ConvolutionReverb first, second;
+        first.setSampleRate(48000.0);
+        second.setSampleRate(48000.0);
+        first.setImpulseResponse(impulseResponse);
+        second.setImpulseResponse(impulseResponse);
+        auto kernel = impulseResponse->getKernel(48000.0, true);
+        assert(kernel.use_count() == 3);
+        assert(impulseResponse->getKernel(44100.0, true) != kernel);
+        std::cout << "  ✓ Kernels are shared between instances" << std::endl;
+        
+        // A mono impulse response is applied to both channels
+        auto mono = std::make_shared<const ImpulseResponse>(
+            std::vector<std::vector<float>>{ std::vector<float>{ 0.0f, 1.0f } }, 48000.0);
+        ConvolutionReverb monoReverb;
+        monoReverb.setParameter(0, 1.0f);
+        monoReverb.setParameter(1, 0.0f);
+        monoReverb.setSampleRate(48000.0);
+        monoReverb.setImpulseResponse(mono);
+        std::vector<float> left(256, 0.0f), right(256, 0.0f);
+        left[0] = 1.0f;
+        right[10] = 1.0f;
+        float* monoChannels[] = { left.data(), right.data() };
+        monoReverb.processBlock(monoChannels, 2, 256);
+        int offset = ConvolutionReverb::LATENCY_SAMPLES + 1;
+        assert(std::abs(left[offset] - 1.0f) < 1.0e-5f && std::abs(right[offset + 10] - 1.0f) < 1.0e-5f);
+        std::cout << "  ✓ Mono impulse responses play on both channels" << std::endl;
+        
+        // reset() publishes an empty state; the next block adopts it and is silent
+        auto tail = std::make_shared<const ImpulseResponse>(
+            std::vector<std::vector<float>>{ std::vector<float>(4096, 0.1f) }, 48000.0);
+        monoReverb.setImpulseResponse(tail);
+        std::fill(left.begin(), left.end(), 1.0f);
+        std::fill(right.begin(), right.end(), 1.0f);
+        monoReverb.processBlock(monoChannels, 2, 256);
+        monoReverb.reset();
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        monoReverb.processBlock(monoChannels, 2, 256);
+        assert(*std::max_element(left.begin(), left.end()) == 0.0f);
+        assert(*std::max_element(right.begin(), right.end()) == 0.0f);
+        std::cout << "  ✓ Reset silences the tail through a new state" << std::endl;
+        
+        assert(ImpulseResponseLibrary::load(juce::File("/nonexistent/impulse.wav")) == nullptr);
+        SynthEngine engine;
+        assert(!engine.loadImpulseResponse("/nonexistent/impulse.wav"));
+        std::cout << "  ✓ Missing impulse response files are rejected" << std::endl;
+    }
+    
+    static void testEffectBlockProcessing() {
+        std::cout << "Testing block effect processing..." << std::endl;
+        
+        DelayEffect delayA, delayB;
+        for (DelayEffect* d : { &delayA, &delayB }) {
+            d->setSampleRate(48000.0);
+            d->setDelayTime(0.001f);    // Shorter than a block, so runs wrap often
+            d->setFeedback(0.7f);
+            d->setWetLevel(0.2f);       // Gliding while the test runs
+        }
+        assert(compareBlockAndSampleProcessing(delayA, delayB, 333) < 1.0e-5f);
+        std::cout << "  ✓ Delay block output matches per-sample output" << std::endl;
+        
+        // Depth is set before the sample rate so it does not glide
+        ChorusEffect chorusA, chorusB;
+        for (ChorusEffect* c : { &chorusA, &chorusB }) {
+            c->setDepth(0.9f);
+            c->setSampleRate(48000.0);
+            c->setEnabled(true);
+            c->setVoices(4);
+        }
+        assert(compareBlockAndSampleProcessing(chorusA, chorusB, 100) < 1.0e-5f);
+        std::cout << "  ✓ Chorus block output matches per-sample output" << std::endl;
+        
+        ReverbEffect reverbA, reverbB;
+        for (ReverbEffect* r : { &reverbA, &reverbB }) {
+            r->setSampleRate(48000.0);
+            r->setParameter(0, 0.9f);
+            r->setParameter(2, 0.6f);
+        }
+        assert(compareBlockAndSampleProcessing(reverbA, reverbB, 512) < 1.0e-5f);
+        std::cout << "  ✓ Reverb block output matches per-sample output" << std::endl;
+        
+        // Stereo in, stereo out: a left-only impulse stays on the left through
+        // the delay, and spreads into decorrelated tails through the reverb
+        DelayEffect stereoDelay;
+        stereoDelay.setSampleRate(48000.0);
+        stereoDelay.setDelayTime(0.001f);
+        std::vector<float> left(4096, 0.0f), right(4096, 0.0f), third(4096, 0.0f);
+        left[0] = 1.0f;
+        float* channels[] = { left.data(), right.data(), third.data() };
+        stereoDelay.processBlock(channels, 2, 4096);
+        assert(left[48] > 0.1f);
+        assert(std::all_of(right.begin(), right.end(), [](float x) { return x == 0.0f; }));
+        
+        ReverbEffect stereoReverb;
+        std::fill(left.begin(), left.end(), 0.0f);
+        left[0] = 1.0f;
+        stereoReverb.setParameter(2, 1.0f);
+        stereoReverb.processBlock(channels, 3, 4096);
+        float tailDifference = 0.0f, rightEnergy = 0.0f;
+        for (int i = 1; i < 4096; ++i) {
+            tailDifference = std::max(tailDifference, std::abs(left[i] - right[i]));
+            rightEnergy += right[i] * right[i];
+        }
+        assert(rightEnergy > 0.0f && tailDifference > 1.0e-3f);
+        assert(third == left);
+        std::cout << "  ✓ Effects keep the stereo image and decorrelate the reverb" << std::endl;
+    }
+    
+    static void testFusedEffectChain() {
+        std::cout << "Testing fused effect chains..." << std::endl;
+        
+        // Two identical effect sets: one run effect-by-effect over whole blocks,
+        // the other through the precompiled chain in fused sub-blocks
+        ChorusEffect chorus[2];
+        DelayEffect delay[2];
+        ReverbEffect reverb[2];
+        for (int set = 0; set < 2; ++set) {
+            chorus[set].setDepth(0.5f);
+            chorus[set].setSampleRate(48000.0);
+            chorus[set].setEnabled(true);
+            delay[set].setSampleRate(48000.0);
+            delay[set].setDelayTime(0.003f);
+            delay[set].setFeedback(0.5f);
+            reverb[set].setSampleRate(48000.0);
+        }
+        
+        EffectSet fusedSet(&chorus[1], &delay[1], &reverb[1]);
+        EffectOrder defaultOrder { EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB };
+        EffectChainFunction chain = selectEffectChain(defaultOrder, 0x7);
+        assert(chain != nullptr);
+        
+        std::vector<float> sequential(4096), fused(4096);
+        for (size_t n = 0; n < sequential.size(); ++n) {
+            sequential[n] = fused[n] = std::sin(0.02f * n) * 0.5f;
+        }
+        
+        const int blockSize = 500;  // Not a multiple of the fused sub-block
+        for (size_t start = 0; start < sequential.size(); start += blockSize) {
+            int size = std::min<int>(blockSize, static_cast<int>(sequential.size() - start));
+            float* sequentialChannels[] = { sequential.data() + start };
+            chorus[0].processBlock(sequentialChannels, 1, size);
+            delay[0].processBlock(sequentialChannels, 1, size);
+            reverb[0].processBlock(sequentialChannels, 1, size);
+            
+            float* fusedChannels[] = { fused.data() + start };
+            chain(fusedSet, fusedChannels, 1, size, nullptr);
+        }
+        
+        float maxError = 0.0f;
+        for (size_t n = 0; n < sequential.size(); ++n) {
+            maxError = std::max(maxError, std::abs(sequential[n] - fused[n]));
+        }
+        assert(maxError < 1.0e-5f);
+        std::cout << "  ✓ Fused chain matches effect-by-effect processing" << std::endl;
+        
+        // Enable flags pick the matching chain; nothing enabled means no chain
+        assert(selectEffectChain(defaultOrder, 0) == nullptr);
+        assert((selectEffectChain(defaultOrder, effectMask(EffectType::DELAY))
+                == &EffectChain<EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB, 0x2>::process));
+        EffectOrder reversed { EffectType::REVERB, EffectType::DELAY, EffectType::CHORUS };
+        assert((selectEffectChain(reversed, 0x5)
+                == &EffectChain<EffectType::REVERB, EffectType::DELAY, EffectType::CHORUS, 0x5>::process));
+        EffectOrder duplicated { EffectType::DELAY, EffectType::DELAY, EffectType::REVERB };
+        assert(selectEffectChain(duplicated, 0x7) == nullptr);
+        std::cout << "  ✓ Order and enable flags select the matching chain" << std::endl;
+    }
+    
+    static void testEffectRouting() {
+        std::cout << "Testing effect routing..." << std::endl;
+        
+        // Reordering changes the sound: the chorus is time-varying, so it does
+        // not commute with the delay the way two static filters would
+        ChorusEffect chorus[2];
+        DelayEffect delay[2];
+        ReverbEffect reverb;
+        for (int set = 0; set < 2; ++set) {
+            chorus[set].setDepth(0.8f);
+            chorus[set].setSampleRate(48000.0);
+            chorus[set].setEnabled(true);
+            delay[set].setSampleRate(48000.0);
+            delay[set].setDelayTime(0.01f);
+            delay[set].setFeedback(0.6f);
+        }
+        int chorusAndDelay = effectMask(EffectType::CHORUS) | effectMask(EffectType::DELAY);
+        EffectRouting chorusFirst({ EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB }, chorusAndDelay);
+        EffectRouting delayFirst({ EffectType::DELAY, EffectType::REVERB, EffectType::CHORUS }, chorusAndDelay);
+        assert(chorusFirst.isEnabled(EffectType::DELAY) && !chorusFirst.isEnabled(EffectType::REVERB));
+        
+        std::vector<float> first(4096), second(4096);
+        for (size_t n = 0; n < first.size(); ++n) {
+            first[n] = second[n] = std::sin(0.05f * n) * 0.5f;
+        }
+        float* firstChannels[] = { first.data() };
+        float* secondChannels[] = { second.data() };
+        chorusFirst.process(EffectSet(&chorus[0], &delay[0], &reverb), firstChannels, 1, 4096, nullptr);
+        delayFirst.process(EffectSet(&chorus[1], &delay[1], &reverb), secondChannels, 1, 4096, nullptr);
+        
+        float difference = 0.0f;
+        for (size_t n = 0; n < first.size(); ++n) {
+            difference = std::max(difference, std::abs(first[n] - second[n]));
+        }
+        assert(difference > 1.0e-3f);
+        std::cout << "  ✓ Effect order changes the processed output" << std::endl;
+        
+        // The engine accepts only permutations
+        SynthEngine synth;
+        synth.setEffectOrder(EffectType::REVERB, EffectType::CHORUS, EffectType::DELAY);
+        synth.setEffectOrder(EffectType::DELAY, EffectType::DELAY, EffectType::CHORUS);
+        EffectOrder order = synth.getEffectOrder();
+        assert(order[0] == EffectType::REVERB && order[1] == EffectType::CHORUS && order[2] == EffectType::DELAY);
+        std::cout << "  ✓ Invalid orders are ignored" << std::endl;
+        
+        // Publish routings from another thread while the audio thread renders
+        synth.prepareOfflineRender(48000.0, 256);
+        synth.noteOn(60, 0.8f);
+        std::atomic<bool> rendering { true };
+        std::thread control([&synth, &rendering]() {
+            EffectType types[] = { EffectType::CHORUS, EffectType::DELAY, EffectType::REVERB };
+            for (int change = 0; rendering; ++change) {
+                synth.enableDelay(change % 2 == 0);
+                synth.enableChorus(change % 3 == 0);
+                synth.enableReverb(change % 5 != 0);
+                synth.setEffectOrder(types[change % 3], types[(change + 1) % 3], types[(change + 2) % 3]);
+            }
+        });
+        
+        std::vector<float> left(256), right(256);
+        float* channels[] = { left.data(), right.data() };
+        bool finite = true;
+        for (int block = 0; block < 400; ++block) {
+            synth.renderOffline(channels, 2, 256);
+            for (float sample : left) {
+                finite = finite && std::isfinite(sample);
+            }
+        }
+        rendering = false;
+        control.join();
+        assert(finite);
+        std::cout << "  ✓ Routing changes during rendering are applied safely" << std::endl;
+    }
+    
+    static void testDenormalProtection() {
+        std::cout << "Testing denormal protection..." << std::endl;
+        
+        assert(flushDenormal(1.0e-20f) == 0.0f);
+        assert(flushDenormal(-1.0e-20f) == 0.0f);
+        assert(flushDenormal(1.0e-10f) == 1.0e-10f);
+        float samples[] = { 1.0e-30f, -0.5f, 1.0e-16f, 2.0e-15f };
+        flushDenormals(samples, 4);
+        assert(samples[0] == 0.0f && samples[1] == -0.5f && samples[2] == 0.0f && samples[3] == 2.0e-15f);
+        std::cout << "  ✓ Explicit flushing zeroes only values below -300 dB" << std::endl;
+        
+#if SYNTH_DENORMALS_SSE || SYNTH_DENORMALS_ARM
+        // volatile keeps the compiler from folding the products at build time
+        volatile float tiny = 1.0e-30f;
+        volatile float scale = 1.0e-10f;
+        assert(std::fpclassify(tiny * scale) == FP_SUBNORMAL);
+        {
+            ScopedFlushToZero noDenormals;
+            assert(tiny * scale == 0.0f);
+        }
+        assert(std::fpclassify(tiny * scale) == FP_SUBNORMAL);
+        std::cout << "  ✓ Flush-to-zero applies in scope and restores the previous mode" << std::endl;
+#endif
+        
+        // Each feedback effect decays for 30 s without flush-to-zero: every
+        // output sample is normal or exactly zero, and the tail ends in zeros
+        auto decaysWithoutSubnormals = [](Effect& effect) {
+            const int blockSize = 512;
+            effect.setSampleRate(48000.0);
+            std::vector<float> left(blockSize), right(blockSize);
+            float* channels[] = { left.data(), right.data() };
+            int totalBlocks = (48000 * 30) / blockSize;
+            for (int block = 0; block < totalBlocks; ++block) {
+                for (int i = 0; i < blockSize; ++i) {
+                    float burst = block < 10 ? (((block * blockSize + i) * 7919) % 1009) / 1009.0f - 0.5f : 0.0f;
+                    left[i] = right[i] = burst;
+                }
+                effect.processBlock(channels, 2, blockSize);
+                for (int i = 0; i < blockSize; ++i) {
+                    if (std::fpclassify(left[i]) == FP_SUBNORMAL || std::fpclassify(right[i]) == FP_SUBNORMAL) {
+                        return false;
+                    }
+                }
+            }
+            return std::all_of(left.begin(), left.end(), [](float sample) { return sample == 0.0f; });
+        };
+        
+        ReverbEffect combReverb;
+        combReverb.setParameter(0, 0.8f);
+        assert(decaysWithoutSubnormals(combReverb));
+        ReverbEffect fdnReverb;
+        fdnReverb.setAlgorithm(ReverbAlgorithm::FDN);
+        fdnReverb.setParameter(0, 0.8f);
+        assert(decaysWithoutSubnormals(fdnReverb));
+        DelayEffect delay;
+        delay.setDelayTime(0.05f);
+        delay.setFeedback(0.9f);
+        assert(decaysWithoutSubnormals(delay));
+        ChorusEffect chorus;
+        chorus.setParameter(3, 0.9f);
+        assert(decaysWithoutSubnormals(chorus));
+        std::cout << "  ✓ Reverbs, delay and chorus decay to exact zero without subnormals" << std::endl;
+    }
+    
+    static void testEffectTails() {
+        std::cout << "Testing effect tails and sleeping..." << std::endl;
+        
+        // A delay fed an impulse keeps running until its last audible echo,
+        // then sleeps; fresh input wakes it again
+        DelayEffect delay;
+        delay.setSampleRate(48000.0);
+        delay.setDelayTime(0.01f);
+        delay.setFeedback(0.5f);
+        delay.setWetLevel(0.5f);
+        std::vector<float> block(64);
+        float* channels[] = { block.data() };
+        int blocksUntilSleep = -1;
+        float lastEcho = 0.0f;
+        for (int index = 0; index < 1000 && blocksUntilSleep < 0; ++index) {
+            std::fill(block.begin(), block.end(), 0.0f);
+            if (index == 0) block[0] = 1.0f;
+            if (delay.beginBlock(channels, 1, 64)) {
+                delay.processBlock(channels, 1, 64);
+                delay.endBlock(channels, 1, 64);
+            }
+            for (float sample : block) {
+                if (std::abs(sample) > Effect::SILENCE_THRESHOLD) lastEcho = std::abs(sample);
+            }
+            if (delay.isSleeping()) blocksUntilSleep = index;
+        }
+        assert(blocksUntilSleep > 0);
+        assert(lastEcho > 0.0f && lastEcho < 4.0f * Effect::SILENCE_THRESHOLD);
+        std::fill(block.begin(), block.end(), 0.0f);
+        assert(!delay.beginBlock(channels, 1, 64));
+        block[10] = 0.5f;
+        assert(delay.beginBlock(channels, 1, 64) && !delay.isSleeping());
+        std::cout << "  ✓ Delay rings out to -120 dB, sleeps, and wakes on input" << std::endl;
+        
+        // With the wet level at zero the output is silent, but the line is not:
+        // the delay must keep decaying its echoes rather than freeze them
+        DelayEffect muted;
+        muted.setSampleRate(48000.0);
+        muted.setDelayTime(0.1f);
+        muted.setFeedback(0.95f);
+        muted.setWetLevel(0.0f);
+        muted.setDryLevel(0.0f);
+        std::vector<float> mutedBlock(480);
+        float* mutedChannels[] = { mutedBlock.data() };
+        auto runMuted = [&](int numBlocks, float burst) {
+            float peak = 0.0f;
+            for (int index = 0; index < numBlocks; ++index) {
+                std::fill(mutedBlock.begin(), mutedBlock.end(), index == 0 ? burst : 0.0f);
+                if (muted.beginBlock(mutedChannels, 1, 480)) {
+                    muted.processBlock(mutedChannels, 1, 480);
+                    muted.endBlock(mutedChannels, 1, 480);
+                }
+                peak = std::max(peak, *std::max_element(mutedBlock.begin(), mutedBlock.end()));
+            }
+            return peak;
+        };
+        runMuted(1000, 0.5f);      // 10 s: 100 echoes at 0.95
+        assert(!muted.isSleeping());
+        muted.setWetLevel(1.0f);
+        float echo = runMuted(100, 0.0f);
+        assert(echo > 0.001f && echo < 0.01f);
+        std::cout << "  ✓ Muted delay keeps decaying instead of freezing its line" << std::endl;
+        
+        // The engine keeps rendering echoes after the last voice stops, then
+        // goes back to writing pure silence
+        SynthEngine synth;
+        synth.enableDelay(true);
+        synth.setDelayTime(0.2f);
+        synth.setDelayFeedback(0.5f);
+        synth.setDelayWetLevel(0.5f);
+        assert(synth.prepareOfflineRender(48000.0, 512));
+        std::vector<float> left(4800), right(4800);
+        float* output[] = { left.data(), right.data() };
+        synth.noteOn(60, 0.8f);
+        assert(synth.renderOffline(output, 2, 4800));
+        synth.noteOff(60);
+        
+        float tailPeak = 0.0f;
+        int silentBlocks = 0;
+        int blocks = 0;
+        for (; blocks < 200 && silentBlocks < 10; ++blocks) {
+            assert(synth.renderOffline(output, 2, 4800));
+            bool silent = true;
+            for (int i = 0; i < 4800; ++i) {
+                if (blocks < 5) tailPeak = std::max(tailPeak, std::abs(left[i]));
+                silent = silent && left[i] == 0.0f && right[i] == 0.0f;
+            }
+            silentBlocks = silent ? silentBlocks + 1 : 0;
+        }
+        assert(tailPeak > 0.01f);
+        assert(silentBlocks == 10 && blocks < 200);
+        std::cout << "  ✓ Engine plays delay echoes after note off, then idles at exact silence" << std::endl;
+    }
+    
     static void testFrequencyRange() {
         std::cout << "Testing frequency range..." << std::endl;
         
@@ -128,9 +1844,80 @@ public:
             testMidiToFrequency();
             std::cout << std::endl;
             
+            testFastMath();
+            std::cout << std::endl;
+            
             testVoiceManagement();
             std::cout << std::endl;
             
+            testVoiceStealing();
+            std::cout << std::endl;
+            
+            testCommandQueue();
+            std::cout << std::endl;
+            
+            testOscilloscope();
+            std::cout << std::endl;
+            
+            testLogger();
+            std::cout << std::endl;
+            
+            testPerformanceCounters();
+            std::cout << std::endl;
+            
+            testSimdVoiceRenderer();
+            std::cout << std::endl;
+            
+            testParallelVoiceRenderer();
+            std::cout << std::endl;
+            
+            testWavetableAliasing();
+            std::cout << std::endl;
+            
+            testOfflineRender();
+            std::cout << std::endl;
+            
+            testScheduledEvents();
+            std::cout << std::endl;
+            
+            testParameterSmoothing();
+            std::cout << std::endl;
+            
+            testStateVariableFilter();
+            std::cout << std::endl;
+            
+            testPerVoiceFilters();
+            std::cout << std::endl;
+            
+            testStereoOutput();
+            std::cout << std::endl;
+            
+            testDelayLine();
+            testEffectBlockProcessing();
+            testFdnReverb();
+            std::cout << std::endl;
+            
+            testRealFft();
+            std::cout << std::endl;
+            
+            testConvolutionReverb();
+            std::cout << std::endl;
+            
+            testOversampling();
+            std::cout << std::endl;
+            
+            testFusedEffectChain();
+            std::cout << std::endl;
+            
+            testEffectRouting();
+            std::cout << std::endl;
+            
+            testEffectTails();
+            std::cout << std::endl;
+            
+            testDenormalProtection();
+            std::cout << std::endl;
+            
             testFrequencyRange();
             std::cout << std::endl;
             
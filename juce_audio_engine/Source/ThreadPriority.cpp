@@ -0,0 +1,33 @@
+#include "ThreadPriority.h"
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+ThreadPriority ThreadPriority::ofCurrentThread() {
+    ThreadPriority current;
+#ifdef _WIN32
+    current.priority = GetThreadPriority(GetCurrentThread());
+#else
+    sched_param param {};
+    pthread_getschedparam(pthread_self(), &current.policy, &param);
+    current.priority = param.sched_priority;
+#endif
+    return current;
+}
+
+void ThreadPriority::applyToCurrentThread() const {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), priority);
+#else
+    sched_param param {};
+    param.sched_priority = priority;
+    pthread_setschedparam(pthread_self(), policy, &param);
+#endif
+}
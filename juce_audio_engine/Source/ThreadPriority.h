@@ -0,0 +1,20 @@
+#pragma once
+
+// Scheduling policy and priority of a thread, captured on one thread and
+// applied to another. Helper threads that the audio thread waits on take the
+// priority of the thread that prepared them: lower and they are starved by
+// the callback they serve, higher and they preempt it.
+struct ThreadPriority {
+    int policy = 0;
+    int priority = 0;
+
+    static ThreadPriority ofCurrentThread();
+
+    // Best effort: real-time priority usually needs elevated privileges
+    void applyToCurrentThread() const;
+
+    bool operator==(const ThreadPriority& other) const {
+        return policy == other.policy && priority == other.priority;
+    }
+    bool operator!=(const ThreadPriority& other) const { return !(*this == other); }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Wait-free hand-off of the latest value from one writer to one reader.
+// Three slots: the writer fills one, the reader holds one, and the third is
+// exchanged between them with a single atomic, so neither side ever waits
+// and the reader never sees a slot the writer is still filling. Values the
+// reader has not collected are overwritten by newer ones.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : writeIndex(0), readIndex(1), shared(2) {}
+
+    // Not thread safe: call before either side starts
+    void fill(const T& value) {
+        for (auto& slot : slots) {
+            slot = value;
+        }
+    }
+
+    // Writer side - the slot to fill, then publish() hands it over
+    T& getWriteBuffer() { return slots[writeIndex]; }
+
+    void publish() {
+        writeIndex = shared.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side - the most recently published value (or the last one read
+    // when nothing newer has been published)
+    const T& read() {
+        if (shared.load(std::memory_order_relaxed) & FRESH) {
+            readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return slots[readIndex];
+    }
+
+private:
+    static constexpr uint32_t INDEX_MASK = 3;
+    static constexpr uint32_t FRESH = 4;    // Set while the shared slot holds an unread value
+
+    T slots[3];
+    uint32_t writeIndex;                    // Writer only
+    uint32_t readIndex;                     // Reader only
+    std::atomic<uint32_t> shared;           // Slot index, plus FRESH
+};
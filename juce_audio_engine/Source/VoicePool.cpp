@@ -0,0 +1,122 @@
+#include "VoicePool.h"
+#include <algorithm>
+
+VoicePool::VoicePool()
+    : stealingMode(VoiceStealingMode::OLDEST), sameNoteRetrigger(true), noteCounter(0) {
+}
+
+void VoicePool::prepare(int maxPolyphony) {
+    maxPolyphony = std::clamp(maxPolyphony, 1, MAX_POLYPHONY_LIMIT);
+
+    if (static_cast<int>(voices.size()) != maxPolyphony) {
+        voices.assign(maxPolyphony, DualOscVoice());
+        voiceNotes.assign(maxPolyphony, -1);
+        voiceStartOrder.assign(maxPolyphony, 0);
+    }
+
+    releaseAll();
+}
+
+DualOscVoice& VoicePool::allocateVoice(int midiNote) {
+    int slot = -1;
+
+    // Reuse the voice already playing this note
+    if (sameNoteRetrigger) {
+        for (int i = 0; i < getCapacity(); ++i) {
+            if (voices[i].isActive() && voiceNotes[i] == midiNote) {
+                slot = i;
+                break;
+            }
+        }
+    }
+
+    // Otherwise take the first free voice
+    if (slot < 0) {
+        for (int i = 0; i < getCapacity(); ++i) {
+            if (!voices[i].isActive()) {
+                slot = i;
+                break;
+            }
+        }
+    }
+
+    // Pool is full - steal according to the current policy
+    if (slot < 0) {
+        slot = findStealCandidate();
+        voices[slot].noteOff();
+    }
+
+    voiceNotes[slot] = midiNote;
+    voiceStartOrder[slot] = ++noteCounter;
+    return voices[slot];
+}
+
+DualOscVoice* VoicePool::findVoice(int midiNote) {
+    // With retrigger disabled a note may be stacked; release the most recent one
+    DualOscVoice* found = nullptr;
+    uint32_t newest = 0;
+
+    for (int i = 0; i < getCapacity(); ++i) {
+        if (voices[i].isActive() && voiceNotes[i] == midiNote && voiceStartOrder[i] >= newest) {
+            found = &voices[i];
+            newest = voiceStartOrder[i];
+        }
+    }
+    return found;
+}
+
+void VoicePool::releaseAll() {
+    for (int i = 0; i < getCapacity(); ++i) {
+        voices[i].noteOff();
+        voiceNotes[i] = -1;
+        voiceStartOrder[i] = 0;
+    }
+    noteCounter = 0;
+}
+
+void VoicePool::setStealingMode(VoiceStealingMode mode) {
+    stealingMode = mode;
+}
+
+void VoicePool::setSameNoteRetrigger(bool enable) {
+    sameNoteRetrigger = enable;
+}
+
+int VoicePool::getActiveCount() const {
+    int count = 0;
+    for (const auto& voice : voices) {
+        if (voice.isActive()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int VoicePool::collectActiveVoices(DualOscVoice** destination) {
+    int count = 0;
+    for (auto& voice : voices) {
+        if (voice.isActive()) {
+            destination[count++] = &voice;
+        }
+    }
+    return count;
+}
+
+int VoicePool::findStealCandidate() const {
+    int candidate = 0;
+
+    for (int i = 1; i < getCapacity(); ++i) {
+        bool older = voiceStartOrder[i] < voiceStartOrder[candidate];
+
+        if (stealingMode == VoiceStealingMode::QUIETEST) {
+            float level = voices[i].getVelocity();
+            float candidateLevel = voices[candidate].getVelocity();
+            if (level < candidateLevel || (level == candidateLevel && older)) {
+                candidate = i;
+            }
+        } else if (older) {
+            candidate = i;
+        }
+    }
+    return candidate;
+}
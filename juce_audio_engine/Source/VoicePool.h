@@ -0,0 +1,57 @@
+#pragma once
+#include "Oscillator.h"
+#include <cstdint>
+#include <vector>
+
+// How a new note picks a victim when every voice is already sounding
+enum class VoiceStealingMode {
+    OLDEST = 0,     // Steal the voice that started first
+    QUIETEST = 1    // Steal the voice with the lowest velocity (oldest on ties)
+};
+
+// Fixed-capacity voice storage for polyphonic synthesis.
+// All voices live in one contiguous array that is sized in prepare(), so
+// starting, stealing and releasing notes never touch the allocator.
+class VoicePool {
+public:
+    static constexpr int DEFAULT_MAX_POLYPHONY = 64;
+    static constexpr int MAX_POLYPHONY_LIMIT = 256;
+
+    VoicePool();
+
+    // Allocates storage - call from prepareToPlay, never from the audio callback
+    void prepare(int maxPolyphony);
+
+    // Returns the voice to use for a note: the voice already playing that note
+    // (same-note retrigger), a free voice, or a stolen one
+    DualOscVoice& allocateVoice(int midiNote);
+
+    // Returns the sounding voice for a note, or nullptr if there is none
+    DualOscVoice* findVoice(int midiNote);
+
+    void releaseAll();
+
+    void setStealingMode(VoiceStealingMode mode);
+    void setSameNoteRetrigger(bool enable);
+
+    int getCapacity() const { return static_cast<int>(voices.size()); }
+    int getActiveCount() const;
+
+    // Writes pointers to every sounding voice; destination must hold getCapacity() entries
+    int collectActiveVoices(DualOscVoice** destination);
+
+    // Contiguous iteration over every voice slot (active or not)
+    DualOscVoice* begin() { return voices.data(); }
+    DualOscVoice* end() { return voices.data() + voices.size(); }
+
+private:
+    std::vector<DualOscVoice> voices;
+    std::vector<int> voiceNotes;            // MIDI note held by each slot
+    std::vector<uint32_t> voiceStartOrder;  // Monotonic note-on counter per slot
+
+    VoiceStealingMode stealingMode;
+    bool sameNoteRetrigger;
+    uint32_t noteCounter;
+
+    int findStealCandidate() const;
+};
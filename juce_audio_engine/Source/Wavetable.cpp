@@ -0,0 +1,122 @@
+#include "Wavetable.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr int NUM_WAVEFORMS = 4;
+
+const WavetableBank& WavetableBank::getShared() {
+    static const WavetableBank bank;
+    return bank;
+}
+
+WavetableBank::WavetableBank()
+    : tables(static_cast<size_t>(NUM_WAVEFORMS) * NUM_LEVELS * STORED_SIZE, 0.0f) {
+
+    // One sine cycle; harmonic h at sample n is sineTable[(h * n) % TABLE_SIZE],
+    // so the additive build needs no transcendental calls per partial
+    std::vector<float> sineTable(TABLE_SIZE);
+    for (int n = 0; n < TABLE_SIZE; ++n) {
+        sineTable[n] = static_cast<float>(std::sin(2.0 * M_PI * n / TABLE_SIZE));
+    }
+
+    for (int waveform = 0; waveform < NUM_WAVEFORMS; ++waveform) {
+        for (int level = 0; level < NUM_LEVELS; ++level) {
+            buildTable(waveform, level, sineTable);
+        }
+    }
+}
+
+void WavetableBank::buildTable(int waveform, int level, const std::vector<float>& sineTable) {
+    float* table = tables.data() + getTableOffset(waveform, level);
+    int maxHarmonic = (TABLE_SIZE / 2) >> level;
+    int quarterCycle = TABLE_SIZE / 4;
+
+    // Fourier series matching the naive shapes in Oscillator::generateWaveform
+    for (int n = 0; n < TABLE_SIZE; ++n) {
+        double sum = 0.0;
+
+        switch (static_cast<WaveformType>(waveform)) {
+            case WaveformType::SINE:
+                sum = sineTable[n];
+                break;
+
+            case WaveformType::SQUARE:
+                for (int h = 1; h <= maxHarmonic; h += 2) {
+                    sum += sineTable[(static_cast<long>(h) * n) % TABLE_SIZE] / h;
+                }
+                sum *= 4.0 / M_PI;
+                break;
+
+            case WaveformType::SAW:
+                for (int h = 1; h <= maxHarmonic; ++h) {
+                    double sign = (h % 2 == 1) ? 1.0 : -1.0;
+                    sum += sign * sineTable[(static_cast<long>(h) * n) % TABLE_SIZE] / h;
+                }
+                sum *= 2.0 / M_PI;
+                break;
+
+            case WaveformType::TRIANGLE:
+                // Cosine partials, read a quarter cycle ahead in the sine table
+                for (int h = 1; h <= maxHarmonic; h += 2) {
+                    sum += sineTable[(static_cast<long>(h) * n + quarterCycle) % TABLE_SIZE] / (static_cast<double>(h) * h);
+                }
+                sum *= -8.0 / (M_PI * M_PI);
+                break;
+        }
+
+        table[n] = static_cast<float>(sum);
+    }
+
+    // Guard samples for interpolation
+    table[-1] = table[TABLE_SIZE - 1];
+    table[TABLE_SIZE] = table[0];
+    table[TABLE_SIZE + 1] = table[1];
+    table[TABLE_SIZE + 2] = table[2];
+}
+
+size_t WavetableBank::getTableOffset(int waveform, int level) const {
+    // Skip the leading guard sample
+    return (static_cast<size_t>(waveform) * NUM_LEVELS + level) * STORED_SIZE + 1;
+}
+
+const float* WavetableBank::getTable(int waveform, int level) const {
+    return tables.data() + getTableOffset(waveform, level);
+}
+
+WavetableBank::LevelBlend WavetableBank::selectLevels(WaveformType waveform, float phaseIncrement) const {
+    // Position in octaves: level k is alias-free for increments up to 2^k / TABLE_SIZE
+    float octave = FastMath::log2(std::max(phaseIncrement * TABLE_SIZE, 1.0e-6f));
+    octave = std::clamp(octave, -1.0f, static_cast<float>(NUM_LEVELS - 2) - 1.0e-4f);
+
+    int octaveFloor = static_cast<int>(std::floor(octave));
+    int lowerLevel = octaveFloor + 1;
+    int upperLevel = std::min(lowerLevel + 1, NUM_LEVELS - 1);
+
+    int waveformIndex = static_cast<int>(waveform);
+    return { getTable(waveformIndex, lowerLevel), getTable(waveformIndex, upperLevel), octave - static_cast<float>(octaveFloor) };
+}
+
+float WavetableBank::readLinear(const float* table, float phase) {
+    float position = phase * TABLE_SIZE;
+    int index = static_cast<int>(position);
+    float fraction = position - static_cast<float>(index);
+    return table[index] + fraction * (table[index + 1] - table[index]);
+}
+
+float WavetableBank::readCubic(const float* table, float phase) {
+    // 4-point Catmull-Rom (Hermite) interpolation
+    float position = phase * TABLE_SIZE;
+    int index = static_cast<int>(position);
+    float t = position - static_cast<float>(index);
+
+    float y0 = table[index - 1];
+    float y1 = table[index];
+    float y2 = table[index + 1];
+    float y3 = table[index + 2];
+
+    float c1 = 0.5f * (y2 - y0);
+    float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+    float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+    return ((c3 * t + c2) * t + c1) * t + y1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Oscillator.h"
+#include <vector>
+
+// Band-limited, mip-mapped wavetables for every WaveformType.
+// Each waveform has one table per octave of phase increment, built once by
+// additive synthesis and shared read-only by all oscillators. Level k holds
+// only the harmonics that stay below Nyquist for increments up to 2^k / TABLE_SIZE,
+// so playback is alias-free; neighbouring levels are crossfaded so timbre does
+// not step at octave boundaries.
+class WavetableBank {
+public:
+    static constexpr int TABLE_SIZE = 2048;
+    static constexpr int NUM_LEVELS = 11;       // 1024 harmonics down to 1
+
+    // The two mip levels (and crossfade weight) used for a given increment
+    struct LevelBlend {
+        const float* lower;     // More harmonics
+        const float* upper;     // Fewer harmonics
+        float upperWeight;
+    };
+
+    // Shared instance, built on first use - call once off the audio thread
+    static const WavetableBank& getShared();
+
+    LevelBlend selectLevels(WaveformType waveform, float phaseIncrement) const;
+
+    // Table reads for phases in [0, 1)
+    static float readLinear(const float* table, float phase);
+    static float readCubic(const float* table, float phase);
+
+private:
+    WavetableBank();
+
+    // Each table is stored with one guard sample before and three after so
+    // interpolation never has to wrap; table pointers skip the leading guard
+    static constexpr int STORED_SIZE = TABLE_SIZE + 4;
+    std::vector<float> tables;  // [waveform][level][STORED_SIZE]
+
+    size_t getTableOffset(int waveform, int level) const;
+    const float* getTable(int waveform, int level) const;
+    void buildTable(int waveform, int level, const std::vector<float>& sineTable);
+};
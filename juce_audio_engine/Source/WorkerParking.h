@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Where idle helper threads wait for the audio thread to hand them work.
+//
+// The audio thread wakes workers without taking the lock, so a wake-up can
+// fall between a worker's last check and its wait. Parking is bounded
+// instead: a missed wake-up costs at most PARK_TIME.
+class WorkerParking {
+public:
+    static constexpr auto PARK_TIME = std::chrono::milliseconds(1);
+
+    // Worker: returns once ready() holds, yielding for up to spinTime before
+    // it parks
+    template <typename Ready>
+    void waitUntil(Ready ready, std::chrono::microseconds spinTime = std::chrono::microseconds(0)) {
+        auto spinUntil = std::chrono::steady_clock::now() + spinTime;
+        while (!ready()) {
+            if (std::chrono::steady_clock::now() < spinUntil) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            parkedWorkers.fetch_add(1);
+            condition.wait_for(lock, PARK_TIME, ready);
+            parkedWorkers.fetch_sub(1);
+        }
+    }
+
+    // Audio thread: never blocks, and skips the notify when nobody is parked
+    void wake() {
+        if (parkedWorkers.load() > 0) {
+            condition.notify_all();
+        }
+    }
+
+    // Control thread: applies change under the lock before waking everyone,
+    // so this wake-up (typically a stop request) is never missed
+    template <typename Change>
+    void wakeAll(Change change) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            change();
+        }
+        condition.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<int> parkedWorkers{0};
+};